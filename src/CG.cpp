@@ -61,6 +61,9 @@
 #include "ComputeMG.hpp"
 #include "ComputeSPMV.hpp"
 #include "ComputeWAXPBY.hpp"
+#if defined(HPCG_WITH_FUSED_SPMV_DOT)
+#include "ComputeSPMVDot.hpp"
+#endif  // HPCG_WITH_FUSED_SPMV_DOT
 #include "hpcg.hpp"
 #include "mytimer.hpp"
 
@@ -191,12 +194,23 @@ int CG(const SparseMatrix& A, CGData& data, const Vector& b, Vector& x,
       TOCK(t2);  // p = beta*p + z
     }
 
+#if defined(HPCG_WITH_FUSED_SPMV_DOT)
+    // The fused kernel is charged to SPMV, only the global reduction of the
+    // partial sums is charged to the dot-product
+    double tdot = 0.0;
+    TICK();
+    ComputeSPMVDot(A, p, Ap, pAp, tdot, t4);
+    TOCK(t3);  // Ap = A*p and alpha = p'*Ap
+    t3 -= tdot;
+    t1 += tdot;
+#else
     TICK();
     ComputeSPMV(A, p, Ap);
     TOCK(t3);  // Ap = A*p
     TICK();
     ComputeDotProduct(nrow, p, Ap, pAp, t4, A.isDotProductOptimized);
     TOCK(t1);  // alpha = p'*Ap
+#endif  // HPCG_WITH_FUSED_SPMV_DOT
     alpha = rtz / pAp;
     TICK();
     ComputeWAXPBY(nrow, 1.0, x, alpha, p, x,
@@ -68,6 +68,7 @@ using std::endl;
 #include <cassert>
 
 #include "CheckProblem.hpp"
+#include "Stencil.hpp"
 
 /*!
   Check the contents of the generated sparse matrix to see if values match
@@ -110,6 +111,9 @@ void CheckProblem(SparseMatrix& A, Vector* b, Vector* x, Vector* xexact) {
   if (xexact != 0)
     xexactv = xexact->values;  // Only compute exact solution if requested
 
+  StencilValues stencil;
+  InitializeStencilValues(A.geom->stencil, stencil);
+
   local_int_t localNumberOfNonzeros = 0;
   // TODO:  This triply nested loop could be flattened or use nested parallelism
 #ifndef HPCG_NO_OPENMP
@@ -127,9 +131,13 @@ void CheckProblem(SparseMatrix& A, Vector* b, Vector* x, Vector* xexact) {
 #ifdef HPCG_DETAILED_DEBUG
         HPCG_fout << " rank, globalRow, localRow = " << A.geom->rank << " "
                   << currentGlobalRow << " "
-                  << A.globalToLocalMap.find(currentGlobalRow)->second << endl;
+                  << A.globalToLocalMap[currentGlobalRow] << endl;
 #endif
+        StencilValues point;
+        const StencilValues& rowValues =
+            ComputeStencilValues(*A.geom, stencil, gix, giy, giz, point);
         char numberOfNonzerosInRow = 0;
+        double rowSum              = 0.0;  // Row of A times the exact solution
         double* currentValuePointer =
             A.matrixValues[currentLocalRow];  // Pointer to current value in
                                               // current row
@@ -141,19 +149,20 @@ void CheckProblem(SparseMatrix& A, Vector* b, Vector* x, Vector* xexact) {
             for (int sy = -1; sy <= 1; sy++) {
               if (giy + sy > -1 && giy + sy < gny) {
                 for (int sx = -1; sx <= 1; sx++) {
-                  if (gix + sx > -1 && gix + sx < gnx) {
+                  double value =
+                      rowValues.value[StencilIndex(sx, sy, sz)];
+                  if (gix + sx > -1 && gix + sx < gnx && value != 0.0) {
                     global_int_t curcol =
                         currentGlobalRow + sz * gnx * gny + sy * gnx + sx;
                     if (curcol == currentGlobalRow) {
                       assert(A.matrixDiagonal[currentLocalRow] ==
                              currentValuePointer);
-                      assert(*currentValuePointer++ == 26.0);
-                    } else {
-                      assert(*currentValuePointer++ == -1.0);
                     }
+                    assert(*currentValuePointer++ == value);
                     assert(*currentIndexPointerG++ == curcol);
+                    rowSum += value;
                     numberOfNonzerosInRow++;
-                  }  // end x bounds test
+                  }  // end x bounds and stencil test
                 }    // end sx loop
               }      // end y bounds test
             }        // end sy loop
@@ -165,9 +174,7 @@ void CheckProblem(SparseMatrix& A, Vector* b, Vector* x, Vector* xexact) {
 #endif
         localNumberOfNonzeros +=
             numberOfNonzerosInRow;  // Protect this with an atomic
-        if (b != 0)
-          assert(bv[currentLocalRow] ==
-                 26.0 - ((double)(numberOfNonzerosInRow - 1)));
+        if (b != 0) assert(bv[currentLocalRow] == rowSum);
         if (x != 0) assert(xv[currentLocalRow] == 0.0);
         if (xexact != 0) assert(xexactv[currentLocalRow] == 1.0);
       }  // end ix loop
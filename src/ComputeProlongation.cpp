@@ -50,6 +50,7 @@
 #if defined(HPCG_WITH_MORPHEUS)
 #include "morpheus/Morpheus.hpp"
 #include "morpheus/Morpheus_MGData.hpp"
+#include "morpheus/Morpheus_ExchangeHalo.hpp"
 
 #if defined(HPCG_WITH_KOKKOS_CUDA) || defined(HPCG_WITH_KOKKOS_HIP)
 template <unsigned int BLOCKSIZE, typename ValueType, typename IndexType>
@@ -93,6 +94,31 @@ void Prolongation_Impl(const IndexType nc,
   }
 }
 #endif  // HPCG_WITH_KOKKOS_CUDA || HPCG_WITH_KOKKOS_HIP
+
+// xf += P xc with the Morpheus transfer, the product being kept in Axf, which
+// is free once the residual has been restricted
+void Prolongation_FullWeighting(const SparseMatrix& Af, Vector& xf) {
+  using Vector_t = HPCG_Morpheus_Vec<Morpheus::value_type>;
+  using MGData_t = HPCG_Morpheus_MGData;
+  using uvec     = typename Morpheus::UnmanagedVector<Morpheus::value_type>;
+
+  MGData_t* MGopt  = (MGData_t*)Af.mgData->optimizationData;
+  Vector_t* xcopt  = (Vector_t*)Af.mgData->xc->optimizationData;
+  Vector_t* Axfopt = (Vector_t*)Af.mgData->Axf->optimizationData;
+  Vector_t* xfopt  = (Vector_t*)xf.optimizationData;
+
+  const local_int_t nf = Af.localNumberOfRows;
+
+#ifndef HPCG_NO_MPI
+  MorpheusExchangeHalo(*Af.Ac, *Af.mgData->xc);
+#endif
+  auto ywrap = uvec(nf, Axfopt->values.dev.data());
+  Morpheus::multiply<Morpheus::ExecSpace>(MGopt->interpolation.dev,
+                                          xcopt->values.dev, ywrap);
+  Morpheus::waxpby<Morpheus::ExecSpace>(nf, 1.0, xfopt->values.dev, 1.0,
+                                        Axfopt->values.dev, xfopt->values.dev);
+  Kokkos::fence();
+}
 #else
 #include "ComputeProlongation_ref.hpp"
 #endif  // HPCG_WITH_MORPHEUS
@@ -121,6 +147,11 @@ int ComputeProlongation(const SparseMatrix& Af, Vector& xf) {
   Vector_t* rcopt = (Vector_t*)Af.mgData->rc->optimizationData;
   Vector_t* xfopt = (Vector_t*)xf.optimizationData;
 
+  if (Af.mgData->coarseOperator == HPCG_GALERKIN_FULL_WEIGHTING) {
+    Prolongation_FullWeighting(Af, xf);
+    return 0;
+  }
+
   Prolongation_Impl((local_int_t)rcopt->values.dev.size(), xcopt->values.dev,
                     MGopt->f2c.dev, xfopt->values.dev);
 #else
@@ -57,6 +57,7 @@
 #endif
 
 #include "ComputeProlongation_ref.hpp"
+#include "ExchangeHalo.hpp"
 
 /*!
   Routine to compute the coarse residual vector.
@@ -68,7 +69,8 @@
 
   Note that the fine grid residual is never explicitly constructed.
   We only compute it for the fine grid points that will be injected into
-  corresponding coarse grid points.
+  corresponding coarse grid points. With full weighting, the correction is
+  interpolated by P from the coarse points and their halo.
 
   @return Returns zero on success and a non-zero value otherwise.
 */
@@ -78,6 +80,24 @@ int ComputeProlongation_ref(const SparseMatrix& Af, Vector& xf) {
   local_int_t* f2c = Af.mgData->f2cOperator;
   local_int_t nc   = Af.mgData->rc->localLength;
 
+  if (Af.mgData->coarseOperator == HPCG_GALERKIN_FULL_WEIGHTING) {
+    const Transfer& P = Af.mgData->interpolation;
+
+#ifndef HPCG_NO_MPI
+    ExchangeHalo(*Af.Ac, *Af.mgData->xc);
+#endif
+#ifndef HPCG_NO_OPENMP
+#pragma omp parallel for
+#endif
+    for (local_int_t i = 0; i < P.numberOfRows; ++i) {
+      double sum = 0.0;
+      for (local_int_t k = P.rowStart[i]; k < P.rowStart[i + 1]; ++k)
+        sum += P.values[k] * xcv[P.columns[k]];
+      xfv[i] += sum;
+    }
+    return 0;
+  }
+
 #ifndef HPCG_NO_OPENMP
 #pragma omp parallel for
 #endif
@@ -51,6 +51,7 @@
 #if defined(HPCG_WITH_MORPHEUS)
 #include "morpheus/Morpheus.hpp"
 #include "morpheus/Morpheus_MGData.hpp"
+#include "ExchangeHalo.hpp"
 
 #if defined(HPCG_WITH_KOKKOS_CUDA) || defined(HPCG_WITH_KOKKOS_HIP)
 template <unsigned int BLOCKSIZE, typename ValueType, typename IndexType>
@@ -98,6 +99,45 @@ void Restriction_Impl(const Morpheus::Vector<ValueType>& Axf,
   }
 }
 #endif  // HPCG_ENABLE_KOKKOS_CUDA || HPCG_ENABLE_KOKKOS_HIP
+
+// rc = P^T (rf - Axf) with the Morpheus transfer, the fine residual being
+// built in place of Axf. The partial sums of the coarse halo are added to
+// those of their owners on host.
+void Restriction_FullWeighting(const SparseMatrix& A, const Vector& rf) {
+  using Vector_t = HPCG_Morpheus_Vec<Morpheus::value_type>;
+  using MGData_t = HPCG_Morpheus_MGData;
+  using uvec     = typename Morpheus::UnmanagedVector<Morpheus::value_type>;
+
+  MGData_t* MGopt  = (MGData_t*)A.mgData->optimizationData;
+  Vector_t* Axfopt = (Vector_t*)A.mgData->Axf->optimizationData;
+  Vector_t* roopt  = (Vector_t*)A.mgData->rcOverlap->optimizationData;
+  Vector_t* rfopt  = (Vector_t*)rf.optimizationData;
+
+  const local_int_t nf = A.localNumberOfRows;
+  const local_int_t nc = A.mgData->rc->localLength;
+
+  Morpheus::waxpby<Morpheus::ExecSpace>(nf, 1.0, rfopt->values.dev, -1.0,
+                                        Axfopt->values.dev,
+                                        Axfopt->values.dev);
+  auto rwrap = uvec(nf, Axfopt->values.dev.data());
+  Morpheus::multiply<Morpheus::ExecSpace>(MGopt->restriction.dev, rwrap,
+                                          roopt->values.dev);
+  Kokkos::fence();
+
+#ifdef HPCG_WITH_KOKKOS_CUDA
+  Morpheus::copy(roopt->values.dev, roopt->values.host);
+#endif  // HPCG_WITH_KOKKOS_CUDA
+#ifndef HPCG_NO_MPI
+  AccumulateHalo(*A.Ac, *A.mgData->rcOverlap);
+#endif
+  const double* rov = A.mgData->rcOverlap->values;
+  double* rcv       = A.mgData->rc->values;
+  for (local_int_t i = 0; i < nc; ++i) rcv[i] = rov[i];
+#ifdef HPCG_WITH_KOKKOS_CUDA
+  Vector_t* rcopt = (Vector_t*)A.mgData->rc->optimizationData;
+  Morpheus::copy(rcopt->values.host, rcopt->values.dev);
+#endif  // HPCG_WITH_KOKKOS_CUDA
+}
 #else
 #include "ComputeRestriction_ref.hpp"
 #endif  // HPCG_WITH_MORPHEUS
@@ -126,6 +166,11 @@ int ComputeRestriction(const SparseMatrix& A, const Vector& rf) {
   Vector_t* rcopt  = (Vector_t*)A.mgData->rc->optimizationData;
   Vector_t* rfopt  = (Vector_t*)rf.optimizationData;
 
+  if (A.mgData->coarseOperator == HPCG_GALERKIN_FULL_WEIGHTING) {
+    Restriction_FullWeighting(A, rf);
+    return 0;
+  }
+
   Restriction_Impl(Axfopt->values.dev, rfopt->values.dev, MGopt->f2c.dev,
                    rcopt->values.dev);
 #else
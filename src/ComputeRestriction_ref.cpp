@@ -57,6 +57,7 @@
 #endif
 
 #include "ComputeRestriction_ref.hpp"
+#include "ExchangeHalo.hpp"
 
 /*!
   Routine to compute the coarse residual vector.
@@ -68,7 +69,9 @@
 
   Note that the fine grid residual is never explicitly constructed.
   We only compute it for the fine grid points that will be injected into
-  corresponding coarse grid points.
+  corresponding coarse grid points. With full weighting, it is built in
+  place of Axf and restricted by P^T, the entries of the coarse halo being
+  added to those of the processes that own them.
 
   @return Returns zero on success and a non-zero value otherwise.
 */
@@ -79,6 +82,31 @@ int ComputeRestriction_ref(const SparseMatrix& A, const Vector& rf) {
   local_int_t* f2c = A.mgData->f2cOperator;
   local_int_t nc   = A.mgData->rc->localLength;
 
+  if (A.mgData->coarseOperator == HPCG_GALERKIN_FULL_WEIGHTING) {
+    const Transfer& R = A.mgData->restriction;
+    double* rov       = A.mgData->rcOverlap->values;
+    local_int_t nf    = A.localNumberOfRows;
+
+#ifndef HPCG_NO_OPENMP
+#pragma omp parallel for
+#endif
+    for (local_int_t i = 0; i < nf; ++i) Axfv[i] = rfv[i] - Axfv[i];
+#ifndef HPCG_NO_OPENMP
+#pragma omp parallel for
+#endif
+    for (local_int_t i = 0; i < R.numberOfRows; ++i) {
+      double sum = 0.0;
+      for (local_int_t k = R.rowStart[i]; k < R.rowStart[i + 1]; ++k)
+        sum += R.values[k] * Axfv[R.columns[k]];
+      rov[i] = sum;
+    }
+#ifndef HPCG_NO_MPI
+    AccumulateHalo(*A.Ac, *A.mgData->rcOverlap);
+#endif
+    for (local_int_t i = 0; i < nc; ++i) rcv[i] = rov[i];
+    return 0;
+  }
+
 #ifndef HPCG_NO_OPENMP
 #pragma omp parallel for
 #endif
@@ -0,0 +1,110 @@
+/**
+ * ComputeSPMM.cpp
+ *
+ * EPCC, The University of Edinburgh
+ *
+ * (c) 2022 The University of Edinburgh
+ *
+ * Contributing Authors:
+ * Christodoulos Stylianou (c.stylianou@ed.ac.uk)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*!
+ @file ComputeSPMM.cpp
+
+ HPCG routine
+ */
+
+#include "ComputeSPMM.hpp"
+
+#ifdef HPCG_WITH_MORPHEUS
+#include "morpheus/Morpheus_SparseMatrix.hpp"
+#include "morpheus/Morpheus_SparseMatrixRoutines.hpp"
+#include "morpheus/Morpheus_GhostMatrix.hpp"
+#include "morpheus/Morpheus_LocalMatrix.hpp"
+#include "morpheus/Morpheus_Vector.hpp"
+#include "morpheus/Morpheus_ExchangeHalo.hpp"
+#include "morpheus/Morpheus_Timer.hpp"
+#else
+#include "ComputeSPMM_ref.hpp"
+#endif  // HPCG_WITH_MORPHEUS
+
+/*!
+  Routine to compute the sparse matrix multi-vector product Y = AX, solving
+  for all the vectors of X with a single pass over the matrix.
+  Precondition: First call exchange_externals to get off-processor values of X
+
+  @param[in]  A the known system matrix
+  @param[in]  X the known multi-vector
+  @param[out] Y On exit contains the result: AX.
+
+  @return returns 0 upon success and non-zero otherwise
+
+  @see ComputeSPMM_ref
+*/
+int ComputeSPMM(const SparseMatrix& A, MultiVector& X, MultiVector& Y) {
+#ifdef HPCG_WITH_MORPHEUS
+  double t_begin = morpheus_timer(), t0 = 0.0, tspmm = 0.0;
+#ifndef HPCG_NO_MPI
+  double thalo = 0.0;
+  MTICK();
+  MorpheusExchangeHalo(A, X);
+  MTOCK(thalo);
+#endif  // HPCG_NO_MPI
+
+  using Vector_t          = HPCG_Morpheus_Vec<Morpheus::value_type>;
+  HPCG_Morpheus_Mat* Aopt = (HPCG_Morpheus_Mat*)A.optimizationData;
+
+  const int k = X.numberOfVectors;
+  auto Xv     = ((Vector_t*)X.optimizationData)->values.dev;
+  auto Yv     = ((Vector_t*)Y.optimizationData)->values.dev;
+
+  double tlocal = 0.0;
+  MTICK();
+  MorpheusLocalMultiplyMulti(Aopt, Xv.data(), k, Yv.data());
+  MTOCK(tlocal);
+#if defined(HPCG_WITH_SPLIT_DISTRIBUTED)
+  double tghost = 0.0;
+  MTICK();
+  // Ghost rows of X start after the local rows of all vectors
+  MorpheusGhostMultiplyMulti(Aopt, Xv.data() + A.localNumberOfRows * k, k,
+                             Yv.data());
+  MTOCK(tghost);
+#endif  // HPCG_WITH_SPLIT_DISTRIBUTED
+
+  tspmm = morpheus_timer() - t_begin;
+
+#if defined(HPCG_WITH_MULTI_FORMATS)
+  // Charged as k SpMVs, one per vector of X
+  if (A.optimizationData != 0) {
+    const int level = MorpheusSparseMatrixGetCoarseLevel(A);
+    sub_mtimers[level].SPMV += tspmm;
+    sub_mtimers[level].SPMV_LOCAL += tlocal;
+    sub_mtimers[level].SPMV_CALLS += k;
+#if defined(HPCG_WITH_SPLIT_DISTRIBUTED)
+    sub_mtimers[level].SPMV_GHOST += tghost;
+#endif
+#ifndef HPCG_NO_MPI
+    sub_mtimers[level].HALO_SWAP += thalo;
+#endif  // HPCG_NO_MPI
+  }
+#endif  // HPCG_WITH_MULTI_FORMATS
+
+  return 0;
+#else
+  A.isSpmvOptimized = false;
+  return ComputeSPMM_ref(A, X, Y);
+#endif  // HPCG_WITH_MORPHEUS
+}
@@ -0,0 +1,84 @@
+/**
+ * ComputeSPMM_ref.cpp
+ *
+ * EPCC, The University of Edinburgh
+ *
+ * (c) 2022 The University of Edinburgh
+ *
+ * Contributing Authors:
+ * Christodoulos Stylianou (c.stylianou@ed.ac.uk)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*!
+ @file ComputeSPMM_ref.cpp
+
+ HPCG routine
+ */
+
+#include "ComputeSPMM_ref.hpp"
+
+#ifndef HPCG_NO_MPI
+#include "ExchangeHalo.hpp"
+#endif
+
+#ifndef HPCG_NO_OPENMP
+#include <omp.h>
+#endif
+#include <cassert>
+
+/*!
+  Routine to compute the sparse matrix multi-vector product Y = AX where:
+  Precondition: First call exchange_externals to get off-processor values of X
+
+  Each row of the matrix is read once and applied to all the vectors of X.
+
+  @param[in]  A the known system matrix
+  @param[in]  X the known multi-vector
+  @param[out] Y On exit contains the result: AX.
+
+  @return returns 0 upon success and non-zero otherwise
+
+  @see ComputeSPMM
+*/
+int ComputeSPMM_ref(const SparseMatrix& A, MultiVector& X, MultiVector& Y) {
+  assert(X.localLength >= A.localNumberOfColumns);  // Test vector lengths
+  assert(Y.localLength >= A.localNumberOfRows);
+  assert(X.numberOfVectors == Y.numberOfVectors);
+
+#ifndef HPCG_NO_MPI
+  ExchangeHalo(A, X);
+#endif
+  const int k            = X.numberOfVectors;
+  const double* const Xv = X.values;
+  double* const Yv       = Y.values;
+  const local_int_t nrow = A.localNumberOfRows;
+#ifndef HPCG_NO_OPENMP
+#pragma omp parallel for
+#endif
+  for (local_int_t i = 0; i < nrow; i++) {
+    const double* const cur_vals      = A.matrixValues[i];
+    const local_int_t* const cur_inds = A.mtxIndL[i];
+    const int cur_nnz                 = A.nonzerosInRow[i];
+    double* const cur_y               = Yv + i * k;
+
+    for (int v = 0; v < k; v++) cur_y[v] = 0.0;
+    for (int j = 0; j < cur_nnz; j++) {
+      const double a         = cur_vals[j];
+      const double* const cx = Xv + cur_inds[j] * k;
+      for (int v = 0; v < k; v++) cur_y[v] += a * cx[v];
+    }
+  }
+  return 0;
+}
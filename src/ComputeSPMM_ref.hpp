@@ -0,0 +1,31 @@
+/**
+ * ComputeSPMM_ref.hpp
+ *
+ * EPCC, The University of Edinburgh
+ *
+ * (c) 2022 The University of Edinburgh
+ *
+ * Contributing Authors:
+ * Christodoulos Stylianou (c.stylianou@ed.ac.uk)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef COMPUTESPMM_REF_HPP
+#define COMPUTESPMM_REF_HPP
+#include "MultiVector.hpp"
+#include "SparseMatrix.hpp"
+
+int ComputeSPMM_ref(const SparseMatrix& A, MultiVector& X, MultiVector& Y);
+
+#endif  // COMPUTESPMM_REF_HPP
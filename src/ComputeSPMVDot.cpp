@@ -0,0 +1,158 @@
+/**
+ * ComputeSPMVDot.cpp
+ *
+ * EPCC, The University of Edinburgh
+ *
+ * (c) 2022 The University of Edinburgh
+ *
+ * Contributing Authors:
+ * Christodoulos Stylianou (c.stylianou@ed.ac.uk)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*!
+ @file ComputeSPMVDot.cpp
+
+ HPCG routine
+ */
+
+#include "ComputeSPMVDot.hpp"
+#include "mytimer.hpp"
+
+#ifndef HPCG_NO_MPI
+#include <mpi.h>
+#endif  // HPCG_NO_MPI
+
+#ifdef HPCG_WITH_MORPHEUS
+#include "morpheus/Morpheus_SparseMatrix.hpp"
+#include "morpheus/Morpheus_SparseMatrixRoutines.hpp"
+#include "morpheus/Morpheus_GhostMatrix.hpp"
+#include "morpheus/Morpheus_LocalMatrix.hpp"
+#include "morpheus/Morpheus_Vector.hpp"
+#include "morpheus/Morpheus_ExchangeHalo.hpp"
+#include "morpheus/Morpheus_Timer.hpp"
+#else
+#include "ComputeSPMV_ref.hpp"
+#include "ComputeDotProduct_ref.hpp"
+#endif  // HPCG_WITH_MORPHEUS
+
+/*!
+  Routine to compute the sparse matrix vector product y = Ax together with the
+  dot product x'y, as needed for the p'Ap step of CG.
+  Precondition: First call exchange_externals to get off-processor values of x
+
+  The Morpheus version accumulates the local part of x'y while y is written,
+  which saves reading x and y a second time. The reference version calls
+  ComputeSPMV_ref followed by ComputeDotProduct_ref.
+
+  @param[in]  A the known system matrix
+  @param[in]  x the known vector
+  @param[out] y On exit contains the result: Ax.
+  @param[out] result On exit contains the global value of x'y.
+  @param[out] time_dot the time spent on the dot product that is not
+  overlapped by the SpMV, i.e. the global reduction of the partial sums
+  @param[out] time_allreduce the time it took to perform the communication
+  between processes
+
+  @return returns 0 upon success and non-zero otherwise
+
+  @see ComputeSPMV
+  @see ComputeDotProduct
+*/
+int ComputeSPMVDot(const SparseMatrix& A, Vector& x, Vector& y, double& result,
+                   double& time_dot, double& time_allreduce) {
+#ifdef HPCG_WITH_MORPHEUS
+  double t_begin = morpheus_timer(), t0 = 0.0, tspmv = 0.0;
+#ifndef HPCG_NO_MPI
+  double thalo = 0.0;
+  MTICK();
+  MorpheusExchangeHalo(A, x);
+  MTOCK(thalo);
+#endif  // HPCG_NO_MPI
+
+  using Vector_t          = HPCG_Morpheus_Vec<Morpheus::value_type>;
+  HPCG_Morpheus_Mat* Aopt = (HPCG_Morpheus_Mat*)A.optimizationData;
+
+  auto xv = ((Vector_t*)x.optimizationData)->values.dev;
+  auto yv = ((Vector_t*)y.optimizationData)->values.dev;
+
+  double local_result = 0.0;
+#if defined(HPCG_WITH_SPLIT_DISTRIBUTED)
+  double tlocal = 0.0, tghost = 0.0;
+  MTICK();
+  local_result =
+      MorpheusLocalMultiplyDot(Aopt, xv.data(), xv.data(), yv.data());
+  Kokkos::fence();
+  MTOCK(tlocal);
+
+  // x'(y_local + y_ghost) = x'y_local + x'y_ghost, so the ghost rows only
+  // contribute their compact product to the reduction
+  MTICK();
+  local_result += MorpheusGhostMultiplyDot(
+      Aopt, xv.data() + A.localNumberOfRows, xv.data(), yv.data());
+  Kokkos::fence();
+  MTOCK(tghost);
+#else
+  double tlocal = 0.0;
+  MTICK();
+  local_result =
+      MorpheusLocalMultiplyDot(Aopt, xv.data(), xv.data(), yv.data());
+  Kokkos::fence();
+  MTOCK(tlocal);
+#endif
+
+  tspmv = morpheus_timer() - t_begin;
+
+#ifndef HPCG_NO_MPI
+  // Use MPI's reduce function to collect all partial sums
+  t0                   = mytimer();
+  double global_result = 0.0;
+  MPI_Allreduce(&local_result, &global_result, 1, MPI_DOUBLE, MPI_SUM,
+                MPI_COMM_WORLD);
+  result      = global_result;
+  double tred = mytimer() - t0;
+  time_allreduce += tred;
+  time_dot += tred;
+#else
+  result = local_result;
+#endif  // HPCG_NO_MPI
+
+#if defined(HPCG_WITH_MULTI_FORMATS)
+  if (A.optimizationData != 0) {
+    const int level = MorpheusSparseMatrixGetCoarseLevel(A);
+    sub_mtimers[level].SPMV += tspmv;
+    sub_mtimers[level].SPMV_LOCAL += tlocal;
+    sub_mtimers[level].SPMV_CALLS += 1;
+#if defined(HPCG_WITH_SPLIT_DISTRIBUTED)
+    sub_mtimers[level].SPMV_GHOST += tghost;
+#endif
+#ifndef HPCG_NO_MPI
+    sub_mtimers[level].HALO_SWAP += thalo;
+#endif  // HPCG_NO_MPI
+  }
+#endif  // HPCG_WITH_MULTI_FORMATS
+
+  return 0;
+#else
+  A.isSpmvOptimized = false;
+  int ierr          = ComputeSPMV_ref(A, x, y);
+  if (ierr) return ierr;
+
+  double t0 = mytimer();
+  ierr = ComputeDotProduct_ref(A.localNumberOfRows, x, y, result,
+                               time_allreduce);
+  time_dot += mytimer() - t0;
+  return ierr;
+#endif  // HPCG_WITH_MORPHEUS
+}
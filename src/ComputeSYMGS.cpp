@@ -55,6 +55,10 @@
 #include "ComputeSYMGS.hpp"
 #include "ComputeSYMGS_ref.hpp"
 
+#if defined(HPCG_WITH_MORPHEUS) && defined(HPCG_WITH_HYBRID_LOCAL)
+#include "morpheus/Morpheus_HybridMatrix.hpp"
+#endif
+
 /*!
   Routine to compute one step of symmetric Gauss-Seidel:
 
@@ -88,7 +92,12 @@
   @see ComputeSYMGS_ref
 */
 int ComputeSYMGS(const SparseMatrix& A, const Vector& r, Vector& x) {
+#if defined(HPCG_WITH_MORPHEUS) && defined(HPCG_WITH_HYBRID_LOCAL)
+  // Sweep over the interior (by diagonals) and boundary (CSR) rows
+  return MorpheusHybridSYMGS(A, r, x);
+#else
   // This line and the next two lines should be removed and your version of
   // ComputeSYMGS should be used.
   return ComputeSYMGS_ref(A, r, x);
+#endif
 }
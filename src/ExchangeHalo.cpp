@@ -146,5 +146,159 @@ void ExchangeHalo(const SparseMatrix &A, Vector &x) {
 
   return;
 }
+
+/*!
+  Communicates data that is at the border of the part of the domain assigned to
+  this processor for all vectors of a multi-vector. The entries of all vectors
+  are packed together so that one message is sent to each neighbor.
+
+  @param[in]    A The known system matrix
+  @param[inout] X On entry: the local multi-vector entries followed by entries
+  to be communicated; on exit: the multi-vector with non-local entries updated
+  by other processors
+ */
+void ExchangeHalo(const SparseMatrix &A, MultiVector &X) {
+  // Extract Matrix pieces
+
+  local_int_t localNumberOfRows = A.localNumberOfRows;
+  int num_neighbors             = A.numberOfSendNeighbors;
+  local_int_t *receiveLength    = A.receiveLength;
+  local_int_t *sendLength       = A.sendLength;
+  int *neighbors                = A.neighbors;
+  local_int_t totalToBeSent     = A.totalToBeSent;
+  local_int_t *elementsToSend   = A.elementsToSend;
+
+  const int k      = X.numberOfVectors;
+  double *const Xv = X.values;
+
+  // The send buffer lives with X, so it is only allocated on the first call
+  if (X.sendBufferLength < totalToBeSent * k) {
+    delete[] X.sendBuffer;
+    X.sendBufferLength = totalToBeSent * k;
+    X.sendBuffer       = new double[X.sendBufferLength];
+  }
+  double *sendBuffer = X.sendBuffer;
+
+  int MPI_MY_TAG = 99;
+
+  MPI_Request *request = new MPI_Request[num_neighbors];
+
+  //
+  // Externals are at end of locals, the entries of each row are contiguous
+  //
+  double *X_external = (double *)Xv + localNumberOfRows * k;
+
+  // Post receives first
+  for (int i = 0; i < num_neighbors; i++) {
+    local_int_t n_recv = receiveLength[i] * k;
+    MPI_Irecv(X_external, n_recv, MPI_DOUBLE, neighbors[i], MPI_MY_TAG,
+              MPI_COMM_WORLD, request + i);
+    X_external += n_recv;
+  }
+
+  //
+  // Fill up send buffer
+  //
+#ifndef HPCG_NO_OPENMP
+#pragma omp parallel for
+#endif
+  for (local_int_t i = 0; i < totalToBeSent; i++)
+    for (int v = 0; v < k; v++)
+      sendBuffer[i * k + v] = Xv[elementsToSend[i] * k + v];
+
+  //
+  // Send to each neighbor
+  //
+  double *curSendBuffer = sendBuffer;
+  for (int i = 0; i < num_neighbors; i++) {
+    local_int_t n_send = sendLength[i] * k;
+    MPI_Send(curSendBuffer, n_send, MPI_DOUBLE, neighbors[i], MPI_MY_TAG,
+             MPI_COMM_WORLD);
+    curSendBuffer += n_send;
+  }
+
+  //
+  // Complete the reads issued above
+  //
+  MPI_Status status;
+  for (int i = 0; i < num_neighbors; i++) {
+    if (MPI_Wait(request + i, &status)) {
+      std::exit(-1);  // TODO: have better error exit
+    }
+  }
+
+  delete[] request;
+
+  return;
+}
+
+/*!
+  Reverse of ExchangeHalo: sends the values held for the external entries of
+  x to the processes that own them, which add them to their own entries. Used
+  to sum the contributions of several processes to the same entries, e.g. of
+  a transposed operator.
+
+  @param[in]    A The known system matrix
+  @param[inout] x On entry: the local vector entries followed by the
+  contributions to the external ones; on exit: the local entries with the
+  contributions of the other processes added
+ */
+void AccumulateHalo(const SparseMatrix &A, Vector &x) {
+  // Extract Matrix pieces
+
+  local_int_t localNumberOfRows = A.localNumberOfRows;
+  int num_neighbors             = A.numberOfSendNeighbors;
+  local_int_t *receiveLength    = A.receiveLength;
+  local_int_t *sendLength       = A.sendLength;
+  int *neighbors                = A.neighbors;
+  double *sendBuffer            = A.sendBuffer;
+  local_int_t totalToBeSent     = A.totalToBeSent;
+  local_int_t *elementsToSend   = A.elementsToSend;
+
+  double *const xv = x.values;
+
+  int MPI_MY_TAG = 98;
+
+  MPI_Request *request = new MPI_Request[num_neighbors];
+
+  //
+  // The contributions arrive in the order ExchangeHalo sends the entries
+  //
+  double *curSendBuffer = sendBuffer;
+  for (int i = 0; i < num_neighbors; i++) {
+    local_int_t n_recv = sendLength[i];
+    MPI_Irecv(curSendBuffer, n_recv, MPI_DOUBLE, neighbors[i], MPI_MY_TAG,
+              MPI_COMM_WORLD, request + i);
+    curSendBuffer += n_recv;
+  }
+
+  //
+  // Externals are at end of locals, grouped by owner
+  //
+  double *x_external = (double *)xv + localNumberOfRows;
+  for (int i = 0; i < num_neighbors; i++) {
+    local_int_t n_send = receiveLength[i];
+    MPI_Send(x_external, n_send, MPI_DOUBLE, neighbors[i], MPI_MY_TAG,
+             MPI_COMM_WORLD);
+    x_external += n_send;
+  }
+
+  MPI_Status status;
+  for (int i = 0; i < num_neighbors; i++) {
+    if (MPI_Wait(request + i, &status)) {
+      std::exit(-1);  // TODO: have better error exit
+    }
+  }
+
+  //
+  // A row sent to several neighbors gets a contribution from each of them
+  //
+  for (local_int_t i = 0; i < totalToBeSent; i++)
+    xv[elementsToSend[i]] += sendBuffer[i];
+
+  delete[] request;
+
+  return;
+}
 #endif
 // ifndef HPCG_NO_MPI
@@ -50,7 +50,10 @@
 #define EXCHANGEHALO_HPP
 #include "SparseMatrix.hpp"
 #include "Vector.hpp"
+#include "MultiVector.hpp"
 
 void ExchangeHalo(const SparseMatrix& A, Vector& x);
+void ExchangeHalo(const SparseMatrix& A, MultiVector& X);
+void AccumulateHalo(const SparseMatrix& A, Vector& x);
 
 #endif  // EXCHANGEHALO_HPP
@@ -56,39 +56,64 @@
 #include <omp.h>
 #endif
 
+#include <algorithm>
 #include <cassert>
+#include <string>
+#include <vector>
 #include "GenerateCoarseProblem.hpp"
+#include "GenerateGalerkinProblem.hpp"
 #include "GenerateGeometry.hpp"
 #include "GenerateProblem.hpp"
 #include "SetupHalo.hpp"
+#include "SetupProfile.hpp"
 
-/*!
-  Routine to construct a prolongation/restriction operator for a given fine grid
-  matrix solution (as computed by a direct solver).
-
-  @param[inout]  Af - The known system matrix, on output its coarse operator,
-  fine-to-coarse operator and auxiliary vectors will be defined.
+namespace {
+// Geometry of the grid coarsened by 2 in each dimension
+Geometry* GenerateCoarseGeometry(const Geometry& geomf, int coarseOperator) {
+  assert(geomf.nx % 2 == 0);
+  assert(geomf.ny % 2 == 0);
+  assert(geomf.nz % 2 == 0);  // Need fine grid dimensions to be divisible by 2
 
-  Note that the matrix Af is considered const because the attributes we are
-  modifying are declared as mutable.
+  Geometry* geomc = new Geometry;
+  local_int_t zlc =
+      0;  // Coarsen nz for the lower block in the z processor dimension
+  local_int_t zuc =
+      0;  // Coarsen nz for the upper block in the z processor dimension
+  int pz = geomf.pz;
+  if (pz > 0) {
+    zlc = geomf.partz_nz[0] /
+          2;  // Coarsen nz for the lower block in the z processor dimension
+    zuc = geomf.partz_nz[1] /
+          2;  // Coarsen nz for the upper block in the z processor dimension
+  }
+  GenerateGeometry(geomf.size, geomf.rank, geomf.numThreads, geomf.pz, zlc,
+                   zuc, geomf.nx / 2, geomf.ny / 2, geomf.nz / 2, geomf.npx,
+                   geomf.npy, geomf.npz, geomc);
+  // Same operator, discretized on the coarse grid. Full weighting couples
+  // every coarse point to all its neighbors instead.
+  geomc->stencil = geomf.stencil;
+  if (coarseOperator == HPCG_GALERKIN_FULL_WEIGHTING)
+    geomc->stencil.points = 27;
+  return geomc;
+}
 
-*/
+// Rows and halo of Ac, and the fine-to-coarse operator from Af to it. Uses
+// the geometries only, so the levels do not depend on each other, unless Ac
+// is the Galerkin product of Af.
+local_int_t* GenerateCoarseLevel(const SparseMatrix& Af, SparseMatrix& Ac,
+                                 int coarseOperator) {
+  const Geometry& geomf = *Af.geom;
 
-void GenerateCoarseProblem(const SparseMatrix &Af) {
   // Make local copies of geometry information.  Use global_int_t since the RHS
   // products in the calculations below may result in global range values.
-  global_int_t nxf = Af.geom->nx;
-  global_int_t nyf = Af.geom->ny;
-  global_int_t nzf = Af.geom->nz;
-
-  local_int_t nxc, nyc, nzc;  // Coarse nx, ny, nz
-  assert(nxf % 2 == 0);
-  assert(nyf % 2 == 0);
-  assert(nzf % 2 == 0);  // Need fine grid dimensions to be divisible by 2
-  nxc                      = nxf / 2;
-  nyc                      = nyf / 2;
-  nzc                      = nzf / 2;
-  local_int_t *f2cOperator = new local_int_t[Af.localNumberOfRows];
+  global_int_t nxf = geomf.nx;
+  global_int_t nyf = geomf.ny;
+  global_int_t nzf = geomf.nz;
+
+  local_int_t nxc = Ac.geom->nx;
+  local_int_t nyc = Ac.geom->ny;
+  local_int_t nzc = Ac.geom->nz;
+  local_int_t* f2cOperator = new local_int_t[nxf * nyf * nzf];
   local_int_t localNumberOfRows =
       nxc * nyc * nzc;  // This is the size of our subblock
   // If this assert fails, it most likely means that the local_int_t is set to
@@ -124,40 +149,143 @@ void GenerateCoarseProblem(const SparseMatrix &Af) {
     }    // end even iz if statement
   }      // end iz loop
 
-  // Construct the geometry and linear system
-  Geometry *geomc = new Geometry;
-  local_int_t zlc =
-      0;  // Coarsen nz for the lower block in the z processor dimension
-  local_int_t zuc =
-      0;  // Coarsen nz for the upper block in the z processor dimension
-  int pz = Af.geom->pz;
-  if (pz > 0) {
-    zlc = Af.geom->partz_nz[0] /
-          2;  // Coarsen nz for the lower block in the z processor dimension
-    zuc = Af.geom->partz_nz[1] /
-          2;  // Coarsen nz for the upper block in the z processor dimension
+  if (coarseOperator == HPCG_GEOMETRIC_COARSE) {
+    GenerateLocalProblem(Ac, 0, 0, 0);
+  } else {
+    GenerateGalerkinProblem(Af, Ac, coarseOperator);
+  }
+  SetupHalo(Ac);
+
+  return f2cOperator;
+}
+}  // namespace
+
+/*!
+  Routine to construct the coarse levels of the multigrid hierarchy below a
+  given fine grid matrix, each with its prolongation/restriction operator.
+
+  The coarse grids follow from the fine geometry alone, so the levels are
+  generated concurrently, each by a share of the OpenMP threads proportional
+  to its number of rows. The only collective, the global number of nonzeros,
+  is reduced for all levels at once afterwards. Galerkin coarse operators are
+  computed from the level above instead, so they are built one after the
+  other.
+
+  @param[inout]  Af - The known system matrix, on output its coarse operators,
+  fine-to-coarse operators and auxiliary vectors will be defined down to the
+  coarsest level.
+  @param[in] numberOfCoarseLevels - The number of levels below Af
+  @param[in] coarseOperator - How the coarse operators are built, one of
+  HPCG_GEOMETRIC_COARSE, HPCG_GALERKIN_INJECTION and
+  HPCG_GALERKIN_FULL_WEIGHTING
+
+  Note that the matrix Af is considered const because the attributes we are
+  modifying are declared as mutable.
+*/
+void GenerateCoarseProblems(const SparseMatrix& Af, int numberOfCoarseLevels,
+                            int coarseOperator) {
+  if (numberOfCoarseLevels <= 0) return;
+
+  // Level 0 is Af, its geometry and matrix already exist
+  std::vector<SparseMatrix*> levels(numberOfCoarseLevels + 1);
+  std::vector<local_int_t*> f2cOperators(numberOfCoarseLevels + 1, 0);
+  levels[0] = const_cast<SparseMatrix*>(&Af);
+  for (int level = 1; level <= numberOfCoarseLevels; ++level) {
+    levels[level] = new SparseMatrix;
+    InitializeSparseMatrix(
+        *levels[level],
+        GenerateCoarseGeometry(*levels[level - 1]->geom, coarseOperator));
   }
-  GenerateGeometry(Af.geom->size, Af.geom->rank, Af.geom->numThreads,
-                   Af.geom->pz, zlc, zuc, nxc, nyc, nzc, Af.geom->npx,
-                   Af.geom->npy, Af.geom->npz, geomc);
-
-  SparseMatrix *Ac = new SparseMatrix;
-  InitializeSparseMatrix(*Ac, geomc);
-  GenerateProblem(*Ac, 0, 0, 0);
-  SetupHalo(*Ac);
-  Vector *rc  = new Vector;
-  Vector *xc  = new Vector;
-  Vector *Axf = new Vector;
-  InitializeVector(*rc, Ac->localNumberOfRows);
-  InitializeVector(*xc, Ac->localNumberOfColumns);
-  InitializeVector(*Axf, Af.localNumberOfColumns);
-  Af.Ac          = Ac;
-  MGData *mgData = new MGData;
-  InitializeMGData(f2cOperator, rc, xc, Axf, *mgData);
+
+#if !defined(HPCG_NO_OPENMP) && \
+    !defined(HPCG_WITH_MORPHEUS_DIRECT_GENERATION)
+  if (coarseOperator == HPCG_GEOMETRIC_COARSE) {
+    // Every level but the first gets threads in proportion to its rows, at
+    // least one, and the first level gets the rest
+    const int numberOfThreads = omp_get_max_threads();
+    std::vector<double> levelRows(numberOfCoarseLevels + 1, 0.0);
+    double coarseRows = 0.0;
+    for (int level = 1; level <= numberOfCoarseLevels; ++level) {
+      const Geometry& geomc = *levels[level]->geom;
+      levelRows[level]      = (double)geomc.nx * geomc.ny * geomc.nz;
+      coarseRows += levelRows[level];
+    }
+    std::vector<int> levelThreads(numberOfCoarseLevels + 1, 1);
+    int remainingThreads = numberOfThreads;
+    for (int level = 2; level <= numberOfCoarseLevels; ++level) {
+      levelThreads[level] = std::max(
+          1, (int)(numberOfThreads * levelRows[level] / coarseRows + 0.5));
+      remainingThreads -= levelThreads[level];
+    }
+    levelThreads[1] = std::max(1, remainingThreads);
+
+    // The levels overlap in time, so they are profiled as one phase
+    StartSetupPhase("GenerateCoarseProblem levels 1-" +
+                    std::to_string(numberOfCoarseLevels));
+    const int maxActiveLevels = omp_get_max_active_levels();
+    omp_set_max_active_levels(2);
+#pragma omp parallel num_threads(numberOfCoarseLevels) \
+      if (numberOfThreads > 1 && numberOfCoarseLevels > 1)
+    for (int level = omp_get_thread_num() + 1; level <= numberOfCoarseLevels;
+         level += omp_get_num_threads()) {
+      omp_set_num_threads(levelThreads[level]);
+      f2cOperators[level] = GenerateCoarseLevel(
+          *levels[level - 1], *levels[level], HPCG_GEOMETRIC_COARSE);
+    }
+    omp_set_max_active_levels(maxActiveLevels);
+    StopSetupPhase();
+  } else
+#endif
+  {
+    // Kokkos assembles the Morpheus matrices with all threads, and Galerkin
+    // operators need the level above: level by level
+    for (int level = 1; level <= numberOfCoarseLevels; ++level) {
+      StartSetupPhase("GenerateCoarseProblem level " + std::to_string(level));
+      f2cOperators[level] = GenerateCoarseLevel(
+          *levels[level - 1], *levels[level], coarseOperator);
+      StopSetupPhase();
+    }
+  }
+
+  ReduceNumberOfNonzeros(&levels[1], numberOfCoarseLevels);
+
+  for (int level = 1; level <= numberOfCoarseLevels; ++level) {
+    const SparseMatrix& Af = *levels[level - 1];
+    SparseMatrix* Ac       = levels[level];
+
+    Vector* rc  = new Vector;
+    Vector* xc  = new Vector;
+    Vector* Axf = new Vector;
+    InitializeVector(*rc, Ac->localNumberOfRows);
+    InitializeVector(*xc, Ac->localNumberOfColumns);
+    InitializeVector(*Axf, Af.localNumberOfColumns);
+    Af.Ac          = Ac;
+    MGData* mgData = new MGData;
+    InitializeMGData(f2cOperators[level], rc, xc, Axf, *mgData);
 #ifdef HPCG_WITH_MORPHEUS
-  mgData->f2cOperator_localLength = Af.localNumberOfRows;
+    mgData->f2cOperator_localLength = Af.localNumberOfRows;
 #endif
-  Af.mgData = mgData;
+    mgData->coarseOperator = coarseOperator;
+    if (coarseOperator == HPCG_GALERKIN_FULL_WEIGHTING)
+      SetupFullWeighting(Af, *Ac, *mgData);
+    Af.mgData = mgData;
+  }
 
   return;
 }
+
+/*!
+  Routine to construct a prolongation/restriction operator for a given fine grid
+  matrix solution (as computed by a direct solver).
+
+  @param[inout]  Af - The known system matrix, on output its coarse operator,
+  fine-to-coarse operator and auxiliary vectors will be defined.
+
+  Note that the matrix Af is considered const because the attributes we are
+  modifying are declared as mutable.
+
+*/
+
+void GenerateCoarseProblem(const SparseMatrix& Af) {
+  GenerateCoarseProblems(Af, 1, HPCG_GEOMETRIC_COARSE);
+}
@@ -51,4 +51,6 @@
 #include "SparseMatrix.hpp"
 
 void GenerateCoarseProblem(const SparseMatrix& A);
+void GenerateCoarseProblems(const SparseMatrix& A, int numberOfCoarseLevels,
+                            int coarseOperator);
 #endif  // GENERATECOARSEPROBLEM_HPP
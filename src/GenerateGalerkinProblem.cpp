@@ -0,0 +1,442 @@
+/**
+ * GenerateGalerkinProblem.cpp
+ *
+ * EPCC, The University of Edinburgh
+ *
+ * (c) 2022 The University of Edinburgh
+ *
+ * Contributing Authors:
+ * Christodoulos Stylianou (c.stylianou@ed.ac.uk)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*!
+ @file GenerateGalerkinProblem.cpp
+
+ HPCG routines for coarse operators computed from the fine operator
+ */
+
+#ifndef HPCG_NO_MPI
+#include <mpi.h>
+#endif
+
+#ifndef HPCG_NO_OPENMP
+#include <omp.h>
+#endif
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <map>
+#include <vector>
+
+#include "GenerateGalerkinProblem.hpp"
+#include "Stencil.hpp"
+
+namespace {
+// Partial sums of a row of the coarse operator. The entry of the column at
+// offset (sx, sy, sz) from the row is kept at StencilIndex(sx, sy, sz), and
+// its bit in mask is set once a product reaches it.
+typedef struct galerkin_row {
+  global_int_t row;
+  uint32_t mask;
+  double value[27];
+} galerkin_row;
+
+// Coarse points along an axis of nc coarse points that the fine point g is
+// interpolated from, with their weights: the coarse point itself for even
+// points, the two coarse points around it for odd ones with full weighting
+// and none with injection. Coarse points outside the domain are zero.
+int CoarsePoints(global_int_t g, global_int_t nc, bool fullWeighting,
+                 global_int_t c[2], double w[2]) {
+  if (g % 2 == 0) {
+    c[0] = g / 2;
+    w[0] = 1.0;
+    return 1;
+  }
+  if (!fullWeighting) return 0;
+  int n = 0;
+  c[n]   = g / 2;
+  w[n++] = 0.5;
+  if (g / 2 + 1 < nc) {
+    c[n]   = g / 2 + 1;
+    w[n++] = 0.5;
+  }
+  return n;
+}
+
+// Sums P(f, I) A(f, g) P(g, J) over the fine rows f of this process for the
+// coarse row I = r.row. The fine points next to I are at most one step away
+// and the coarse points they reach at most one step from I.
+void AccumulateRow(const SparseMatrix& Af, const Geometry& geomc,
+                   bool fullWeighting, galerkin_row& r) {
+  const Geometry& geomf   = *Af.geom;
+  const global_int_t gnxf = geomf.gnx;
+  const global_int_t gnyf = geomf.gny;
+  const global_int_t gnxc = geomc.gnx;
+  const global_int_t gnyc = geomc.gny;
+  const global_int_t gnzc = geomc.gnz;
+  const global_int_t ix   = r.row % gnxc;
+  const global_int_t iy   = (r.row / gnxc) % gnyc;
+  const global_int_t iz   = r.row / (gnxc * gnyc);
+
+  r.mask = 0;
+  std::fill(r.value, r.value + 27, 0.0);
+
+  const int reach = fullWeighting ? 1 : 0;
+  for (int fz = -reach; fz <= reach; fz++) {
+    const global_int_t giz = 2 * iz + fz;
+    if (giz < geomf.giz0 || giz >= geomf.giz0 + geomf.nz) continue;
+    for (int fy = -reach; fy <= reach; fy++) {
+      const global_int_t giy = 2 * iy + fy;
+      if (giy < geomf.giy0 || giy >= geomf.giy0 + geomf.ny) continue;
+      for (int fx = -reach; fx <= reach; fx++) {
+        const global_int_t gix = 2 * ix + fx;
+        if (gix < geomf.gix0 || gix >= geomf.gix0 + geomf.nx) continue;
+
+        const local_int_t f =
+            Af.globalToLocalMap[giz * gnxf * gnyf + giy * gnxf + gix];
+        const double wf =
+            (fx ? 0.5 : 1.0) * (fy ? 0.5 : 1.0) * (fz ? 0.5 : 1.0);
+        for (int j = 0; j < Af.nonzerosInRow[f]; j++) {
+          const global_int_t g = Af.mtxIndG[f][j];
+          const double a       = wf * Af.matrixValues[f][j];
+
+          global_int_t cx[2], cy[2], cz[2];
+          double wx[2], wy[2], wz[2];
+          const int nx = CoarsePoints(g % gnxf, gnxc, fullWeighting, cx, wx);
+          const int ny =
+              CoarsePoints((g / gnxf) % gnyf, gnyc, fullWeighting, cy, wy);
+          const int nz =
+              CoarsePoints(g / (gnxf * gnyf), gnzc, fullWeighting, cz, wz);
+          for (int kz = 0; kz < nz; kz++) {
+            for (int ky = 0; ky < ny; ky++) {
+              for (int kx = 0; kx < nx; kx++) {
+                const int s = StencilIndex(cx[kx] - ix, cy[ky] - iy,
+                                           cz[kz] - iz);
+                assert(s >= 0 && s < 27);
+                r.value[s] += a * wx[kx] * wy[ky] * wz[kz];
+                r.mask |= uint32_t(1) << s;
+              }
+            }
+          }
+        }
+      }
+    }
+  }
+}
+}  // namespace
+
+/*!
+  Routine to compute the rows of this process of the Galerkin coarse operator
+  Ac = R Af P, with P the injection or the trilinear interpolation from the
+  grid of Ac to the grid of Af, and R = P^T. Injection keeps the couplings of
+  the fine points that are also coarse points, i.e. the diagonal of Af for a
+  stencil of one step, and full weighting gives a 27-point operator.
+
+  Every process sums the products over its own fine rows. With full weighting
+  the fine rows next to the upper faces of the box also contribute to the
+  coarse rows just beyond them, and these partial rows are sent to the
+  processes that own them.
+
+  Like GenerateLocalProblem, it leaves the global number of nonzeros to
+  ReduceNumberOfNonzeros and the halo to SetupHalo.
+
+  @param[in]    Af             The fine matrix, with its global column ids
+  @param[inout] Ac             The coarse matrix, initialized with the coarse
+                               geometry
+  @param[in]    coarseOperator HPCG_GALERKIN_INJECTION or
+                               HPCG_GALERKIN_FULL_WEIGHTING
+
+  @see SetupFullWeighting
+*/
+void GenerateGalerkinProblem(const SparseMatrix& Af, SparseMatrix& Ac,
+                             int coarseOperator) {
+  const Geometry& geomc    = *Ac.geom;
+  const bool fullWeighting = coarseOperator == HPCG_GALERKIN_FULL_WEIGHTING;
+
+  const global_int_t nx   = geomc.nx;
+  const global_int_t ny   = geomc.ny;
+  const global_int_t nz   = geomc.nz;
+  const global_int_t gnx  = geomc.gnx;
+  const global_int_t gny  = geomc.gny;
+  const global_int_t gnz  = geomc.gnz;
+  const global_int_t gix0 = geomc.gix0;
+  const global_int_t giy0 = geomc.giy0;
+  const global_int_t giz0 = geomc.giz0;
+
+  const local_int_t localNumberOfRows  = nx * ny * nz;
+  const global_int_t totalNumberOfRows = gnx * gny * gnz;
+  assert(localNumberOfRows > 0);
+  assert(totalNumberOfRows > 0);
+  Ac.globalToLocalMap.setBox(geomc);
+
+  std::vector<galerkin_row> rows(localNumberOfRows);
+  for (local_int_t row = 0; row < localNumberOfRows; ++row) {
+    rows[row].row = (giz0 + row / (nx * ny)) * gnx * gny +
+                    (giy0 + (row / nx) % ny) * gnx + gix0 + row % nx;
+  }
+  // Coarse rows one step beyond the upper faces of the box, grouped by owner
+  std::vector<galerkin_row> outer;
+  std::vector<int> owners;
+  if (fullWeighting) {
+    for (global_int_t iz = 0; iz <= nz && giz0 + iz < gnz; ++iz) {
+      for (global_int_t iy = 0; iy <= ny && giy0 + iy < gny; ++iy) {
+        for (global_int_t ix = 0; ix <= nx && gix0 + ix < gnx; ++ix) {
+          if (ix < nx && iy < ny && iz < nz) continue;
+          galerkin_row r;
+          r.row = (giz0 + iz) * gnx * gny + (giy0 + iy) * gnx + gix0 + ix;
+          outer.push_back(r);
+          owners.push_back(ComputeRankOfMatrixRow(geomc, r.row));
+        }
+      }
+    }
+    std::vector<size_t> order(outer.size());
+    for (size_t k = 0; k < order.size(); ++k) order[k] = k;
+    std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+      return owners[a] < owners[b];
+    });
+    std::vector<galerkin_row> sorted(outer.size());
+    std::vector<int> sortedOwners(outer.size());
+    for (size_t k = 0; k < order.size(); ++k) {
+      sorted[k]       = outer[order[k]];
+      sortedOwners[k] = owners[order[k]];
+    }
+    outer.swap(sorted);
+    owners.swap(sortedOwners);
+  }
+
+  const local_int_t numberOfOuterRows = outer.size();
+#ifndef HPCG_NO_OPENMP
+#pragma omp parallel for
+#endif
+  for (local_int_t row = 0; row < localNumberOfRows; ++row) {
+    AccumulateRow(Af, geomc, fullWeighting, rows[row]);
+  }
+#ifndef HPCG_NO_OPENMP
+#pragma omp parallel for
+#endif
+  for (local_int_t k = 0; k < numberOfOuterRows; ++k) {
+    AccumulateRow(Af, geomc, fullWeighting, outer[k]);
+  }
+
+#ifndef HPCG_NO_MPI
+  if (fullWeighting) {
+    const int size = geomc.size;
+    std::vector<int> sendCounts(size, 0), sendDispls(size, 0);
+    std::vector<int> recvCounts(size, 0), recvDispls(size, 0);
+    for (size_t k = 0; k < owners.size(); ++k) ++sendCounts[owners[k]];
+    MPI_Alltoall(sendCounts.data(), 1, MPI_INT, recvCounts.data(), 1, MPI_INT,
+                 MPI_COMM_WORLD);
+    for (int p = 1; p < size; ++p) {
+      sendDispls[p] = sendDispls[p - 1] + sendCounts[p - 1];
+      recvDispls[p] = recvDispls[p - 1] + recvCounts[p - 1];
+    }
+
+    MPI_Datatype rowType;
+    MPI_Type_contiguous(sizeof(galerkin_row), MPI_BYTE, &rowType);
+    MPI_Type_commit(&rowType);
+    std::vector<galerkin_row> received(recvDispls[size - 1] +
+                                       recvCounts[size - 1]);
+    MPI_Alltoallv(outer.data(), sendCounts.data(), sendDispls.data(), rowType,
+                  received.data(), recvCounts.data(), recvDispls.data(),
+                  rowType, MPI_COMM_WORLD);
+    MPI_Type_free(&rowType);
+
+    // Added in the order of the sending ranks, so the sums are reproducible
+    for (size_t k = 0; k < received.size(); ++k) {
+      const local_int_t row = Ac.globalToLocalMap[received[k].row];
+      assert(row >= 0);
+      rows[row].mask |= received[k].mask;
+      for (int s = 0; s < 27; s++) rows[row].value[s] += received[k].value[s];
+    }
+  }
+#endif
+  std::vector<galerkin_row>().swap(outer);
+
+  // Rows are allocated with room for the stencil of the coarse geometry
+  const local_int_t numberOfNonzerosPerRow = geomc.stencil.points;
+
+  char* nonzerosInRow     = new char[localNumberOfRows];
+  global_int_t** mtxIndG  = new global_int_t*[localNumberOfRows];
+  local_int_t** mtxIndL   = new local_int_t*[localNumberOfRows];
+  double** matrixValues   = new double*[localNumberOfRows];
+  double** matrixDiagonal = new double*[localNumberOfRows];
+  Ac.localToGlobalMap.resize(localNumberOfRows);
+
+#ifdef HPCG_CONTIGUOUS_ARRAYS
+  const local_int_t numberOfEntries =
+      localNumberOfRows * numberOfNonzerosPerRow;
+  local_int_t* indL  = new local_int_t[numberOfEntries];
+  double* values     = new double[numberOfEntries];
+  global_int_t* indG = new global_int_t[numberOfEntries];
+#endif
+
+  local_int_t localNumberOfNonzeros = 0;
+#ifndef HPCG_NO_OPENMP
+#pragma omp parallel for reduction(+ : localNumberOfNonzeros)
+#endif
+  for (local_int_t row = 0; row < localNumberOfRows; ++row) {
+#ifndef HPCG_CONTIGUOUS_ARRAYS
+    mtxIndL[row]      = new local_int_t[numberOfNonzerosPerRow];
+    matrixValues[row] = new double[numberOfNonzerosPerRow];
+    mtxIndG[row]      = new global_int_t[numberOfNonzerosPerRow];
+#else
+    mtxIndL[row]      = indL + row * numberOfNonzerosPerRow;
+    matrixValues[row] = values + row * numberOfNonzerosPerRow;
+    mtxIndG[row]      = indG + row * numberOfNonzerosPerRow;
+#endif
+    matrixDiagonal[row] = 0;
+
+    // The columns come out sorted, as in GenerateProblem
+    const galerkin_row& r             = rows[row];
+    local_int_t numberOfNonzerosInRow = 0;
+    for (int s = 0; s < 27; s++) {
+      if (!(r.mask >> s & 1)) continue;
+      assert(numberOfNonzerosInRow < numberOfNonzerosPerRow);
+      const global_int_t curcol =
+          r.row + (s / 9 - 1) * gnx * gny + (s / 3 % 3 - 1) * gnx + s % 3 - 1;
+      double* value = matrixValues[row] + numberOfNonzerosInRow;
+      if (curcol == r.row) matrixDiagonal[row] = value;
+      *value                                = r.value[s];
+      mtxIndG[row][numberOfNonzerosInRow++] = curcol;
+    }
+    assert(matrixDiagonal[row] != 0);
+
+    nonzerosInRow[row]       = (char)numberOfNonzerosInRow;
+    Ac.localToGlobalMap[row] = r.row;
+    localNumberOfNonzeros += numberOfNonzerosInRow;
+  }
+
+  Ac.title                 = 0;
+  Ac.totalNumberOfRows     = totalNumberOfRows;
+  Ac.localNumberOfRows     = localNumberOfRows;
+  Ac.localNumberOfColumns  = localNumberOfRows;
+  Ac.localNumberOfNonzeros = localNumberOfNonzeros;
+  Ac.nonzerosInRow         = nonzerosInRow;
+  Ac.mtxIndG               = mtxIndG;
+  Ac.mtxIndL               = mtxIndL;
+  Ac.matrixValues          = matrixValues;
+  Ac.matrixDiagonal        = matrixDiagonal;
+}
+
+/*!
+  Routine to set up the full-weighting transfers between a fine matrix and
+  its Galerkin coarse operator: the trilinear interpolation P, by fine row,
+  and its transpose R = P^T, by column of Ac. The fine points on the upper
+  faces of the box interpolate from coarse points of other processes, which
+  are in the halo of Ac since Ac couples every coarse point to its 26
+  neighbors. The restriction of a residual thus gives partial sums for these
+  points, which AccumulateHalo adds to the entries of their owners.
+
+  @param[in]    Af   The fine matrix
+  @param[in]    Ac   The coarse operator, with its halo set up
+  @param[inout] data The MG data of Af, on exit with the transfers and the
+                     coarse residual with room for the halo
+
+  @see GenerateGalerkinProblem
+*/
+void SetupFullWeighting(const SparseMatrix& Af, const SparseMatrix& Ac,
+                        MGData& data) {
+  const Geometry& geomf  = *Af.geom;
+  const Geometry& geomc  = *Ac.geom;
+  const local_int_t nf   = Af.localNumberOfRows;
+  const local_int_t nc   = Ac.localNumberOfRows;
+  const local_int_t ncol = Ac.localNumberOfColumns;
+
+  // Local ids of the external columns of Ac
+  std::map<global_int_t, local_int_t> externals;
+  for (local_int_t i = 0; i < nc; i++) {
+    for (int j = 0; j < Ac.nonzerosInRow[i]; j++) {
+      if (Ac.mtxIndL[i][j] >= nc)
+        externals[Ac.mtxIndG[i][j]] = Ac.mtxIndL[i][j];
+    }
+  }
+
+  Transfer P;
+  P.numberOfRows = nf;
+  P.rowStart     = new local_int_t[nf + 1];
+  P.columns      = new local_int_t[8 * nf];
+  P.values       = new double[8 * nf];
+
+  // Rows of at most 8 entries, packed afterwards
+  std::vector<int> count(nf);
+#ifndef HPCG_NO_OPENMP
+#pragma omp parallel for
+#endif
+  for (local_int_t f = 0; f < nf; ++f) {
+    const global_int_t g = Af.localToGlobalMap[f];
+    global_int_t cx[2], cy[2], cz[2];
+    double wx[2], wy[2], wz[2];
+    const int nx = CoarsePoints(g % geomf.gnx, geomc.gnx, true, cx, wx);
+    const int ny =
+        CoarsePoints((g / geomf.gnx) % geomf.gny, geomc.gny, true, cy, wy);
+    const int nz =
+        CoarsePoints(g / (geomf.gnx * geomf.gny), geomc.gnz, true, cz, wz);
+    int n = 0;
+    for (int kz = 0; kz < nz; kz++) {
+      for (int ky = 0; ky < ny; ky++) {
+        for (int kx = 0; kx < nx; kx++) {
+          const global_int_t col =
+              cz[kz] * geomc.gnx * geomc.gny + cy[ky] * geomc.gnx + cx[kx];
+          local_int_t c = Ac.globalToLocalMap[col];
+          if (c < 0) {
+            assert(externals.count(col) == 1);
+            c = externals.find(col)->second;
+          }
+          P.columns[8 * f + n] = c;
+          P.values[8 * f + n]  = wx[kx] * wy[ky] * wz[kz];
+          n++;
+        }
+      }
+    }
+    count[f] = n;
+  }
+  P.rowStart[0] = 0;
+  for (local_int_t f = 0; f < nf; ++f) {
+    P.rowStart[f + 1] = P.rowStart[f] + count[f];
+    for (int k = 0; k < count[f]; k++) {
+      P.columns[P.rowStart[f] + k] = P.columns[8 * f + k];
+      P.values[P.rowStart[f] + k]  = P.values[8 * f + k];
+    }
+  }
+
+  // The transpose, with the fine rows of every column in increasing order
+  Transfer R;
+  R.numberOfRows = ncol;
+  R.rowStart     = new local_int_t[ncol + 1];
+  R.columns      = new local_int_t[P.rowStart[nf]];
+  R.values       = new double[P.rowStart[nf]];
+  std::fill(R.rowStart, R.rowStart + ncol + 1, 0);
+  for (local_int_t k = 0; k < P.rowStart[nf]; ++k)
+    R.rowStart[P.columns[k] + 1]++;
+  for (local_int_t c = 0; c < ncol; ++c) R.rowStart[c + 1] += R.rowStart[c];
+  std::vector<local_int_t> next(R.rowStart, R.rowStart + ncol);
+  for (local_int_t f = 0; f < nf; ++f) {
+    for (local_int_t k = P.rowStart[f]; k < P.rowStart[f + 1]; ++k) {
+      const local_int_t n = next[P.columns[k]]++;
+      R.columns[n]        = f;
+      R.values[n]         = P.values[k];
+    }
+  }
+
+  DeleteTransfer(data.interpolation);
+  DeleteTransfer(data.restriction);
+  data.interpolation = P;
+  data.restriction   = R;
+  if (data.rcOverlap == 0) {
+    data.rcOverlap = new Vector;
+    InitializeVector(*data.rcOverlap, ncol);
+  }
+}
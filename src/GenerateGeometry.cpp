@@ -58,6 +58,7 @@
 
 #include "ComputeOptimalShapeXYZ.hpp"
 #include "GenerateGeometry.hpp"
+#include "Stencil.hpp"
 
 #ifdef HPCG_DEBUG
 #include <fstream>
@@ -198,6 +199,8 @@ void GenerateGeometry(int size, int rank, int numThreads, int pz,
   geom->gix0 = gix0;
   geom->giy0 = giy0;
   geom->giz0 = giz0;
+  // The benchmark operator, callers may choose another one
+  InitializeStencil(geom->stencil);
 
   return;
 }
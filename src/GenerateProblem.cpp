@@ -62,6 +62,188 @@
 
 #include "GenerateProblem.hpp"
 #include "GenerateProblem_ref.hpp"
+#include "Stencil.hpp"
+
+#if defined(HPCG_WITH_MORPHEUS_DIRECT_GENERATION)
+#include "morpheus/Morpheus_GenerateProblem.hpp"
+#endif
+
+#include <cassert>
+#include <vector>
+
+#if !defined(HPCG_WITH_MORPHEUS_DIRECT_GENERATION)
+/*!
+  Same problem and data structures as GenerateProblem_ref, except for the
+  global number of nonzeros, and without its critical sections: the rows are
+  flattened into a single parallel loop, the nonzeros are summed with a
+  reduction and the global-to-local map is computed from the local box. The
+  rows are allocated by the threads that fill them.
+*/
+static void GenerateLocalProblem_opt(SparseMatrix& A, Vector* b, Vector* x,
+                                     Vector* xexact) {
+  // Make local copies of geometry information.  Use global_int_t since the RHS
+  // products in the calculations below may result in global range values.
+  const global_int_t nx   = A.geom->nx;
+  const global_int_t ny   = A.geom->ny;
+  const global_int_t nz   = A.geom->nz;
+  const global_int_t gnx  = A.geom->gnx;
+  const global_int_t gny  = A.geom->gny;
+  const global_int_t gnz  = A.geom->gnz;
+  const global_int_t gix0 = A.geom->gix0;
+  const global_int_t giy0 = A.geom->giy0;
+  const global_int_t giz0 = A.geom->giz0;
+
+  const local_int_t localNumberOfRows  = nx * ny * nz;
+  const global_int_t totalNumberOfRows = gnx * gny * gnz;
+  assert(localNumberOfRows > 0);
+  assert(totalNumberOfRows > 0);
+  // Rows are allocated with room for a full stencil
+  const local_int_t numberOfNonzerosPerRow = A.geom->stencil.points;
+  StencilValues stencil;
+  InitializeStencilValues(A.geom->stencil, stencil);
+
+  char* nonzerosInRow     = new char[localNumberOfRows];
+  global_int_t** mtxIndG  = new global_int_t*[localNumberOfRows];
+  local_int_t** mtxIndL   = new local_int_t*[localNumberOfRows];
+  double** matrixValues   = new double*[localNumberOfRows];
+  double** matrixDiagonal = new double*[localNumberOfRows];
+
+  if (b != 0) InitializeVector(*b, localNumberOfRows);
+  if (x != 0) InitializeVector(*x, localNumberOfRows);
+  if (xexact != 0) InitializeVector(*xexact, localNumberOfRows);
+  double* bv      = b != 0 ? b->values : 0;
+  double* xv      = x != 0 ? x->values : 0;
+  double* xexactv = xexact != 0 ? xexact->values : 0;
+  A.localToGlobalMap.resize(localNumberOfRows);
+
+#ifdef HPCG_CONTIGUOUS_ARRAYS
+  const local_int_t numberOfEntries =
+      localNumberOfRows * numberOfNonzerosPerRow;
+  local_int_t* indL  = new local_int_t[numberOfEntries];
+  double* values     = new double[numberOfEntries];
+  global_int_t* indG = new global_int_t[numberOfEntries];
+#endif
+
+  local_int_t localNumberOfNonzeros = 0;
+#ifndef HPCG_NO_OPENMP
+#pragma omp parallel for reduction(+ : localNumberOfNonzeros)
+#endif
+  for (local_int_t row = 0; row < localNumberOfRows; ++row) {
+    const global_int_t gix       = gix0 + row % nx;
+    const global_int_t giy       = giy0 + (row / nx) % ny;
+    const global_int_t giz       = giz0 + row / (nx * ny);
+    const global_int_t globalRow = giz * gnx * gny + giy * gnx + gix;
+
+#ifndef HPCG_CONTIGUOUS_ARRAYS
+    mtxIndL[row]      = new local_int_t[numberOfNonzerosPerRow];
+    matrixValues[row] = new double[numberOfNonzerosPerRow];
+    mtxIndG[row]      = new global_int_t[numberOfNonzerosPerRow];
+#else
+    mtxIndL[row]      = indL + row * numberOfNonzerosPerRow;
+    matrixValues[row] = values + row * numberOfNonzerosPerRow;
+    mtxIndG[row]      = indG + row * numberOfNonzerosPerRow;
+#endif
+    matrixDiagonal[row] = 0;
+
+    StencilValues point;
+    const StencilValues& rowValues =
+        ComputeStencilValues(*A.geom, stencil, gix, giy, giz, point);
+
+    char numberOfNonzerosInRow         = 0;
+    double rowSum                      = 0.0;
+    double* currentValuePointer        = matrixValues[row];
+    global_int_t* currentIndexPointerG = mtxIndG[row];
+    for (int sz = -1; sz <= 1; sz++) {
+      if (giz + sz < 0 || giz + sz >= gnz) continue;
+      for (int sy = -1; sy <= 1; sy++) {
+        if (giy + sy < 0 || giy + sy >= gny) continue;
+        for (int sx = -1; sx <= 1; sx++) {
+          if (gix + sx < 0 || gix + sx >= gnx) continue;
+          const double value = rowValues.value[StencilIndex(sx, sy, sz)];
+          if (value == 0.0) continue;  // Not a point of the stencil
+          const global_int_t curcol =
+              globalRow + sz * gnx * gny + sy * gnx + sx;
+          if (curcol == globalRow) matrixDiagonal[row] = currentValuePointer;
+          *currentValuePointer++  = value;
+          *currentIndexPointerG++ = curcol;
+          rowSum += value;
+          numberOfNonzerosInRow++;
+        }
+      }
+    }
+
+    nonzerosInRow[row]      = numberOfNonzerosInRow;
+    A.localToGlobalMap[row] = globalRow;
+    localNumberOfNonzeros += numberOfNonzerosInRow;
+    // The exact solution is a vector of ones
+    if (bv != 0) bv[row] = rowSum;
+    if (xv != 0) xv[row] = 0.0;
+    if (xexactv != 0) xexactv[row] = 1.0;
+  }
+
+  A.globalToLocalMap.setBox(*A.geom);
+
+  A.title                 = 0;
+  A.totalNumberOfRows     = totalNumberOfRows;
+  A.localNumberOfRows     = localNumberOfRows;
+  A.localNumberOfColumns  = localNumberOfRows;
+  A.localNumberOfNonzeros = localNumberOfNonzeros;
+  A.nonzerosInRow         = nonzerosInRow;
+  A.mtxIndG               = mtxIndG;
+  A.mtxIndL               = mtxIndL;
+  A.matrixValues          = matrixValues;
+  A.matrixDiagonal        = matrixDiagonal;
+}
+#endif  // !HPCG_WITH_MORPHEUS_DIRECT_GENERATION
+
+/*!
+  Routine to generate the rows of this process of a sparse matrix, right hand
+  side, initial guess, and exact solution. Does not communicate, the global
+  number of nonzeros is left to ReduceNumberOfNonzeros.
+
+  @see GenerateProblem
+*/
+void GenerateLocalProblem(SparseMatrix& A, Vector* b, Vector* x,
+                          Vector* xexact) {
+#if defined(HPCG_WITH_MORPHEUS_DIRECT_GENERATION)
+  // Same data structures, with the rows stored in the Morpheus CSR matrix
+  MorpheusGenerateProblem(A, b, x, xexact);
+#else
+  GenerateLocalProblem_opt(A, b, x, xexact);
+#endif
+}
+
+/*!
+  Sums the local numbers of nonzeros of several matrices across all processes
+  with a single reduction.
+
+  @param[inout] A     The matrices, on exit with their global number of nonzeros
+  @param[in]    count The number of matrices
+*/
+void ReduceNumberOfNonzeros(SparseMatrix* const* A, int count) {
+  std::vector<global_int_t> localNumberOfNonzeros(count);
+  std::vector<global_int_t> totalNumberOfNonzeros(count);
+  for (int i = 0; i < count; ++i) {
+    localNumberOfNonzeros[i] = A[i]->localNumberOfNonzeros;
+  }
+#ifndef HPCG_NO_MPI
+#ifdef HPCG_NO_LONG_LONG
+  MPI_Datatype MPI_GLOBAL_INT_TYPE = MPI_INT;
+#else
+  MPI_Datatype MPI_GLOBAL_INT_TYPE = MPI_LONG_LONG_INT;
+#endif
+  MPI_Allreduce(localNumberOfNonzeros.data(), totalNumberOfNonzeros.data(),
+                count, MPI_GLOBAL_INT_TYPE, MPI_SUM, MPI_COMM_WORLD);
+#else
+  totalNumberOfNonzeros = localNumberOfNonzeros;
+#endif
+  for (int i = 0; i < count; ++i) {
+    // If this assert fails, it most likely means that the global_int_t is set
+    // to int and should be set to long long
+    assert(totalNumberOfNonzeros[i] > 0);
+    A[i]->totalNumberOfNonzeros = totalNumberOfNonzeros[i];
+  }
+}
 
 /*!
   Routine to generate a sparse matrix, right hand side, initial guess, and exact
@@ -85,5 +267,7 @@ void GenerateProblem(SparseMatrix& A, Vector* b, Vector* x, Vector* xexact) {
   // general unstructured sparse matrices.  Special knowledge about the specific
   // nature of the sparsity pattern may not be explicitly used.
 
-  return (GenerateProblem_ref(A, b, x, xexact));
+  GenerateLocalProblem(A, b, x, xexact);
+  SparseMatrix* matrices[] = {&A};
+  ReduceNumberOfNonzeros(matrices, 1);
 }
@@ -52,4 +52,7 @@
 #include "Vector.hpp"
 
 void GenerateProblem(SparseMatrix& A, Vector* b, Vector* x, Vector* xexact);
+void GenerateLocalProblem(SparseMatrix& A, Vector* b, Vector* x,
+                          Vector* xexact);
+void ReduceNumberOfNonzeros(SparseMatrix* const* A, int count);
 #endif  // GENERATEPROBLEM_HPP
@@ -68,6 +68,7 @@ using std::endl;
 #include <cassert>
 
 #include "GenerateProblem_ref.hpp"
+#include "Stencil.hpp"
 
 /*!
   Reference version of GenerateProblem to generate the sparse matrix, right hand
@@ -105,8 +106,10 @@ void GenerateProblem_ref(SparseMatrix& A, Vector* b, Vector* x,
   assert(localNumberOfRows > 0);  // Throw an exception of the number of rows is
                                   // less than zero (can happen if int overflow)
   local_int_t numberOfNonzerosPerRow =
-      27;  // We are approximating a 27-point finite element/volume/difference
-           // 3D stencil
+      A.geom->stencil.points;  // We are approximating a 7-point or 27-point
+                               // finite element/volume/difference 3D stencil
+  StencilValues stencil;
+  InitializeStencilValues(A.geom->stencil, stencil);
 
   global_int_t totalNumberOfRows =
       gnx * gny * gnz;  // Total number of grid points in mesh
@@ -183,10 +186,10 @@ void GenerateProblem_ref(SparseMatrix& A, Vector* b, Vector* x,
         local_int_t currentLocalRow   = iz * nx * ny + iy * nx + ix;
         global_int_t currentGlobalRow = giz * gnx * gny + giy * gnx + gix;
 #ifndef HPCG_NO_OPENMP
-        // C++ std::map is not threadsafe for writing
+        // The inserted rows are not threadsafe for writing
 #pragma omp critical
 #endif
-        A.globalToLocalMap[currentGlobalRow] = currentLocalRow;
+        A.globalToLocalMap.insert(currentGlobalRow, currentLocalRow);
 
         A.localToGlobalMap[currentLocalRow] = currentGlobalRow;
 #ifdef HPCG_DETAILED_DEBUG
@@ -194,7 +197,11 @@ void GenerateProblem_ref(SparseMatrix& A, Vector* b, Vector* x,
                   << currentGlobalRow << " "
                   << A.globalToLocalMap[currentGlobalRow] << endl;
 #endif
+        StencilValues point;
+        const StencilValues& rowValues =
+            ComputeStencilValues(*A.geom, stencil, gix, giy, giz, point);
         char numberOfNonzerosInRow = 0;
+        double rowSum              = 0.0;  // Row of A times the exact solution
         double* currentValuePointer =
             matrixValues[currentLocalRow];  // Pointer to current value in
                                             // current row
@@ -206,18 +213,19 @@ void GenerateProblem_ref(SparseMatrix& A, Vector* b, Vector* x,
             for (int sy = -1; sy <= 1; sy++) {
               if (giy + sy > -1 && giy + sy < gny) {
                 for (int sx = -1; sx <= 1; sx++) {
-                  if (gix + sx > -1 && gix + sx < gnx) {
+                  double value =
+                      rowValues.value[StencilIndex(sx, sy, sz)];
+                  if (gix + sx > -1 && gix + sx < gnx && value != 0.0) {
                     global_int_t curcol =
                         currentGlobalRow + sz * gnx * gny + sy * gnx + sx;
                     if (curcol == currentGlobalRow) {
                       matrixDiagonal[currentLocalRow] = currentValuePointer;
-                      *currentValuePointer++          = 26.0;
-                    } else {
-                      *currentValuePointer++ = -1.0;
                     }
+                    *currentValuePointer++  = value;
                     *currentIndexPointerG++ = curcol;
+                    rowSum += value;
                     numberOfNonzerosInRow++;
-                  }  // end x bounds test
+                  }  // end x bounds and stencil test
                 }    // end sx loop
               }      // end y bounds test
             }        // end sy loop
@@ -229,13 +237,13 @@ void GenerateProblem_ref(SparseMatrix& A, Vector* b, Vector* x,
 #endif
         localNumberOfNonzeros +=
             numberOfNonzerosInRow;  // Protect this with an atomic
-        if (b != 0)
-          bv[currentLocalRow] = 26.0 - ((double)(numberOfNonzerosInRow - 1));
+        if (b != 0) bv[currentLocalRow] = rowSum;
         if (x != 0) xv[currentLocalRow] = 0.0;
         if (xexact != 0) xexactv[currentLocalRow] = 1.0;
       }  // end ix loop
     }    // end iy loop
   }      // end iz loop
+  A.globalToLocalMap.finalize();
 #ifdef HPCG_DETAILED_DEBUG
   HPCG_fout << "Process " << A.geom->rank << " of " << A.geom->size << " has "
             << localNumberOfRows << " rows." << endl
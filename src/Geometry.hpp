@@ -78,6 +78,18 @@ typedef long long global_int_t;
 // in order to stop complaints from non-C++11 compliant compilers.
 //#define HPCG_NO_LONG_LONG
 
+/*!
+  This is a data structure to describe the operator generated on the grid
+*/
+struct Stencil_STRUCT {
+  int points;    //!< Number of points of the stencil, 7 or 27
+  double ax;     //!< Strength of the couplings in the x-direction
+  double ay;     //!< Strength of the couplings in the y-direction
+  double az;     //!< Strength of the couplings in the z-direction
+  int variable;  //!< Whether the couplings vary smoothly over the domain
+};
+typedef struct Stencil_STRUCT Stencil;
+
 /*!
   This is a data structure to contain all processor geometry information
 */
@@ -116,6 +128,7 @@ struct Geometry_STRUCT {
                       //!< by npz processor grid
   global_int_t giz0;  //!< Base global z index for this rank in the npx by npy
                       //!< by npz processor grid
+  Stencil stencil;    //!< Operator generated on the grid
 };
 typedef struct Geometry_STRUCT Geometry;
 
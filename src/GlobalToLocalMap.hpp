@@ -0,0 +1,128 @@
+/**
+ * GlobalToLocalMap.hpp
+ *
+ * EPCC, The University of Edinburgh
+ *
+ * (c) 2022 The University of Edinburgh
+ *
+ * Contributing Authors:
+ * Christodoulos Stylianou (c.stylianou@ed.ac.uk)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef GLOBALTOLOCALMAP_HPP
+#define GLOBALTOLOCALMAP_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <utility>
+#include <vector>
+#include "Geometry.hpp"
+
+/*!
+  Maps the global row ids of the rows owned by this process to their local
+  ids. When the local rows are the box of a Geometry, numbered x fastest as in
+  GenerateProblem, the mapping is computed from the box and stores nothing.
+  Any other partition inserts its rows, which are kept sorted by global id
+  and searched.
+ */
+class GlobalToLocalMap {
+ public:
+  GlobalToLocalMap() : nx(0), ny(0), nz(0), sorted(true) {}
+
+  //! Switches to the arithmetic mapping of the local box of geom
+  void setBox(const Geometry& geom) {
+    nx   = geom.nx;
+    ny   = geom.ny;
+    nz   = geom.nz;
+    gnx  = geom.gnx;
+    gny  = geom.gny;
+    gix0 = geom.gix0;
+    giy0 = geom.giy0;
+    giz0 = geom.giz0;
+    std::vector<Entry>().swap(entries);
+    sorted = true;
+  }
+
+  //! Adds a row of a general partition, any order is allowed
+  void insert(global_int_t globalRow, local_int_t localRow) {
+    if (isArithmetic()) return;
+    if (!entries.empty() && entries.back().first >= globalRow) sorted = false;
+    entries.push_back(Entry(globalRow, localRow));
+  }
+
+  //! Sorts the inserted rows, to be called before any concurrent lookups
+  void finalize() {
+    if (!sorted) std::sort(entries.begin(), entries.end());
+    sorted = true;
+  }
+
+  //! Local id of globalRow, or -1 when this process does not own it
+  local_int_t operator[](global_int_t globalRow) const {
+    if (isArithmetic()) {
+      const global_int_t ix = globalRow % gnx - gix0;
+      const global_int_t iy = (globalRow / gnx) % gny - giy0;
+      const global_int_t iz = globalRow / (gnx * gny) - giz0;
+      if (ix < 0 || ix >= nx || iy < 0 || iy >= ny || iz < 0 || iz >= nz) {
+        return -1;
+      }
+      return (local_int_t)((iz * ny + iy) * nx + ix);
+    }
+
+    if (!sorted) {
+      // Only until finalize, e.g. for debug output during the generation
+      for (std::size_t i = 0; i < entries.size(); ++i) {
+        if (entries[i].first == globalRow) return entries[i].second;
+      }
+      return -1;
+    }
+    std::vector<Entry>::const_iterator it = std::lower_bound(
+        entries.begin(), entries.end(), Entry(globalRow, local_int_t(0)),
+        CompareGlobal());
+    if (it == entries.end() || it->first != globalRow) return -1;
+    return it->second;
+  }
+
+  bool isArithmetic() const { return nx > 0; }
+
+  //! Number of rows in the map
+  local_int_t size() const {
+    return isArithmetic() ? nx * ny * nz : (local_int_t)entries.size();
+  }
+
+  //! Bytes held by the inserted rows
+  double memory() const { return entries.capacity() * sizeof(Entry); }
+
+  //! Releases the inserted rows and the box
+  void clear() {
+    nx = ny = nz = 0;
+    std::vector<Entry>().swap(entries);
+    sorted = true;
+  }
+
+ private:
+  typedef std::pair<global_int_t, local_int_t> Entry;
+  struct CompareGlobal {
+    bool operator()(const Entry& a, const Entry& b) const {
+      return a.first < b.first;
+    }
+  };
+
+  local_int_t nx, ny, nz;  // Local box, nx == 0 without one
+  global_int_t gnx, gny, gix0, giy0, giz0;
+  std::vector<Entry> entries;  // General partitions only
+  bool sorted;
+};
+
+#endif  // GLOBALTOLOCALMAP_HPP
@@ -62,6 +62,25 @@
 #include "morpheus/Morpheus_MGData.hpp"
 #endif  // HPCG_WITH_MORPHEUS
 
+// How the coarse operator of a level is built: generated on the coarse grid,
+// or the Galerkin product R A P with injection, or with trilinear
+// interpolation P and full weighting R = P^T
+constexpr int HPCG_GEOMETRIC_COARSE        = 0;
+constexpr int HPCG_GALERKIN_INJECTION      = 1;
+constexpr int HPCG_GALERKIN_FULL_WEIGHTING = 2;
+
+/*!
+  Transfer operator between two levels in CSR, row i holds the entries
+  rowStart[i] to rowStart[i + 1] - 1.
+ */
+struct Transfer_STRUCT {
+  local_int_t numberOfRows;
+  local_int_t* rowStart;
+  local_int_t* columns;
+  double* values;
+};
+typedef struct Transfer_STRUCT Transfer;
+
 struct MGData_STRUCT {
   int numberOfPresmootherSteps;   // Call ComputeSYMGS this many times prior to
                                   // coarsening
@@ -72,6 +91,12 @@ struct MGData_STRUCT {
   Vector* rc;                // coarse grid residual vector
   Vector* xc;                // coarse grid solution vector
   Vector* Axf;               // fine grid residual vector
+  int coarseOperator;  //!< How the coarse operator was built, one of the
+                       //!< HPCG_GEOMETRIC_COARSE or HPCG_GALERKIN values
+  // Full-weighting transfers, only set for HPCG_GALERKIN_FULL_WEIGHTING
+  Transfer interpolation;  //!< P, by fine row, columns of the coarse matrix
+  Transfer restriction;    //!< P^T, by column of the coarse matrix
+  Vector* rcOverlap;  //!< Coarse residual with the partial sums of the halo
   /*!
    This is for storing optimized data structres created in OptimizeProblem and
    used inside optimized ComputeSPMV().
@@ -99,10 +124,26 @@ inline void InitializeMGData(local_int_t* f2cOperator, Vector* rc, Vector* xc,
   data.rc                        = rc;
   data.xc                        = xc;
   data.Axf                       = Axf;
+  data.coarseOperator            = HPCG_GEOMETRIC_COARSE;
+  data.interpolation             = Transfer();
+  data.restriction               = Transfer();
+  data.rcOverlap                 = 0;
   data.optimizationData          = 0;
   return;
 }
 
+/*!
+ Deallocates the arrays of a transfer operator.
+
+ @param[inout] transfer the transfer operator whose storage is deallocated
+ */
+inline void DeleteTransfer(Transfer& transfer) {
+  delete[] transfer.rowStart;
+  delete[] transfer.columns;
+  delete[] transfer.values;
+  transfer = Transfer();
+}
+
 /*!
  Destructor for the CG vectors data.
 
@@ -116,6 +157,12 @@ inline void DeleteMGData(MGData& data) {
   delete data.Axf;
   delete data.rc;
   delete data.xc;
+  DeleteTransfer(data.interpolation);
+  DeleteTransfer(data.restriction);
+  if (data.rcOverlap) {
+    DeleteVector(*data.rcOverlap);
+    delete data.rcOverlap;
+  }
 
 #ifdef HPCG_WITH_MORPHEUS
   if (data.optimizationData) {
@@ -0,0 +1,144 @@
+/**
+ * MultiVector.hpp
+ *
+ * EPCC, The University of Edinburgh
+ *
+ * (c) 2022 The University of Edinburgh
+ *
+ * Contributing Authors:
+ * Christodoulos Stylianou (c.stylianou@ed.ac.uk)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*!
+ @file MultiVector.hpp
+
+ HPCG data structures for blocks of dense vectors
+ */
+
+#ifndef MULTIVECTOR_HPP
+#define MULTIVECTOR_HPP
+#include <cassert>
+#include <cstdlib>
+#include "Geometry.hpp"
+#include "Vector.hpp"
+
+struct MultiVector_STRUCT {
+  local_int_t localLength;  //!< length of local portion of each vector
+  int numberOfVectors;      //!< number of vectors (columns) in the block
+  double* values;  //!< array of values, interleaved such that entry i of
+                   //!< vector v is stored at values[i * numberOfVectors + v]
+  double* sendBuffer;  //!< halo entries of all vectors packed by ExchangeHalo
+  local_int_t sendBufferLength;  //!< number of entries sendBuffer can hold
+  /*!
+   This is for storing optimized data structures created in OptimizeProblem and
+   used inside optimized ComputeSPMM().
+   */
+  void* optimizationData;
+};
+typedef struct MultiVector_STRUCT MultiVector;
+
+/*!
+  Initializes input multi-vector.
+
+  @param[in] V
+  @param[in] localLength Length of local portion of each vector
+  @param[in] numberOfVectors Number of vectors in the block
+ */
+inline void InitializeMultiVector(MultiVector& V, local_int_t localLength,
+                                  int numberOfVectors) {
+  V.localLength      = localLength;
+  V.numberOfVectors  = numberOfVectors;
+  V.values           = new double[localLength * numberOfVectors];
+  V.sendBuffer       = 0;
+  V.sendBufferLength = 0;
+  V.optimizationData = 0;
+  return;
+}
+
+/*!
+  Fill the input multi-vector with zero values.
+
+  @param[inout] V - On entrance V is initialized, on exit all its values are
+  zero.
+ */
+inline void ZeroMultiVector(MultiVector& V) {
+  local_int_t length = V.localLength * V.numberOfVectors;
+  double* vv         = V.values;
+  for (local_int_t i = 0; i < length; ++i) vv[i] = 0.0;
+  return;
+}
+
+/*!
+  Copy a vector into one column of a multi-vector.
+
+  @param[in] v Input vector
+  @param[inout] V Output multi-vector
+  @param[in] column The column of V to be overwritten
+ */
+inline void CopyVectorToMultiVector(const Vector& v, MultiVector& V,
+                                    int column) {
+  assert(column >= 0 && column < V.numberOfVectors);
+  assert(V.localLength >= v.localLength);
+  const int k = V.numberOfVectors;
+  double* vv  = v.values;
+  double* Vv  = V.values;
+  for (local_int_t i = 0; i < v.localLength; ++i) Vv[i * k + column] = vv[i];
+  return;
+}
+
+/*!
+  Copy one column of a multi-vector into a vector.
+
+  @param[in] V Input multi-vector
+  @param[in] column The column of V to be copied
+  @param[inout] v Output vector
+ */
+inline void CopyMultiVectorToVector(const MultiVector& V, int column,
+                                    Vector& v) {
+  assert(column >= 0 && column < V.numberOfVectors);
+  assert(v.localLength >= V.localLength);
+  const int k = V.numberOfVectors;
+  double* vv  = v.values;
+  double* Vv  = V.values;
+  for (local_int_t i = 0; i < V.localLength; ++i) vv[i] = Vv[i * k + column];
+  return;
+}
+
+/*!
+  Deallocates the members of the data structure of the multi-vector
+  provided they are not 0.
+
+  @param[in] V the multi-vector
+ */
+inline void DeleteMultiVector(MultiVector& V) {
+  delete[] V.values;
+  delete[] V.sendBuffer;
+  V.sendBuffer       = 0;
+  V.sendBufferLength = 0;
+  V.localLength      = 0;
+  V.numberOfVectors  = 0;
+
+#ifdef HPCG_WITH_MORPHEUS
+  if (V.optimizationData) {
+    using Vector_t = HPCG_Morpheus_Vec<Morpheus::value_type>;
+    delete (Vector_t*)V.optimizationData;
+    V.optimizationData = nullptr;
+  }
+#endif
+
+  return;
+}
+
+#endif  // MULTIVECTOR_HPP
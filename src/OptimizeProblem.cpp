@@ -56,11 +56,14 @@
 #include "Geometry.hpp"
 
 #ifdef HPCG_WITH_MORPHEUS
+#include "SetupProfile.hpp"
 #include "morpheus/Morpheus_SparseMatrixRoutines.hpp"
 #include "morpheus/Morpheus_VectorRoutines.hpp"
 #include "morpheus/Morpheus_MGDataRoutines.hpp"
 #include "morpheus/Morpheus_ReadHpcgDat.hpp"
 #include "morpheus/Morpheus_Timer.hpp"
+#include "morpheus/Morpheus_NUMA.hpp"
+#include "morpheus/Morpheus_LeanMode.hpp"
 
 #if defined(HPCG_DEBUG)
 #include "morpheus/Morpheus_IO.hpp"
@@ -70,6 +73,13 @@ std::vector<format_report> local_morpheus_report, local_sub_report;
 #if defined(HPCG_WITH_SPLIT_DISTRIBUTED)
 std::vector<format_report> ghost_morpheus_report, ghost_sub_report;
 #endif  // HPCG_WITH_SPLIT_DISTRIBUTED
+#if defined(HPCG_WITH_HYBRID_LOCAL)
+std::vector<format_report> interior_morpheus_report, interior_sub_report;
+std::vector<format_report> boundary_morpheus_report, boundary_sub_report;
+#endif  // HPCG_WITH_HYBRID_LOCAL
+#if defined(HPCG_WITH_BLOCK_FORMATS)
+std::vector<format_report> block_morpheus_report, block_sub_report;
+#endif  // HPCG_WITH_BLOCK_FORMATS
 
 #if defined(HPCG_WITH_MULTI_FORMATS)
 std::vector<morpheus_timers> mtimers, sub_mtimers;
@@ -102,10 +112,12 @@ void multicolor(SparseMatrix& A);
 int OptimizeProblem(SparseMatrix& A, CGData& data, Vector& b, Vector& x,
                     Vector& xexact) {
 #ifdef HPCG_WITH_MORPHEUS
+  StartSetupPhase("Convert matrix level 0");
   MorpheusInitializeSparseMatrix(A);
   MorpheusSparseMatrixSetCoarseLevel(A, 0);
   MorpheusSparseMatrixSetRank(A);
   MorpheusOptimizeSparseMatrix(A);
+  StopSetupPhase();
 
 #if defined(HPCG_DEBUG) || defined(HPCG_DETAILED_DEBUG)
   SparseMatrixWrite(A);
@@ -116,15 +128,26 @@ int OptimizeProblem(SparseMatrix& A, CGData& data, Vector& b, Vector& x,
 #if defined(HPCG_WITH_SPLIT_DISTRIBUTED)
   ghost_sub_report.push_back(MorpheusSparseMatrixGetGhostProperties(A));
 #endif  // HPCG_WITH_SPLIT_DISTRIBUTED
+#if defined(HPCG_WITH_HYBRID_LOCAL)
+  interior_sub_report.push_back(MorpheusSparseMatrixGetInteriorProperties(A));
+  boundary_sub_report.push_back(MorpheusSparseMatrixGetBoundaryProperties(A));
+#endif  // HPCG_WITH_HYBRID_LOCAL
+#if defined(HPCG_WITH_BLOCK_FORMATS)
+  for (int b = 0; b < MorpheusSparseMatrixGetNumberOfBlocks(A); b++) {
+    block_sub_report.push_back(MorpheusSparseMatrixGetBlockProperties(A, b));
+  }
+#endif  // HPCG_WITH_BLOCK_FORMATS
 
   int levels = 1;
   // Process all coarse level matrices
   SparseMatrix* M = A.Ac;
   while (M != 0) {
+    StartSetupPhase("Convert matrix level " + std::to_string(levels));
     MorpheusInitializeSparseMatrix(*M);
     MorpheusSparseMatrixSetCoarseLevel(*M, levels++);
     MorpheusSparseMatrixSetRank(*M);
     MorpheusOptimizeSparseMatrix(*M);
+    StopSetupPhase();
 
 #if defined(HPCG_DEBUG) || defined(HPCG_DETAILED_DEBUG)
     int clvl = MorpheusSparseMatrixGetCoarseLevel(*M);
@@ -136,6 +159,18 @@ int OptimizeProblem(SparseMatrix& A, CGData& data, Vector& b, Vector& x,
 #if defined(HPCG_WITH_SPLIT_DISTRIBUTED)
     ghost_sub_report.push_back(MorpheusSparseMatrixGetGhostProperties(*M));
 #endif  // HPCG_WITH_SPLIT_DISTRIBUTED
+#if defined(HPCG_WITH_HYBRID_LOCAL)
+    interior_sub_report.push_back(
+        MorpheusSparseMatrixGetInteriorProperties(*M));
+    boundary_sub_report.push_back(
+        MorpheusSparseMatrixGetBoundaryProperties(*M));
+#endif  // HPCG_WITH_HYBRID_LOCAL
+#if defined(HPCG_WITH_BLOCK_FORMATS)
+    for (int b = 0; b < MorpheusSparseMatrixGetNumberOfBlocks(*M); b++) {
+      block_sub_report.push_back(
+          MorpheusSparseMatrixGetBlockProperties(*M, b));
+    }
+#endif  // HPCG_WITH_BLOCK_FORMATS
 
     // Go to next level in hierarchy
     M = M->Ac;
@@ -143,6 +178,7 @@ int OptimizeProblem(SparseMatrix& A, CGData& data, Vector& b, Vector& x,
 
   M          = &A;
   MGData* mg = M->mgData;
+  StartSetupPhase("Convert MG data");
   while (mg != 0) {
     M = M->Ac;
     MorpheusInitializeMGData(*mg);
@@ -150,6 +186,7 @@ int OptimizeProblem(SparseMatrix& A, CGData& data, Vector& b, Vector& x,
 
     mg = M->mgData;
   }
+  StopSetupPhase();
 
 #ifdef HPCG_WITH_MULTI_FORMATS
   // Local timers
@@ -175,6 +212,17 @@ int OptimizeProblem(SparseMatrix& A, CGData& data, Vector& b, Vector& x,
   }
 #endif  // HPCG_WITH_SPLIT_DISTRIBUTED
 
+#if defined(HPCG_WITH_HYBRID_LOCAL)
+  if (A.geom->rank == 0) {
+    interior_morpheus_report.resize(A.geom->size * levels);
+    boundary_morpheus_report.resize(A.geom->size * levels);
+  } else {
+    interior_morpheus_report.resize(0);
+    boundary_morpheus_report.resize(0);
+  }
+#endif  // HPCG_WITH_HYBRID_LOCAL
+
+  StartSetupPhase("Convert vectors");
   MorpheusInitializeVector(b);
   MorpheusInitializeVector(x);
   MorpheusInitializeVector(xexact);
@@ -190,12 +238,23 @@ int OptimizeProblem(SparseMatrix& A, CGData& data, Vector& b, Vector& x,
   MorpheusOptimizeVector(data.z);
   MorpheusOptimizeVector(data.p);
   MorpheusOptimizeVector(data.Ap);
+  StopSetupPhase();
+
+#if defined(HPCG_WITH_NUMA_FIRST_TOUCH)
+  // Ap is overwritten before its first use in CG
+  MorpheusMeasureNumaBandwidth(b, xexact, data.Ap);
+#endif  // HPCG_WITH_NUMA_FIRST_TOUCH
 #endif  // HPCG_WITH_MORPHEUS
 
 #if defined(HPCG_USE_MULTICOLORING)
   multicolor(A);
 #endif  // HPCG_USE_MULTICOLORING
 
+#ifdef HPCG_WITH_MORPHEUS
+  // Only the Morpheus matrices are read from here on
+  MorpheusReleaseReferenceMatrix(A);
+#endif  // HPCG_WITH_MORPHEUS
+
   return 0;
 }
 
@@ -205,7 +264,7 @@ double OptimizeProblemMemoryUse(const SparseMatrix& A) {
 #ifdef HPCG_WITH_MORPHEUS
   fnbytes += MorpheusSparseMatrixGetLocalProperties(A).memory;
 #if defined(HPCG_WITH_SPLIT_DISTRIBUTED)
-  fnbytes += MorpheusSparseMatrixGetLocalProperties(A).memory;
+  fnbytes += MorpheusSparseMatrixGetGhostProperties(A).memory;
 #endif
 #endif  // HPCG_WITH_MORPHEUS
 
@@ -0,0 +1,591 @@
+/**
+ * ProblemCheckpoint.cpp
+ *
+ * EPCC, The University of Edinburgh
+ *
+ * (c) 2022 The University of Edinburgh
+ *
+ * Contributing Authors:
+ * Christodoulos Stylianou (c.stylianou@ed.ac.uk)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*!
+ @file ProblemCheckpoint.cpp
+
+ HPCG routines to store and restore the problem hierarchy
+ */
+
+#ifndef HPCG_NO_MPI
+#include <mpi.h>
+#endif
+
+#ifndef HPCG_NO_OPENMP
+#include <omp.h>
+#endif
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <vector>
+
+#include "hpcg.hpp"
+#include "GenerateGalerkinProblem.hpp"
+#include "ProblemCheckpoint.hpp"
+
+namespace {
+const char checkpoint_magic[8] = "HPCGCKP";
+const int checkpoint_version   = 3;
+
+// Raw layout of a checkpoint: the header, then for every level from the finest
+// its record followed by its arrays, and finally the vectors of the finest
+// level. The arrays of a level are partz_ids and partz_nz, nonzerosInRow, the
+// position of the diagonal in each row, the packed mtxIndG, mtxIndL and
+// matrixValues rows, localToGlobalMap, the halo lists when built with MPI and
+// the fine-to-coarse operator into the level for coarse levels.
+typedef struct checkpoint_header {
+  char magic[8];
+  int version;
+  int index_size;
+  int global_size;
+  int value_size;
+  int halo;  // Whether the levels carry the MPI halo lists
+  int size;
+  int rank;
+  int numberOfLevels;
+  int coarseOperator;  // How the coarse operators were built
+  long long bytes;     // Size of the whole file
+} checkpoint_header;
+
+typedef struct checkpoint_level {
+  long long nx, ny, nz, npx, npy, npz, pz, npartz, ipx, ipy, ipz;
+  long long gnx, gny, gnz, gix0, giy0, giz0;
+  long long totalNumberOfRows, totalNumberOfNonzeros;
+  long long localNumberOfRows, localNumberOfColumns, localNumberOfNonzeros;
+  long long numberOfExternalValues, numberOfSendNeighbors, totalToBeSent;
+  long long arithmeticMap;  // Whether globalToLocalMap maps the local box
+  long long points, variable;  // The stencil of the generated operator
+  double ax, ay, az;
+} checkpoint_level;
+
+// Where the arrays of a level start in the mapped file
+typedef struct level_view {
+  checkpoint_level info;
+  const char* partz_ids;
+  const char* partz_nz;
+  const char* nonzerosInRow;
+  const char* diagonal;
+  const char* mtxIndG;
+  const char* mtxIndL;
+  const char* matrixValues;
+  const char* localToGlobalMap;
+  const char* elementsToSend;
+  const char* neighbors;
+  const char* receiveLength;
+  const char* sendLength;
+  const char* f2cOperator;
+} level_view;
+
+std::string CheckpointPath(const std::string& prefix, int rank) {
+  std::stringstream path;
+  path << prefix << "-" << rank << ".bin";
+  return path.str();
+}
+
+// Hands out consecutive arrays of a mapped file, failing once one of them
+// would run past its end
+class CheckpointReader {
+ public:
+  CheckpointReader(const char* data, size_t size)
+      : cur(data), end(data + size), good(true) {}
+
+  template <typename T>
+  const char* take(long long count) {
+    if (!good || count < 0 ||
+        (size_t)count > (size_t)(end - cur) / sizeof(T)) {
+      good = false;
+      return 0;
+    }
+    const char* p = cur;
+    cur += count * sizeof(T);
+    return p;
+  }
+
+  bool ok() const { return good; }
+  bool atEnd() const { return good && cur == end; }
+
+ private:
+  const char* cur;
+  const char* end;
+  bool good;
+};
+
+template <typename T>
+void WriteArray(std::ofstream& out, const T* data, long long count) {
+  if (count > 0) out.write((const char*)data, count * sizeof(T));
+}
+
+void WriteLevel(std::ofstream& out, const SparseMatrix& A,
+                const local_int_t* f2cOperator) {
+  const Geometry& geom = *A.geom;
+  const local_int_t n  = A.localNumberOfRows;
+
+  checkpoint_level l = {};
+  l.nx               = geom.nx;
+  l.ny               = geom.ny;
+  l.nz               = geom.nz;
+  l.npx              = geom.npx;
+  l.npy              = geom.npy;
+  l.npz              = geom.npz;
+  l.pz               = geom.pz;
+  l.npartz           = geom.npartz;
+  l.ipx              = geom.ipx;
+  l.ipy              = geom.ipy;
+  l.ipz              = geom.ipz;
+  l.gnx              = geom.gnx;
+  l.gny              = geom.gny;
+  l.gnz              = geom.gnz;
+  l.gix0             = geom.gix0;
+  l.giy0             = geom.giy0;
+  l.giz0             = geom.giz0;
+  l.points           = geom.stencil.points;
+  l.variable         = geom.stencil.variable;
+  l.ax               = geom.stencil.ax;
+  l.ay               = geom.stencil.ay;
+  l.az               = geom.stencil.az;
+
+  l.totalNumberOfRows     = A.totalNumberOfRows;
+  l.totalNumberOfNonzeros = A.totalNumberOfNonzeros;
+  l.localNumberOfRows     = A.localNumberOfRows;
+  l.localNumberOfColumns  = A.localNumberOfColumns;
+  l.localNumberOfNonzeros = A.localNumberOfNonzeros;
+#ifndef HPCG_NO_MPI
+  l.numberOfExternalValues = A.numberOfExternalValues;
+  l.numberOfSendNeighbors  = A.numberOfSendNeighbors;
+  l.totalToBeSent          = A.totalToBeSent;
+#endif
+  l.arithmeticMap = A.globalToLocalMap.isArithmetic();
+  out.write((const char*)&l, sizeof(checkpoint_level));
+
+  WriteArray(out, geom.partz_ids, geom.npartz);
+  WriteArray(out, geom.partz_nz, geom.npartz);
+  WriteArray(out, A.nonzerosInRow, n);
+  for (local_int_t i = 0; i < n; ++i) {
+    const char diagonal = (char)(A.matrixDiagonal[i] - A.matrixValues[i]);
+    out.write(&diagonal, 1);
+  }
+  for (local_int_t i = 0; i < n; ++i)
+    WriteArray(out, A.mtxIndG[i], A.nonzerosInRow[i]);
+  for (local_int_t i = 0; i < n; ++i)
+    WriteArray(out, A.mtxIndL[i], A.nonzerosInRow[i]);
+  for (local_int_t i = 0; i < n; ++i)
+    WriteArray(out, A.matrixValues[i], A.nonzerosInRow[i]);
+  WriteArray(out, A.localToGlobalMap.data(), n);
+#ifndef HPCG_NO_MPI
+  WriteArray(out, A.elementsToSend, A.totalToBeSent);
+  WriteArray(out, A.neighbors, A.numberOfSendNeighbors);
+  WriteArray(out, A.receiveLength, A.numberOfSendNeighbors);
+  WriteArray(out, A.sendLength, A.numberOfSendNeighbors);
+#endif
+  if (f2cOperator) WriteArray(out, f2cOperator, n);
+}
+
+// Locates the arrays of the next level, checking that its record is
+// consistent and that its rows fit the layout of the generated matrices
+bool ReadLevel(CheckpointReader& in, bool coarse, int halo, level_view& v) {
+  const char* record = in.take<checkpoint_level>(1);
+  if (!record) return false;
+  std::memcpy(&v.info, record, sizeof(checkpoint_level));
+  const checkpoint_level& l = v.info;
+
+  const long long n = l.localNumberOfRows;
+  if (l.nx <= 0 || l.ny <= 0 || l.nz <= 0 || n != l.nx * l.ny * l.nz ||
+      l.localNumberOfColumns < n || l.npartz < 0 ||
+      (l.points != 7 && l.points != 27)) {
+    return false;
+  }
+
+  v.partz_ids        = in.take<int>(l.npartz);
+  v.partz_nz         = in.take<local_int_t>(l.npartz);
+  v.nonzerosInRow    = in.take<char>(n);
+  v.diagonal         = in.take<char>(n);
+  v.mtxIndG          = in.take<global_int_t>(l.localNumberOfNonzeros);
+  v.mtxIndL          = in.take<local_int_t>(l.localNumberOfNonzeros);
+  v.matrixValues     = in.take<double>(l.localNumberOfNonzeros);
+  v.localToGlobalMap = in.take<global_int_t>(n);
+  v.elementsToSend   = in.take<local_int_t>(halo ? l.totalToBeSent : 0);
+  v.neighbors        = in.take<int>(halo ? l.numberOfSendNeighbors : 0);
+  v.receiveLength    = in.take<local_int_t>(halo ? l.numberOfSendNeighbors : 0);
+  v.sendLength       = in.take<local_int_t>(halo ? l.numberOfSendNeighbors : 0);
+  v.f2cOperator      = in.take<local_int_t>(coarse ? n : 0);
+  if (!in.ok()) return false;
+
+  long long nonzeros = 0;
+  for (long long i = 0; i < n; ++i) {
+    const char nnz = v.nonzerosInRow[i];
+    if (nnz <= 0 || nnz > l.points || v.diagonal[i] < 0 ||
+        v.diagonal[i] >= nnz) {
+      return false;
+    }
+    nonzeros += nnz;
+  }
+  return nonzeros == l.localNumberOfNonzeros;
+}
+
+bool SameGeometry(const Geometry& geom, const level_view& v) {
+  const checkpoint_level& l = v.info;
+  bool same = geom.nx == l.nx && geom.ny == l.ny && geom.nz == l.nz &&
+              geom.npx == l.npx && geom.npy == l.npy && geom.npz == l.npz &&
+              geom.pz == l.pz && geom.npartz == l.npartz &&
+              geom.ipx == l.ipx && geom.ipy == l.ipy && geom.ipz == l.ipz &&
+              geom.gnx == l.gnx && geom.gny == l.gny && geom.gnz == l.gnz &&
+              geom.gix0 == l.gix0 && geom.giy0 == l.giy0 &&
+              geom.giz0 == l.giz0 && geom.stencil.points == l.points &&
+              geom.stencil.variable == l.variable &&
+              geom.stencil.ax == l.ax && geom.stencil.ay == l.ay &&
+              geom.stencil.az == l.az;
+  for (int i = 0; same && i < geom.npartz; ++i) {
+    int id;
+    local_int_t nz;
+    std::memcpy(&id, v.partz_ids + i * sizeof(int), sizeof(int));
+    std::memcpy(&nz, v.partz_nz + i * sizeof(local_int_t), sizeof(local_int_t));
+    same = geom.partz_ids[i] == id && geom.partz_nz[i] == nz;
+  }
+  return same;
+}
+
+Geometry* RestoreGeometry(const Geometry& geomf, const level_view& v) {
+  const checkpoint_level& l = v.info;
+  Geometry* geom            = new Geometry;
+
+  geom->size       = geomf.size;
+  geom->rank       = geomf.rank;
+  geom->numThreads = geomf.numThreads;
+  geom->nx         = l.nx;
+  geom->ny         = l.ny;
+  geom->nz         = l.nz;
+  geom->npx        = l.npx;
+  geom->npy        = l.npy;
+  geom->npz        = l.npz;
+  geom->pz         = l.pz;
+  geom->npartz     = l.npartz;
+  geom->partz_ids  = new int[l.npartz];
+  geom->partz_nz   = new local_int_t[l.npartz];
+  std::memcpy(geom->partz_ids, v.partz_ids, l.npartz * sizeof(int));
+  std::memcpy(geom->partz_nz, v.partz_nz, l.npartz * sizeof(local_int_t));
+  geom->ipx  = l.ipx;
+  geom->ipy  = l.ipy;
+  geom->ipz  = l.ipz;
+  geom->gnx  = l.gnx;
+  geom->gny  = l.gny;
+  geom->gnz  = l.gnz;
+  geom->gix0 = l.gix0;
+  geom->giy0 = l.giy0;
+  geom->giz0 = l.giz0;
+
+  geom->stencil.points   = l.points;
+  geom->stencil.variable = l.variable;
+  geom->stencil.ax       = l.ax;
+  geom->stencil.ay       = l.ay;
+  geom->stencil.az       = l.az;
+  return geom;
+}
+
+// Copies a level out of the mapped file into the data structures that
+// GenerateProblem and SetupHalo would have produced
+void RestoreLevel(const level_view& v, SparseMatrix& A) {
+  const checkpoint_level& l = v.info;
+  const local_int_t n       = l.localNumberOfRows;
+  // Rows are allocated with room for a full stencil, as GenerateProblem does
+  const local_int_t rowStride = l.points;
+
+  A.totalNumberOfRows     = l.totalNumberOfRows;
+  A.totalNumberOfNonzeros = l.totalNumberOfNonzeros;
+  A.localNumberOfRows     = n;
+  A.localNumberOfColumns  = l.localNumberOfColumns;
+  A.localNumberOfNonzeros = l.localNumberOfNonzeros;
+
+  A.nonzerosInRow  = new char[n];
+  A.mtxIndG        = new global_int_t*[n];
+  A.mtxIndL        = new local_int_t*[n];
+  A.matrixValues   = new double*[n];
+  A.matrixDiagonal = new double*[n];
+  std::memcpy(A.nonzerosInRow, v.nonzerosInRow, n);
+
+  // Packed position of the first nonzero of every row
+  std::vector<local_int_t> rowStart(n + 1, 0);
+  for (local_int_t i = 0; i < n; ++i)
+    rowStart[i + 1] = rowStart[i] + A.nonzerosInRow[i];
+
+#ifdef HPCG_CONTIGUOUS_ARRAYS
+  global_int_t* indG = new global_int_t[n * rowStride];
+  local_int_t* indL  = new local_int_t[n * rowStride];
+  double* values     = new double[n * rowStride];
+#endif
+
+  // Rows are copied by the threads that use them, as they are generated
+#ifndef HPCG_NO_OPENMP
+#pragma omp parallel for
+#endif
+  for (local_int_t i = 0; i < n; ++i) {
+#ifndef HPCG_CONTIGUOUS_ARRAYS
+    A.mtxIndG[i]      = new global_int_t[rowStride];
+    A.mtxIndL[i]      = new local_int_t[rowStride];
+    A.matrixValues[i] = new double[rowStride];
+#else
+    A.mtxIndG[i]      = indG + i * rowStride;
+    A.mtxIndL[i]      = indL + i * rowStride;
+    A.matrixValues[i] = values + i * rowStride;
+#endif
+    const local_int_t nnz = A.nonzerosInRow[i];
+    std::memcpy(A.mtxIndG[i], v.mtxIndG + rowStart[i] * sizeof(global_int_t),
+                nnz * sizeof(global_int_t));
+    std::memcpy(A.mtxIndL[i], v.mtxIndL + rowStart[i] * sizeof(local_int_t),
+                nnz * sizeof(local_int_t));
+    std::memcpy(A.matrixValues[i],
+                v.matrixValues + rowStart[i] * sizeof(double),
+                nnz * sizeof(double));
+    A.matrixDiagonal[i] = A.matrixValues[i] + v.diagonal[i];
+  }
+
+  A.localToGlobalMap.resize(n);
+  std::memcpy(A.localToGlobalMap.data(), v.localToGlobalMap,
+              n * sizeof(global_int_t));
+  if (l.arithmeticMap) {
+    A.globalToLocalMap.setBox(*A.geom);
+  } else {
+    for (local_int_t i = 0; i < n; ++i)
+      A.globalToLocalMap.insert(A.localToGlobalMap[i], i);
+    A.globalToLocalMap.finalize();
+  }
+
+#ifndef HPCG_NO_MPI
+  A.numberOfExternalValues = l.numberOfExternalValues;
+  A.numberOfSendNeighbors  = l.numberOfSendNeighbors;
+  A.totalToBeSent          = l.totalToBeSent;
+  A.elementsToSend         = new local_int_t[A.totalToBeSent];
+  A.neighbors              = new int[A.numberOfSendNeighbors];
+  A.receiveLength          = new local_int_t[A.numberOfSendNeighbors];
+  A.sendLength             = new local_int_t[A.numberOfSendNeighbors];
+  A.sendBuffer             = new double[A.totalToBeSent];
+  std::memcpy(A.elementsToSend, v.elementsToSend,
+              A.totalToBeSent * sizeof(local_int_t));
+  std::memcpy(A.neighbors, v.neighbors, A.numberOfSendNeighbors * sizeof(int));
+  std::memcpy(A.receiveLength, v.receiveLength,
+              A.numberOfSendNeighbors * sizeof(local_int_t));
+  std::memcpy(A.sendLength, v.sendLength,
+              A.numberOfSendNeighbors * sizeof(local_int_t));
+#endif
+}
+
+void RestoreVector(const char* data, local_int_t n, Vector& v) {
+  InitializeVector(v, n);
+  std::memcpy(v.values, data, n * sizeof(double));
+}
+}  // namespace
+
+/*!
+  Writes the problem hierarchy of this process, as left by GenerateProblem,
+  SetupHalo and GenerateCoarseProblems, to the file prefix-<rank>.bin.
+
+  @param[in] prefix The path of the checkpoint files, without the rank suffix
+  @param[in] A      The known system matrix, with its coarse levels
+  @param[in] b      The right hand side vector
+  @param[in] x      The initial guess
+  @param[in] xexact The exact solution
+
+  @return Returns zero on success and a non-zero value otherwise.
+
+  @see LoadProblem
+*/
+int SaveProblem(const std::string& prefix, const SparseMatrix& A,
+                const Vector& b, const Vector& x, const Vector& xexact) {
+  checkpoint_header h = {};
+  std::memcpy(h.magic, checkpoint_magic, sizeof(checkpoint_magic));
+  h.version     = checkpoint_version;
+  h.index_size  = sizeof(local_int_t);
+  h.global_size = sizeof(global_int_t);
+  h.value_size  = sizeof(double);
+#ifndef HPCG_NO_MPI
+  h.halo = 1;
+#endif
+  h.size           = A.geom->size;
+  h.rank           = A.geom->rank;
+  h.numberOfLevels = 0;
+  for (const SparseMatrix* level = &A; level; level = level->Ac)
+    ++h.numberOfLevels;
+  h.coarseOperator = A.mgData ? A.mgData->coarseOperator : 0;
+
+  const std::string path = CheckpointPath(prefix, A.geom->rank);
+  const std::string tmp  = path + ".tmp";
+
+  std::ofstream out(tmp.c_str(), std::ios::binary);
+  out.write((const char*)&h, sizeof(checkpoint_header));
+  const local_int_t* f2cOperator = 0;
+  for (const SparseMatrix* level = &A; level; level = level->Ac) {
+    WriteLevel(out, *level, f2cOperator);
+    if (level->mgData) f2cOperator = level->mgData->f2cOperator;
+  }
+  WriteArray(out, b.values, b.localLength);
+  WriteArray(out, x.values, x.localLength);
+  WriteArray(out, xexact.values, xexact.localLength);
+
+  // The header is completed once the size of the file is known
+  h.bytes = out.tellp();
+  out.seekp(0);
+  out.write((const char*)&h, sizeof(checkpoint_header));
+  out.close();
+
+  // Readers only ever see complete checkpoints
+  if (!out || std::rename(tmp.c_str(), path.c_str()) != 0) {
+    std::remove(tmp.c_str());
+    return 1;
+  }
+  return 0;
+}
+
+/*!
+  Restores the problem hierarchy saved by SaveProblem in place of generating
+  it: the matrices of all levels with their halo lists, the fine-to-coarse
+  operators and the vectors. The full-weighting transfers of Galerkin coarse
+  operators are rebuilt from the matrices. The file is mapped and checked against the
+  geometry of A and the build before anything is allocated, and all processes
+  load or none does.
+
+  @param[in]    prefix           The path of the checkpoint files, without the
+                                 rank suffix
+  @param[in]    numberOfMgLevels The number of levels including the finest
+  @param[in]    coarseOperator   How the coarse operators have to be built
+  @param[inout] A                The known system matrix, initialized with its
+                                 geometry. On success, it and its coarse levels
+                                 are set up as by GenerateProblem, SetupHalo
+                                 and GenerateCoarseProblems.
+  @param[out]   b                The right hand side vector
+  @param[out]   x                The initial guess
+  @param[out]   xexact           The exact solution
+
+  @return Returns zero on success and a non-zero value otherwise, in which
+  case A and the vectors are left untouched.
+
+  @see SaveProblem
+*/
+int LoadProblem(const std::string& prefix, int numberOfMgLevels,
+                int coarseOperator, SparseMatrix& A, Vector& b, Vector& x,
+                Vector& xexact) {
+  const Geometry& geom   = *A.geom;
+  const std::string path = CheckpointPath(prefix, geom.rank);
+
+  void* map = MAP_FAILED;
+  struct stat st;
+  int fd = open(path.c_str(), O_RDONLY);
+  if (fd >= 0) {
+    if (fstat(fd, &st) == 0 && (size_t)st.st_size >= sizeof(checkpoint_header))
+      map = mmap(0, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+  }
+
+  std::vector<level_view> levels(numberOfMgLevels);
+  const char* vectors = 0;
+  int failed          = 1;
+#if !defined(HPCG_WITH_MORPHEUS_DIRECT_GENERATION)
+  if (map != MAP_FAILED) {
+    madvise(map, st.st_size, MADV_WILLNEED);
+    CheckpointReader in((const char*)map, st.st_size);
+    checkpoint_header h;
+    std::memcpy(&h, in.take<checkpoint_header>(1), sizeof(checkpoint_header));
+#ifndef HPCG_NO_MPI
+    const int halo = 1;
+#else
+    const int halo = 0;
+#endif
+
+    bool ok =
+        std::memcmp(h.magic, checkpoint_magic, sizeof(checkpoint_magic)) == 0 &&
+        h.version == checkpoint_version &&
+        h.index_size == (int)sizeof(local_int_t) &&
+        h.global_size == (int)sizeof(global_int_t) &&
+        h.value_size == (int)sizeof(double) && h.halo == halo &&
+        h.size == geom.size && h.rank == geom.rank &&
+        h.numberOfLevels == numberOfMgLevels &&
+        h.coarseOperator == coarseOperator && h.bytes == st.st_size;
+    for (int level = 0; ok && level < numberOfMgLevels; ++level)
+      ok = ReadLevel(in, level > 0, halo, levels[level]);
+    ok = ok && SameGeometry(geom, levels[0]);
+    if (ok) vectors = in.take<double>(3 * levels[0].info.localNumberOfRows);
+    failed = !(ok && in.atEnd());
+  }
+#endif  // !HPCG_WITH_MORPHEUS_DIRECT_GENERATION
+
+#ifndef HPCG_NO_MPI
+  int anyFailed = failed;
+  MPI_Allreduce(&failed, &anyFailed, 1, MPI_INT, MPI_MAX, MPI_COMM_WORLD);
+  failed = anyFailed;
+#endif
+
+  if (!failed) {
+    SparseMatrix* Af = &A;
+    RestoreLevel(levels[0], A);
+    for (int level = 1; level < numberOfMgLevels; ++level) {
+      SparseMatrix* Ac = new SparseMatrix;
+      InitializeSparseMatrix(*Ac, RestoreGeometry(geom, levels[level]));
+      RestoreLevel(levels[level], *Ac);
+
+      local_int_t* f2cOperator = new local_int_t[Af->localNumberOfRows];
+      std::memcpy(f2cOperator, levels[level].f2cOperator,
+                  Ac->localNumberOfRows * sizeof(local_int_t));
+      Vector* rc  = new Vector;
+      Vector* xc  = new Vector;
+      Vector* Axf = new Vector;
+      InitializeVector(*rc, Ac->localNumberOfRows);
+      InitializeVector(*xc, Ac->localNumberOfColumns);
+      InitializeVector(*Axf, Af->localNumberOfColumns);
+      Af->Ac         = Ac;
+      MGData* mgData = new MGData;
+      InitializeMGData(f2cOperator, rc, xc, Axf, *mgData);
+#ifdef HPCG_WITH_MORPHEUS
+      mgData->f2cOperator_localLength = Af->localNumberOfRows;
+#endif
+      mgData->coarseOperator = coarseOperator;
+      if (coarseOperator == HPCG_GALERKIN_FULL_WEIGHTING)
+        SetupFullWeighting(*Af, *Ac, *mgData);
+      Af->mgData = mgData;
+      Af         = Ac;
+    }
+
+    const local_int_t n = A.localNumberOfRows;
+    RestoreVector(vectors, n, b);
+    RestoreVector(vectors + n * sizeof(double), n, x);
+    RestoreVector(vectors + 2 * n * sizeof(double), n, xexact);
+  }
+
+  if (map != MAP_FAILED) munmap(map, st.st_size);
+
+  if (geom.rank == 0) {
+    if (failed) {
+      HPCG_fout << "Problem checkpoint " << prefix
+                << " is missing or does not match this run, generating the "
+                   "problem"
+                << std::endl;
+    } else {
+      HPCG_fout << "Problem loaded from checkpoint " << prefix << std::endl;
+    }
+  }
+  return failed;
+}
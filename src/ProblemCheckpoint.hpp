@@ -0,0 +1,43 @@
+/**
+ * ProblemCheckpoint.hpp
+ *
+ * EPCC, The University of Edinburgh
+ *
+ * (c) 2022 The University of Edinburgh
+ *
+ * Contributing Authors:
+ * Christodoulos Stylianou (c.stylianou@ed.ac.uk)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*!
+ @file ProblemCheckpoint.hpp
+
+ Per-process binary checkpoint of the whole problem hierarchy
+ */
+
+#ifndef PROBLEMCHECKPOINT_HPP
+#define PROBLEMCHECKPOINT_HPP
+
+#include <string>
+#include "SparseMatrix.hpp"
+#include "Vector.hpp"
+
+int SaveProblem(const std::string& prefix, const SparseMatrix& A,
+                const Vector& b, const Vector& x, const Vector& xexact);
+int LoadProblem(const std::string& prefix, int numberOfMgLevels,
+                int coarseOperator, SparseMatrix& A, Vector& b, Vector& x,
+                Vector& xexact);
+
+#endif  // PROBLEMCHECKPOINT_HPP
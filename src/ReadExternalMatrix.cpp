@@ -0,0 +1,616 @@
+/**
+ * ReadExternalMatrix.cpp
+ *
+ * EPCC, The University of Edinburgh
+ *
+ * (c) 2022 The University of Edinburgh
+ *
+ * Contributing Authors:
+ * Christodoulos Stylianou (c.stylianou@ed.ac.uk)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*!
+ @file ReadExternalMatrix.cpp
+
+ HPCG routine to read a matrix from a file instead of generating it
+ */
+
+#ifndef HPCG_NO_MPI
+#include <mpi.h>
+#endif
+
+#ifndef HPCG_NO_OPENMP
+#include <omp.h>
+#endif
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cctype>
+#include <climits>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <vector>
+
+#include "hpcg.hpp"
+#include "GenerateGeometry.hpp"
+#include "GenerateProblem.hpp"
+#include "ReadExternalMatrix.hpp"
+
+namespace {
+const char csr_magic[8]     = "HPCGCSR";
+const long long csr_version = 1;
+
+// Raw layout of a binary CSR file: the header, the nrows + 1 row offsets and
+// the 0-based column indices as 64-bit integers, then the values as doubles
+typedef struct csr_header {
+  char magic[8];
+  long long version;
+  long long nrows;
+  long long ncols;
+  long long nnz;
+} csr_header;
+
+typedef struct matrix_entry {
+  long long row;
+  long long col;
+  double value;
+} matrix_entry;
+
+bool EntryBefore(const matrix_entry& a, const matrix_entry& b) {
+  return a.row < b.row || (a.row == b.row && a.col < b.col);
+}
+
+// The rows of this process with their global column ids, in CSR
+typedef struct external_rows {
+  long long totalRows;
+  std::vector<long long> offsets;
+  std::vector<long long> columns;
+  std::vector<double> values;
+} external_rows;
+
+// Contiguous blocks of rows, one per process, the first nrows % size of them
+// one row longer than the others
+class RowBlocks {
+ public:
+  RowBlocks(long long nrows, int size) : q(nrows / size), r(nrows % size) {}
+
+  long long first(int rank) const {
+    return rank * q + std::min<long long>(rank, r);
+  }
+  long long count(int rank) const { return q + (rank < r ? 1 : 0); }
+  int owner(long long row) const {
+    const long long split = r * (q + 1);
+    return (int)(row < split ? row / (q + 1) : r + (row - split) / q);
+  }
+
+  long long q, r;
+};
+
+bool AllOk(bool ok) {
+#ifndef HPCG_NO_MPI
+  int local = ok, all = ok;
+  MPI_Allreduce(&local, &all, 1, MPI_INT, MPI_MIN, MPI_COMM_WORLD);
+  return all;
+#else
+  return ok;
+#endif
+}
+
+// A file that every process reads at its own offsets. With MPI the reads are
+// collective, so all processes make the same calls, possibly of 0 bytes.
+class SharedFile {
+ public:
+  SharedFile() : length(-1) {}
+
+  bool open(const std::string& path) {
+#ifndef HPCG_NO_MPI
+    if (MPI_File_open(MPI_COMM_WORLD, path.c_str(), MPI_MODE_RDONLY,
+                      MPI_INFO_NULL, &fh) != MPI_SUCCESS) {
+      return false;
+    }
+    MPI_Offset bytes = 0;
+    MPI_File_get_size(fh, &bytes);
+    length = bytes;
+#else
+    fd = ::open(path.c_str(), O_RDONLY);
+    struct stat st;
+    if (fd < 0 || fstat(fd, &st) != 0) return false;
+    length = st.st_size;
+#endif
+    return true;
+  }
+
+  long long size() const { return length; }
+
+  // MPI counts are ints, larger ranges are read in rounds
+  bool read(long long offset, void* buffer, long long bytes) {
+    const long long chunk = 1LL << 30;
+    bool ok = offset >= 0 && bytes >= 0 && offset + bytes <= length;
+    char* dst = (char*)buffer;
+#ifndef HPCG_NO_MPI
+    // Processes with an invalid range still take part, reading nothing
+    const long long base = ok ? offset : 0, total = ok ? bytes : 0;
+    long long rounds = (total + chunk - 1) / chunk, maxRounds = 0;
+    MPI_Allreduce(&rounds, &maxRounds, 1, MPI_LONG_LONG_INT, MPI_MAX,
+                  MPI_COMM_WORLD);
+    for (long long i = 0; i < maxRounds; ++i) {
+      const long long done = std::min(i * chunk, total);
+      const int count      = (int)std::min(chunk, total - done);
+      MPI_Status status;
+      int got = 0;
+      if (MPI_File_read_at_all(fh, base + done, dst + done, count, MPI_BYTE,
+                               &status) != MPI_SUCCESS ||
+          MPI_Get_count(&status, MPI_BYTE, &got) != MPI_SUCCESS ||
+          got != count) {
+        ok = false;
+      }
+    }
+#else
+    for (long long done = 0; ok && done < bytes;) {
+      const ssize_t got =
+          pread(fd, dst + done, std::min(chunk, bytes - done), offset + done);
+      if (got <= 0) ok = false;
+      done += got;
+    }
+#endif
+    return ok;
+  }
+
+  void close() {
+#ifndef HPCG_NO_MPI
+    MPI_File_close(&fh);
+#else
+    if (fd >= 0) ::close(fd);
+#endif
+  }
+
+ private:
+#ifndef HPCG_NO_MPI
+  MPI_File fh;
+#else
+  int fd;
+#endif
+  long long length;
+};
+
+// Banner and size line of a Matrix Market file: the number of rows, columns
+// and entries, whether it is a pattern, whether only one triangle is stored
+// and the offset of the first entry. Only coordinate matrices with real,
+// integer or pattern values, stored in full or symmetric, are accepted.
+bool ReadMatrixMarketHeader(const std::string& path, long long info[6]) {
+  std::ifstream in(path.c_str(), std::ios::binary);
+  std::string line, tag, object, format, field, symmetry;
+  if (!std::getline(in, line)) return false;
+
+  std::transform(line.begin(), line.end(), line.begin(), ::tolower);
+  std::istringstream banner(line);
+  banner >> tag >> object >> format >> field >> symmetry;
+  if (tag != "%%matrixmarket" || object != "matrix" ||
+      format != "coordinate" ||
+      (field != "real" && field != "integer" && field != "pattern") ||
+      (symmetry != "general" && symmetry != "symmetric")) {
+    return false;
+  }
+
+  while (std::getline(in, line) && (line.empty() || line[0] == '%')) {
+  }
+  std::istringstream sizes(line);
+  if (!(sizes >> info[0] >> info[1] >> info[2])) return false;
+  info[3] = field == "pattern";
+  info[4] = symmetry == "symmetric";
+  info[5] = in.tellg();
+  return info[5] > 0;
+}
+
+// Entries of the lines of a Matrix Market file that start in [begin, end).
+// buffer holds the bytes [readStart, readEnd) of the file, NUL-terminated,
+// where readStart is begin or the byte before it, and readEnd extends past
+// end so that the last line starting before end is complete.
+bool ParseMatrixMarketLines(const char* buffer, long long readStart,
+                            long long readEnd, long long begin, long long end,
+                            long long fileSize, const long long info[6],
+                            std::vector<matrix_entry>& entries) {
+  const char* p    = buffer;
+  const char* last = buffer + (readEnd - readStart);
+
+  // A line starts at begin only if the previous one ends right before it
+  if (readStart < begin) {
+    const char* nl = (const char*)std::memchr(p, '\n', last - p);
+    if (nl == 0) return true;
+    p = nl + 1;
+  }
+
+  while (p < last && readStart + (p - buffer) < end) {
+    const char* nl = (const char*)std::memchr(p, '\n', last - p);
+    if (nl == 0 && readEnd < fileSize) return false;  // Overlong line
+    const char* lineEnd = nl ? nl : last;
+
+    while (p < lineEnd && std::isspace(*p)) ++p;
+    if (p < lineEnd && *p != '%') {
+      char* q;
+      matrix_entry e;
+      e.row = std::strtoll(p, &q, 10) - 1;
+      if (q > lineEnd || q == p) return false;
+      p     = q;
+      e.col = std::strtoll(p, &q, 10) - 1;
+      if (q > lineEnd || q == p) return false;
+      p       = q;
+      e.value = 1.0;
+      if (!info[3]) {
+        e.value = std::strtod(p, &q);
+        if (q > lineEnd || q == p) return false;
+      }
+      if (e.row < 0 || e.row >= info[0] || e.col < 0 || e.col >= info[1]) {
+        return false;
+      }
+
+      entries.push_back(e);
+      if (info[4] && e.row != e.col) {
+        std::swap(e.row, e.col);
+        entries.push_back(e);
+      }
+    }
+    p = lineEnd + 1;
+  }
+  return true;
+}
+
+// Every process parses an equal byte range of the entries, which are then
+// sent to the processes that own their rows
+bool ReadMatrixMarket(const std::string& path, SharedFile& file, int size,
+                      int rank, external_rows& rows) {
+  long long info[7] = {0};
+  if (rank == 0) info[6] = ReadMatrixMarketHeader(path, info);
+#ifndef HPCG_NO_MPI
+  MPI_Bcast(info, 7, MPI_LONG_LONG_INT, 0, MPI_COMM_WORLD);
+#endif
+  if (!info[6] || info[0] != info[1] || info[0] < size) return false;
+
+  const long long dataStart = info[5], dataBytes = file.size() - dataStart;
+  const long long begin     = dataStart + dataBytes * rank / size;
+  const long long end       = dataStart + dataBytes * (rank + 1) / size;
+  const long long overlap   = 1024;  // Longer than any line of entries
+  const long long readStart = std::max(dataStart, begin - 1);
+  const long long readEnd   = std::min(file.size(), end + overlap);
+
+  std::vector<char> buffer(readEnd - readStart + 1, 0);
+  std::vector<matrix_entry> entries;
+  bool ok = file.read(readStart, buffer.data(), readEnd - readStart) &&
+            ParseMatrixMarketLines(buffer.data(), readStart, readEnd, begin,
+                                   end, file.size(), info, entries);
+  std::vector<char>().swap(buffer);
+
+  // Every stored entry has been parsed exactly once
+  long long parsed = 0;
+  for (size_t k = 0; k < entries.size(); ++k)
+    if (!info[4] || entries[k].row >= entries[k].col) ++parsed;
+  long long totalParsed = parsed;
+#ifndef HPCG_NO_MPI
+  MPI_Allreduce(&parsed, &totalParsed, 1, MPI_LONG_LONG_INT, MPI_SUM,
+                MPI_COMM_WORLD);
+#endif
+  if (!AllOk(ok && totalParsed == info[2])) return false;
+
+  std::sort(entries.begin(), entries.end(), EntryBefore);
+  const RowBlocks blocks(info[0], size);
+#ifndef HPCG_NO_MPI
+  // Sorted by row, the entries are grouped by owner
+  std::vector<int> sendCounts(size, 0), sendDispls(size, 0);
+  std::vector<int> recvCounts(size, 0), recvDispls(size, 0);
+  for (size_t k = 0; k < entries.size(); ++k)
+    ++sendCounts[blocks.owner(entries[k].row)];
+  MPI_Alltoall(sendCounts.data(), 1, MPI_INT, recvCounts.data(), 1, MPI_INT,
+               MPI_COMM_WORLD);
+  for (int p = 1; p < size; ++p) {
+    sendDispls[p] = sendDispls[p - 1] + sendCounts[p - 1];
+    recvDispls[p] = recvDispls[p - 1] + recvCounts[p - 1];
+  }
+
+  MPI_Datatype entryType;
+  MPI_Type_contiguous(sizeof(matrix_entry), MPI_BYTE, &entryType);
+  MPI_Type_commit(&entryType);
+  std::vector<matrix_entry> received(recvDispls[size - 1] +
+                                     recvCounts[size - 1]);
+  MPI_Alltoallv(entries.data(), sendCounts.data(), sendDispls.data(),
+                entryType, received.data(), recvCounts.data(),
+                recvDispls.data(), entryType, MPI_COMM_WORLD);
+  MPI_Type_free(&entryType);
+  entries.swap(received);
+  std::vector<matrix_entry>().swap(received);
+  std::sort(entries.begin(), entries.end(), EntryBefore);
+#endif
+
+  // Repeated entries are summed
+  const long long firstRow = blocks.first(rank);
+  rows.totalRows           = info[0];
+  rows.offsets.assign(blocks.count(rank) + 1, 0);
+  for (size_t k = 0; k < entries.size(); ++k) {
+    if (k > 0 && entries[k].row == entries[k - 1].row &&
+        entries[k].col == entries[k - 1].col) {
+      rows.values.back() += entries[k].value;
+      continue;
+    }
+    ++rows.offsets[entries[k].row - firstRow + 1];
+    rows.columns.push_back(entries[k].col);
+    rows.values.push_back(entries[k].value);
+  }
+  for (size_t i = 1; i < rows.offsets.size(); ++i)
+    rows.offsets[i] += rows.offsets[i - 1];
+  return true;
+}
+
+// Every process reads the row offsets of its block, then the contiguous
+// ranges of column indices and values they delimit
+bool ReadBinaryCsr(SharedFile& file, int size, int rank, external_rows& rows) {
+  csr_header h;
+  if (!file.read(0, &h, sizeof(csr_header))) return false;
+  const long long dataStart = sizeof(csr_header);
+  if (std::memcmp(h.magic, csr_magic, sizeof(csr_magic)) != 0 ||
+      h.version != csr_version || h.nrows != h.ncols || h.nrows < size ||
+      h.nnz < 0 ||
+      file.size() != dataStart + (h.nrows + 1) * 8 + h.nnz * 16) {
+    return false;
+  }
+
+  const RowBlocks blocks(h.nrows, size);
+  const long long n = blocks.count(rank);
+  rows.totalRows    = h.nrows;
+  rows.offsets.resize(n + 1);
+  bool ok = file.read(dataStart + blocks.first(rank) * 8, rows.offsets.data(),
+                      (n + 1) * 8);
+
+  const long long first = rows.offsets[0], nnz = rows.offsets[n] - first;
+  for (long long i = 0; ok && i < n; ++i)
+    ok = rows.offsets[i] <= rows.offsets[i + 1];
+  ok = ok && first >= 0 && nnz >= 0 && rows.offsets[n] <= h.nnz;
+
+  rows.columns.resize(ok ? nnz : 0);
+  rows.values.resize(ok ? nnz : 0);
+  const long long columnsStart = dataStart + (h.nrows + 1) * 8;
+  const long long valuesStart  = columnsStart + h.nnz * 8;
+  ok = file.read(columnsStart + first * 8, rows.columns.data(),
+                 rows.columns.size() * 8) &&
+       ok;
+  ok = file.read(valuesStart + first * 8, rows.values.data(),
+                 rows.values.size() * 8) &&
+       ok;
+
+  for (long long i = 0; i <= n; ++i) rows.offsets[i] -= first;
+  for (size_t k = 0; ok && k < rows.columns.size(); ++k)
+    ok = rows.columns[k] >= 0 && rows.columns[k] < h.ncols;
+  return AllOk(ok);
+}
+
+// Whether every entry (i, j) coupling two processes has its transpose (j, i).
+// SetupHalo derives what a process receives from its own columns and what it
+// sends from its neighbors' columns in its rows, so a coupling in one
+// direction only leaves unmatched sends and receives. The owner of column j
+// checks each such entry against row j.
+bool CrossProcessPatternSymmetric(const external_rows& rows, int size,
+                                  int rank) {
+#ifndef HPCG_NO_MPI
+  const RowBlocks blocks(rows.totalRows, size);
+  const long long firstRow = blocks.first(rank);
+  const long long n        = blocks.count(rank);
+
+  std::vector<std::vector<long long> > pairs(size);
+  for (long long i = 0; i < n; ++i) {
+    for (long long k = rows.offsets[i]; k < rows.offsets[i + 1]; ++k) {
+      const int owner = blocks.owner(rows.columns[k]);
+      if (owner == rank) continue;
+      pairs[owner].push_back(firstRow + i);
+      pairs[owner].push_back(rows.columns[k]);
+    }
+  }
+
+  std::vector<int> sendCounts(size, 0), sendDispls(size, 0);
+  std::vector<int> recvCounts(size, 0), recvDispls(size, 0);
+  std::vector<long long> sent;
+  for (int p = 0; p < size; ++p) {
+    sendCounts[p] = (int)pairs[p].size();
+    sendDispls[p] = (int)sent.size();
+    sent.insert(sent.end(), pairs[p].begin(), pairs[p].end());
+  }
+  MPI_Alltoall(sendCounts.data(), 1, MPI_INT, recvCounts.data(), 1, MPI_INT,
+               MPI_COMM_WORLD);
+  for (int p = 1; p < size; ++p)
+    recvDispls[p] = recvDispls[p - 1] + recvCounts[p - 1];
+
+  std::vector<long long> received(recvDispls[size - 1] +
+                                  recvCounts[size - 1]);
+  MPI_Alltoallv(sent.data(), sendCounts.data(), sendDispls.data(),
+                MPI_LONG_LONG_INT, received.data(), recvCounts.data(),
+                recvDispls.data(), MPI_LONG_LONG_INT, MPI_COMM_WORLD);
+
+  bool ok = true;
+  for (size_t k = 0; ok && k < received.size(); k += 2) {
+    const long long i = received[k + 1] - firstRow, j = received[k];
+    ok = std::find(rows.columns.begin() + rows.offsets[i],
+                   rows.columns.begin() + rows.offsets[i + 1],
+                   j) != rows.columns.begin() + rows.offsets[i + 1];
+  }
+  return AllOk(ok);
+#else
+  return true;
+#endif
+}
+
+// Fills A as GenerateProblem would for the rows read, with x = 0,
+// xexact = 1 and b = A * xexact. The row blocks are described as a 1D
+// partition along z with two nz values, so that the geometry still gives the
+// owner of every row.
+bool AssembleExternalMatrix(const external_rows& rows, int size, int rank,
+                            int numThreads, Geometry* geom, SparseMatrix& A,
+                            Vector& b, Vector& x, Vector& xexact) {
+  const RowBlocks blocks(rows.totalRows, size);
+  const local_int_t n = blocks.count(rank);
+
+  // Rows must fit the reference data structures, and SYMGS needs the
+  // diagonal of every row
+  bool ok = rows.offsets[n] <= INT_MAX;
+  for (local_int_t i = 0; ok && i < n; ++i) {
+    const long long start = rows.offsets[i], stop = rows.offsets[i + 1];
+    ok = stop - start <= CHAR_MAX &&
+         std::find(rows.columns.begin() + start, rows.columns.begin() + stop,
+                   blocks.first(rank) + i) != rows.columns.begin() + stop;
+  }
+  if (!AllOk(ok)) return false;
+
+  const int pz = blocks.r > 0 ? (int)blocks.r : 0;
+  GenerateGeometry(size, rank, numThreads, pz, blocks.q + 1, blocks.q, 1, 1, n,
+                   1, 1, size, geom);
+
+  const local_int_t localNumberOfNonzeros = rows.offsets[n];
+  char* nonzerosInRow                     = new char[n];
+  global_int_t** mtxIndG                  = new global_int_t*[n];
+  local_int_t** mtxIndL                   = new local_int_t*[n];
+  double** matrixValues                   = new double*[n];
+  double** matrixDiagonal                 = new double*[n];
+
+  InitializeVector(b, n);
+  InitializeVector(x, n);
+  InitializeVector(xexact, n);
+  A.localToGlobalMap.resize(n);
+
+#ifdef HPCG_CONTIGUOUS_ARRAYS
+  global_int_t* indG = new global_int_t[localNumberOfNonzeros];
+  local_int_t* indL  = new local_int_t[localNumberOfNonzeros];
+  double* values     = new double[localNumberOfNonzeros];
+#endif
+
+#ifndef HPCG_NO_OPENMP
+#pragma omp parallel for
+#endif
+  for (local_int_t i = 0; i < n; ++i) {
+    const long long start = rows.offsets[i];
+    const local_int_t nnz = rows.offsets[i + 1] - start;
+#ifndef HPCG_CONTIGUOUS_ARRAYS
+    mtxIndG[i]      = new global_int_t[nnz];
+    mtxIndL[i]      = new local_int_t[nnz];
+    matrixValues[i] = new double[nnz];
+#else
+    mtxIndG[i]      = indG + start;
+    mtxIndL[i]      = indL + start;
+    matrixValues[i] = values + start;
+#endif
+    nonzerosInRow[i] = (char)nnz;
+
+    const global_int_t globalRow = geom->giz0 + i;
+    double sum                   = 0.0;
+    for (local_int_t j = 0; j < nnz; ++j) {
+      mtxIndG[i][j]      = rows.columns[start + j];
+      matrixValues[i][j] = rows.values[start + j];
+      if (mtxIndG[i][j] == globalRow) matrixDiagonal[i] = matrixValues[i] + j;
+      sum += matrixValues[i][j];
+    }
+
+    A.localToGlobalMap[i] = globalRow;
+    b.values[i]           = sum;
+    x.values[i]           = 0.0;
+    xexact.values[i]      = 1.0;
+  }
+  A.globalToLocalMap.setBox(*geom);
+
+  A.title                 = 0;
+  A.totalNumberOfRows     = rows.totalRows;
+  A.localNumberOfRows     = n;
+  A.localNumberOfColumns  = n;
+  A.localNumberOfNonzeros = localNumberOfNonzeros;
+  A.nonzerosInRow         = nonzerosInRow;
+  A.mtxIndG               = mtxIndG;
+  A.mtxIndL               = mtxIndL;
+  A.matrixValues          = matrixValues;
+  A.matrixDiagonal        = matrixDiagonal;
+
+  SparseMatrix* matrices[] = {&A};
+  ReduceNumberOfNonzeros(matrices, 1);
+  return true;
+}
+}  // namespace
+
+/*!
+  Reads a square matrix from a Matrix Market file (coordinate format, general
+  or symmetric) or from a binary CSR file, in place of GenerateProblem. Each
+  process reads its own block of contiguous rows with MPI-IO, the blocks
+  differing by at most one row. The sparsity pattern has to be symmetric, as
+  SetupHalo assumes, which is checked for the entries coupling processes.
+
+  @param[in]  path       The matrix file
+  @param[in]  size       The number of MPI processes
+  @param[in]  rank       This process' rank
+  @param[in]  numThreads This process' number of threads
+  @param[out] geom       The partition of the rows as a 1D process grid
+  @param[out] A          The matrix, as left by GenerateProblem
+  @param[out] b          The right hand side vector, the row sums of A
+  @param[out] x          The initial guess, 0
+  @param[out] xexact     The exact solution, 1
+
+  @return Returns zero on success and a non-zero value otherwise, on all
+  processes alike. On failure nothing is allocated: A is only initialized and
+  geom is left as is.
+
+  @see GenerateProblem
+*/
+int ReadExternalMatrix(const std::string& path, int size, int rank,
+                       int numThreads, Geometry* geom, SparseMatrix& A,
+                       Vector& b, Vector& x, Vector& xexact) {
+  InitializeSparseMatrix(A, geom);
+#if defined(HPCG_WITH_MORPHEUS_DIRECT_GENERATION)
+  // The rows of every matrix belong to its generated Morpheus matrix
+  if (rank == 0)
+    HPCG_fout << "External matrices cannot be read with direct generation"
+              << std::endl;
+  return 1;
+#endif
+
+  SharedFile file;
+  if (!AllOk(file.open(path))) {
+    if (rank == 0) HPCG_fout << "Cannot open matrix " << path << std::endl;
+    return 1;
+  }
+
+  char magic[sizeof(csr_magic)] = {0};
+  bool binary = file.read(0, magic, std::min<long long>(sizeof(magic),
+                                                        file.size())) &&
+                std::memcmp(magic, csr_magic, sizeof(csr_magic)) == 0;
+
+  external_rows rows;
+  bool ok = binary ? ReadBinaryCsr(file, size, rank, rows)
+                   : ReadMatrixMarket(path, file, size, rank, rows);
+  file.close();
+
+  // The halo of an unsymmetric pattern would deadlock SetupHalo
+  const bool symmetric = !ok || CrossProcessPatternSymmetric(rows, size, rank);
+  ok = ok && symmetric &&
+       AssembleExternalMatrix(rows, size, rank, numThreads, geom, A, b, x,
+                              xexact);
+  if (!symmetric && rank == 0) {
+    HPCG_fout << "Matrix " << path << " has an entry (i, j) coupling two "
+              << "processes without an entry (j, i), its sparsity pattern "
+              << "must be symmetric" << std::endl;
+  } else if (!ok && rank == 0) {
+    HPCG_fout << "Matrix " << path << " is not a square "
+              << (binary ? "binary CSR" : "Matrix Market")
+              << " matrix with a diagonal entry in every row, at most "
+              << CHAR_MAX << " entries per row and at least one row per "
+              << "process" << std::endl;
+  }
+  return !ok;
+}
@@ -47,6 +47,7 @@
  * ************************************************************************ */
 
 #include <cstdio>
+#include <cstring>
 #include <iostream>
 #include "ReadHpcgDat.hpp"
 
@@ -72,7 +73,7 @@ static int SkipUntilEol(FILE *stream) {
 }
 
 int ReadHpcgDat(int *localDimensions, int *secondsPerRun,
-                int *localProcDimensions) {
+                int *localProcDimensions, Stencil *stencil) {
   FILE *hpcgStream = fopen("hpcg.dat", "r");
 
   if (!hpcgStream) return -1;
@@ -103,6 +104,28 @@ int ReadHpcgDat(int *localDimensions, int *secondsPerRun,
       localProcDimensions[i] =
           0;  // value 0 means: "not specified" and it will be fixed later
 
+  SkipUntilEol(hpcgStream);  // skip the rest of the fifth line
+
+  if (stencil != 0) {  // Only read the operator if the pointer is non-zero
+    // The stencil points, the strength of the couplings in each direction and
+    // "constant" or "variable" coefficients, e.g. "7 1.0 1.0 0.1 constant".
+    // Missing values keep the ones passed in.
+    int points;
+    double strength[3];
+    char coefficients[16];
+    if (fscanf(hpcgStream, "%d", &points) == 1) {
+      stencil->points = points;
+      if (fscanf(hpcgStream, "%lf %lf %lf", strength, strength + 1,
+                 strength + 2) == 3) {
+        stencil->ax = strength[0];
+        stencil->ay = strength[1];
+        stencil->az = strength[2];
+        if (fscanf(hpcgStream, "%15s", coefficients) == 1)
+          stencil->variable = strcmp(coefficients, "variable") == 0;
+      }
+    }
+  }
+
   fclose(hpcgStream);
 
   return 0;
@@ -49,7 +49,9 @@
 #ifndef READHPCGDAT_HPP
 #define READHPCGDAT_HPP
 
+#include "Geometry.hpp"
+
 int ReadHpcgDat(int *localDimensions, int *secondsPerRun,
-                int *localProcDimensions);
+                int *localProcDimensions, Stencil *stencil);
 
 #endif  // READHPCGDAT_HPP
@@ -60,6 +60,7 @@
 #include "ReportResults.hpp"
 #include "OutputFile.hpp"
 #include "OptimizeProblem.hpp"
+#include "SetupProfile.hpp"
 
 #ifdef HPCG_DEBUG
 #include <fstream>
@@ -178,6 +179,75 @@ double count_spmv_writes(const MorpheusMatrix& A, int fniters,
   return fnwrites_sparsemv;
 }
 
+#if defined(HPCG_WITH_HYBRID_LOCAL)
+double count_spmv_flops(const Morpheus_HybridMat& H, int fniters,
+                        int fNumberOfCgSets) {
+  double fnnz = (double)H.interiorRows.dev.size() * H.ndiags +
+                (double)H.boundary.dev.nnnz();
+  // 1 SpMV with nnz adds and nnz mults
+  return (fniters + fNumberOfCgSets) * 2.0 * fnnz;
+}
+
+double count_spmv_reads(const Morpheus_HybridMat& H, int fniters,
+                        int fNumberOfCgSets) {
+  double index_size = (double)sizeof(Morpheus::index_type);
+  double value_size = (double)sizeof(Morpheus::value_type);
+  double ninterior  = H.interiorRows.dev.size();
+  double nboundary  = H.boundaryRows.dev.size();
+  double nnz_bound  = H.boundary.dev.nnnz();
+
+  // Interior: values, row ids and offsets. Boundary: CSR and row ids.
+  double fnreads_interior =
+      ninterior * H.ndiags * value_size + (ninterior + H.ndiags) * index_size;
+  double fnreads_boundary = nnz_bound * (value_size + index_size) +
+                            (2 * nboundary + 1) * index_size;
+  double fnreads_sum = (ninterior + nboundary) * value_size;
+
+  return (fniters + fNumberOfCgSets) *
+         (fnreads_interior + fnreads_boundary + fnreads_sum);
+}
+
+double count_spmv_writes(const Morpheus_HybridMat& H, int fniters,
+                         int fNumberOfCgSets) {
+  double value_size = (double)sizeof(Morpheus::value_type);
+  // 1 SpMV nrow writes
+  return (fniters + fNumberOfCgSets) * H.nrows * value_size;
+}
+#endif  // HPCG_WITH_HYBRID_LOCAL
+
+#if defined(HPCG_WITH_BLOCK_FORMATS)
+// Each row block is counted according to its own format
+double count_spmv_flops(const Morpheus_BlockMat& B, int fniters,
+                        int fNumberOfCgSets) {
+  double fnops_sparsemv = 0.0;
+  for (size_t b = 0; b < B.blocks.size(); b++) {
+    fnops_sparsemv +=
+        count_spmv_flops(B.blocks[b].host, fniters, fNumberOfCgSets);
+  }
+  return fnops_sparsemv;
+}
+
+double count_spmv_reads(const Morpheus_BlockMat& B, int fniters,
+                        int fNumberOfCgSets) {
+  double fnreads_sparsemv = 0.0;
+  for (size_t b = 0; b < B.blocks.size(); b++) {
+    fnreads_sparsemv +=
+        count_spmv_reads(B.blocks[b].host, fniters, fNumberOfCgSets);
+  }
+  return fnreads_sparsemv;
+}
+
+double count_spmv_writes(const Morpheus_BlockMat& B, int fniters,
+                         int fNumberOfCgSets) {
+  double fnwrites_sparsemv = 0.0;
+  for (size_t b = 0; b < B.blocks.size(); b++) {
+    fnwrites_sparsemv +=
+        count_spmv_writes(B.blocks[b].host, fniters, fNumberOfCgSets);
+  }
+  return fnwrites_sparsemv;
+}
+#endif  // HPCG_WITH_BLOCK_FORMATS
+
 #endif  // HPCG_WITH_MORPHEUS
 
 /*!
@@ -222,6 +292,7 @@ void ReportResults(const SparseMatrix& A, int numberOfMgLevels,
   MPI_Allreduce(&t4, &t4avg, 1, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
   t4avg = t4avg / ((double)A.geom->size);
 #endif
+  ReduceSetupPhases(A.geom->size, A.geom->rank);
 
   if (A.geom->rank ==
       0) {  // Only PE 0 needs to compute and report timing results
@@ -245,11 +316,15 @@ void ReportResults(const SparseMatrix& A, int numberOfMgLevels,
 
     double fnops_sparsemv = 0.0;
 #ifdef HPCG_WITH_MORPHEUS
+#if defined(HPCG_WITH_HYBRID_LOCAL) || defined(HPCG_WITH_BLOCK_FORMATS)
+    const auto& Alocal = ((HPCG_Morpheus_Mat*)A.optimizationData)->local;
+#else
     auto Alocal = ((HPCG_Morpheus_Mat*)A.optimizationData)->local.host;
+#endif
     fnops_sparsemv += count_spmv_flops(Alocal, fniters, fNumberOfCgSets);
 
 #if defined(HPCG_WITH_SPLIT_DISTRIBUTED)
-    auto Aghost = ((HPCG_Morpheus_Mat*)A.optimizationData)->local.host;
+    auto Aghost = ((HPCG_Morpheus_Mat*)A.optimizationData)->ghost.host;
     fnops_sparsemv += count_spmv_flops(Aghost, fniters, fNumberOfCgSets);
 #endif  // HPCG_WITH_SPLIT_DISTRIBUTED
 #else
@@ -305,6 +380,12 @@ void ReportResults(const SparseMatrix& A, int numberOfMgLevels,
 #if defined(HPCG_WITH_SPLIT_DISTRIBUTED)
     fnreads_sparsemv += count_spmv_reads(Aghost, fniters, fNumberOfCgSets);
     fnwrites_sparsemv += count_spmv_writes(Aghost, fniters, fNumberOfCgSets);
+    // Scatter-add of the compact ghost product: row ids, product and y
+    double fnghost = Aghost.nrows();
+    fnreads_sparsemv += (fniters + fNumberOfCgSets) * fnghost *
+                        (sizeof(local_int_t) + 2.0 * sizeof(double));
+    fnwrites_sparsemv +=
+        (fniters + fNumberOfCgSets) * fnghost * sizeof(double);
 #endif  // HPCG_WITH_SPLIT_DISTRIBUTED
 #else
     // 1 SpMV with nnz reads of values, nnz reads indices, plus nrow reads of x
@@ -369,8 +450,8 @@ void ReportResults(const SparseMatrix& A, int numberOfMgLevels,
     // Data in GenerateProblem_ref
 
     double numberOfNonzerosPerRow =
-        27.0;  // We are approximating a 27-point finite
-               // element/volume/difference 3D stencil
+        A.geom->stencil.points;  // We are approximating a 7-point or 27-point
+                                 // finite element/volume/difference 3D stencil
     double size = ((double)A.geom->size);  // Needed for estimating size of halo
 
     double fnbytes = ((double)sizeof(Geometry));  // Geometry struct in main.cpp
@@ -495,16 +576,38 @@ void ReportResults(const SparseMatrix& A, int numberOfMgLevels,
 
     doc.add("Setup Information", "");
     doc.get("Setup Information")->add("Setup Time", times[9]);
+    doc.get("Setup Information")->add("Setup Phases", "");
+    ReportSetupPhases(doc.get("Setup Information")->get("Setup Phases"));
 
     doc.add("Linear System Information", "");
     doc.get("Linear System Information")
         ->add("Number of Equations", A.totalNumberOfRows);
     doc.get("Linear System Information")
         ->add("Number of Nonzero Terms", A.totalNumberOfNonzeros);
+    doc.get("Linear System Information")
+        ->add("Stencil Points", A.geom->stencil.points);
+    doc.get("Linear System Information")
+        ->add("Anisotropy x", A.geom->stencil.ax);
+    doc.get("Linear System Information")
+        ->add("Anisotropy y", A.geom->stencil.ay);
+    doc.get("Linear System Information")
+        ->add("Anisotropy z", A.geom->stencil.az);
+    doc.get("Linear System Information")
+        ->add("Coefficients",
+              A.geom->stencil.variable ? "variable" : "constant");
 
     doc.add("Multigrid Information", "");
     doc.get("Multigrid Information")
         ->add("Number of coarse grid levels", numberOfMgLevels - 1);
+    const int coarseOperator =
+        A.mgData ? A.mgData->coarseOperator : HPCG_GEOMETRIC_COARSE;
+    doc.get("Multigrid Information")
+        ->add("Coarse Operators",
+              coarseOperator == HPCG_GALERKIN_FULL_WEIGHTING
+                  ? "galerkin full weighting"
+                  : coarseOperator == HPCG_GALERKIN_INJECTION
+                        ? "galerkin injection"
+                        : "geometric");
     Af = &A;
     doc.get("Multigrid Information")->add("Coarse Grids", "");
     for (int i = 1; i < numberOfMgLevels; ++i) {
@@ -586,6 +689,8 @@ void ReportResults(const SparseMatrix& A, int numberOfMgLevels,
         ->add("Departure for SpMV", testsymmetry_data.depsym_spmv);
     doc.get(DepartureFromSymmetry)
         ->add("Departure for MG", testsymmetry_data.depsym_mg);
+    doc.get(DepartureFromSymmetry)
+        ->add("Departure of SpMM from SpMV", testsymmetry_data.depspmm);
 
     doc.add("########## Iterations Summary  ##########", "");
     doc.add("Iteration Count Information", "");
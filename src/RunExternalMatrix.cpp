@@ -0,0 +1,185 @@
+/**
+ * RunExternalMatrix.cpp
+ *
+ * EPCC, The University of Edinburgh
+ *
+ * (c) 2022 The University of Edinburgh
+ *
+ * Contributing Authors:
+ * Christodoulos Stylianou (c.stylianou@ed.ac.uk)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*!
+ @file RunExternalMatrix.cpp
+
+ HPCG driver for CG on a matrix read from a file
+ */
+
+#ifndef HPCG_NO_MPI
+#include <mpi.h>
+#endif
+
+#include <iostream>
+#include <sstream>
+#include <vector>
+
+#include "RunExternalMatrix.hpp"
+#include "CG.hpp"
+#include "CGData.hpp"
+#include "OptimizeProblem.hpp"
+#include "ReadExternalMatrix.hpp"
+#include "SetupHalo.hpp"
+#include "SparseMatrix.hpp"
+#include "Vector.hpp"
+#include "mytimer.hpp"
+
+#ifdef HPCG_WITH_MORPHEUS
+#include "morpheus/Morpheus_ReportResults.hpp"
+#include "morpheus/Morpheus_VectorRoutines.hpp"
+#endif  // HPCG_WITH_MORPHEUS
+
+/*!
+  Reads the matrix given with --matrix, sets up its halo and Morpheus
+  matrices and times CG sets of 50 iterations on it for the requested running
+  time, with b the row sums of the matrix. The matrix has no coarse levels, so
+  the preconditioner is a single symmetric Gauss-Seidel sweep instead of MG.
+  There is no reference run nor validation. ReadExternalMatrix rejects
+  matrices whose sparsity pattern is not symmetric, the values are assumed to
+  make the matrix symmetric positive definite. The results are written to the
+  log file and the console.
+
+  @param[in] params The parameters of the run
+
+  @return Returns zero on success and a non-zero value otherwise.
+
+  @see ReadExternalMatrix
+*/
+int RunExternalMatrix(const HPCG_Params& params) {
+  const int rank = params.comm_rank;
+
+  double setup_times[3] = {0.0, 0.0, 0.0};  // Read, SetupHalo, Optimize
+  double t0             = mytimer();
+
+  Geometry* geom = new Geometry;
+  SparseMatrix A;
+  Vector b, x, xexact;
+  int ierr = ReadExternalMatrix(params.matrixFile, params.comm_size, rank,
+                                params.numThreads, geom, A, b, x, xexact);
+  if (ierr) {
+    // ReadExternalMatrix has logged the reason
+    if (rank == 0)
+      HPCG_fout << "Error in call to ReadExternalMatrix: " << ierr << ".\n"
+                << std::endl;
+    delete geom;
+    return ierr;
+  }
+  setup_times[0] = mytimer() - t0;
+
+  t0 = mytimer();
+  SetupHalo(A);
+  setup_times[1] = mytimer() - t0;
+
+  CGData data;
+  InitializeSparseCGData(A, data);
+
+  t0 = mytimer();
+  OptimizeProblem(A, data, b, x, xexact);
+  setup_times[2] = mytimer() - t0;
+
+  // The first set only projects how many fit in the running time
+  const int maxIters = 50;
+  int niters         = 0;
+  double normr       = 0.0;
+  double normr0      = 0.0;
+  std::vector<double> times(9, 0.0);
+#ifdef HPCG_WITH_MORPHEUS
+  MorpheusZeroVector(x);
+#else
+  ZeroVector(x);
+#endif  // HPCG_WITH_MORPHEUS
+  ierr = CG(A, data, b, x, maxIters, 0.0, niters, normr, normr0, &times[0],
+            true);
+  double set_time = times[0];
+#ifndef HPCG_NO_MPI
+  MPI_Allreduce(&times[0], &set_time, 1, MPI_DOUBLE, MPI_MAX, MPI_COMM_WORLD);
+#endif
+  const int numberOfCgSets = int(params.runningTime / set_time) + 1;
+
+  times.assign(9, 0.0);
+  int totalNiters = 0;
+  for (int i = 0; i < numberOfCgSets; ++i) {
+#ifdef HPCG_WITH_MORPHEUS
+    MorpheusZeroVector(x);
+#else
+    ZeroVector(x);
+#endif  // HPCG_WITH_MORPHEUS
+    ierr += CG(A, data, b, x, maxIters, 0.0, niters, normr, normr0, &times[0],
+               true);
+    totalNiters += niters;
+    if (rank == 0)
+      HPCG_fout << "Call [" << i << "] Scaled Residual [" << normr / normr0
+                << "]" << std::endl;
+  }
+
+  double cg_time = times[0], max_setup_times[3];
+#ifndef HPCG_NO_MPI
+  MPI_Allreduce(&times[0], &cg_time, 1, MPI_DOUBLE, MPI_MAX, MPI_COMM_WORLD);
+  MPI_Allreduce(setup_times, max_setup_times, 3, MPI_DOUBLE, MPI_MAX,
+                MPI_COMM_WORLD);
+#else
+  for (int i = 0; i < 3; ++i) max_setup_times[i] = setup_times[i];
+#endif
+
+  if (rank == 0) {
+    // Same operation counts as ReportResults, with one SYMGS sweep per
+    // preconditioner application
+    const double nrow = A.totalNumberOfRows;
+    const double nnz  = A.totalNumberOfNonzeros;
+    const double fnops =
+        numberOfCgSets * ((3.0 * maxIters + 1.0) * 4.0 * nrow +
+                          (maxIters + 1.0) * 2.0 * nnz + maxIters * 4.0 * nnz);
+
+    std::ostringstream summary;
+    summary << "Matrix " << params.matrixFile << ": " << A.totalNumberOfRows
+            << " rows and " << A.totalNumberOfNonzeros << " nonzeros on "
+            << params.comm_size << " processes" << std::endl
+            << "Setup: " << max_setup_times[0] << " seconds reading, "
+            << max_setup_times[1] << " seconds in SetupHalo and "
+            << max_setup_times[2] << " seconds in OptimizeProblem"
+            << std::endl
+            << "CG with symmetric Gauss-Seidel: " << numberOfCgSets
+            << " sets of " << maxIters << " iterations in " << cg_time
+            << " seconds, scaled residual " << normr / normr0 << ", "
+            << fnops / cg_time * 1.0e-9 << " GFLOP/s" << std::endl;
+    std::cout << summary.str();
+    HPCG_fout << summary.str();
+    if (ierr)
+      HPCG_fout << ierr << " error(s) in call(s) to CG." << std::endl;
+  }
+
+#if defined(HPCG_WITH_MORPHEUS)
+  ReportResults();
+#if defined(HPCG_WITH_MULTI_FORMATS)
+  ReportTimingResults();
+#endif  // HPCG_WITH_MULTI_FORMATS
+#endif  // HPCG_WITH_MORPHEUS
+
+  DeleteMatrix(A);  // Also deletes the geometry
+  DeleteCGData(data);
+  DeleteVector(x);
+  DeleteVector(b);
+  DeleteVector(xexact);
+  return ierr;
+}
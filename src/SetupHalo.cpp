@@ -54,8 +54,9 @@
 
 #ifndef HPCG_NO_MPI
 #include <mpi.h>
-#include <map>
-#include <set>
+#include <algorithm>
+#include <cstdint>
+#include <vector>
 #endif
 
 #ifndef HPCG_NO_OPENMP
@@ -65,6 +66,197 @@
 #include "SetupHalo.hpp"
 #include "SetupHalo_ref.hpp"
 
+#ifndef HPCG_NO_MPI
+namespace {
+// Layer of points around the local box, i.e. the points within one step of
+// the box that are not in it, numbered in increasing global order
+struct HaloShell {
+  local_int_t nx, ny, nz;
+  local_int_t ex, plane, ring;
+
+  HaloShell(const Geometry& geom)
+      : nx(geom.nx),
+        ny(geom.ny),
+        nz(geom.nz),
+        ex(geom.nx + 2),
+        plane((geom.nx + 2) * (geom.ny + 2)),
+        ring((geom.nx + 2) * (geom.ny + 2) - geom.nx * geom.ny) {}
+
+  local_int_t size() const { return 2 * plane + nz * ring; }
+
+  // Box coordinates in [-1, n] with at least one of them outside [0, n)
+  local_int_t index(local_int_t x, local_int_t y, local_int_t z) const {
+    if (z < 0) return (y + 1) * ex + x + 1;
+    if (z == nz) return plane + nz * ring + (y + 1) * ex + x + 1;
+
+    const local_int_t base = plane + z * ring;
+    if (y < 0) return base + x + 1;
+    if (y == ny) return base + ex + 2 * ny + x + 1;
+    return base + ex + 2 * y + (x < 0 ? 0 : 1);
+  }
+};
+
+/*!
+  SetupHalo_ref for a matrix whose rows are the local box of the geometry and
+  whose columns lie within one step of it. The external columns are marked
+  in the halo shell instead of being collected in sets, so the lists come out
+  already sorted: neighbors by rank, received entries and sent rows by global
+  id, as in SetupHalo_ref.
+
+  @return false, without modifying A, when the matrix is not of this kind
+*/
+bool SetupHalo_opt(SparseMatrix& A) {
+  const Geometry& geom                = *A.geom;
+  const local_int_t localNumberOfRows = A.localNumberOfRows;
+  const global_int_t gnx              = geom.gnx;
+  const global_int_t gny              = geom.gny;
+  char* nonzerosInRow                 = A.nonzerosInRow;
+  global_int_t** mtxIndG              = A.mtxIndG;
+  local_int_t** mtxIndL               = A.mtxIndL;
+
+  if (!A.globalToLocalMap.isArithmetic()) return false;
+
+  const HaloShell shell(geom);
+  // Index of every external column in the shell, -1 while unused
+  std::vector<local_int_t> halo(shell.size(), -1);
+
+  auto shellIndex = [&](global_int_t col) -> local_int_t {
+    const global_int_t x = col % gnx - geom.gix0;
+    const global_int_t y = (col / gnx) % gny - geom.giy0;
+    const global_int_t z = col / (gnx * gny) - geom.giz0;
+    if (x < -1 || x > shell.nx || y < -1 || y > shell.ny || z < -1 ||
+        z > shell.nz) {
+      return -1;
+    }
+    return shell.index(x, y, z);
+  };
+
+  int outside = 0;
+#ifndef HPCG_NO_OPENMP
+#pragma omp parallel for reduction(+ : outside)
+#endif
+  for (local_int_t i = 0; i < localNumberOfRows; i++) {
+    for (int j = 0; j < nonzerosInRow[i]; j++) {
+      if (A.globalToLocalMap[mtxIndG[i][j]] >= 0) continue;
+      const local_int_t s = shellIndex(mtxIndG[i][j]);
+      if (s < 0) {
+        outside++;
+        continue;
+      }
+#ifndef HPCG_NO_OPENMP
+#pragma omp atomic write
+#endif
+      halo[s] = 0;
+    }
+  }
+  if (outside > 0) return false;
+
+  // Neighbors, sorted by rank, and the neighbor owning every used point
+  std::vector<int> neighbors, owner(shell.size(), -1);
+  for (local_int_t z = -1; z <= shell.nz; z++) {
+    for (local_int_t y = -1; y <= shell.ny; y++) {
+      // Rows of points that cross the box only have their two ends outside
+      const bool crossing = z >= 0 && z < shell.nz && y >= 0 && y < shell.ny;
+      const local_int_t step = crossing ? shell.nx + 1 : 1;
+      for (local_int_t x = -1; x <= shell.nx; x += step) {
+        const local_int_t s = shell.index(x, y, z);
+        if (halo[s] < 0) continue;
+
+        const global_int_t col = (geom.giz0 + z) * gnx * gny +
+                                 (geom.giy0 + y) * gnx + geom.gix0 + x;
+        owner[s] = ComputeRankOfMatrixRow(geom, col);
+        neighbors.push_back(owner[s]);
+      }
+    }
+  }
+  std::sort(neighbors.begin(), neighbors.end());
+  neighbors.erase(std::unique(neighbors.begin(), neighbors.end()),
+                  neighbors.end());
+  const int numberOfNeighbors = neighbors.size();
+  // The rows keep the neighbors they couple to in a bit mask
+  if (numberOfNeighbors > 32) return false;
+
+  std::vector<local_int_t> receiveStart(numberOfNeighbors + 1, 0);
+  for (local_int_t s = 0; s < shell.size(); s++) {
+    if (halo[s] < 0) continue;
+    owner[s] = std::lower_bound(neighbors.begin(), neighbors.end(), owner[s]) -
+               neighbors.begin();
+    receiveStart[owner[s] + 1]++;
+  }
+  for (int k = 0; k < numberOfNeighbors; k++) {
+    receiveStart[k + 1] += receiveStart[k];
+  }
+  // The remote columns are indexed at end of internals
+  std::vector<local_int_t> next(receiveStart.begin(), receiveStart.end() - 1);
+  for (local_int_t s = 0; s < shell.size(); s++) {
+    if (halo[s] >= 0) halo[s] = localNumberOfRows + next[owner[s]]++;
+  }
+
+  // Convert matrix indices to local IDs
+  std::vector<uint32_t> sendTo(localNumberOfRows, 0);
+#ifndef HPCG_NO_OPENMP
+#pragma omp parallel for
+#endif
+  for (local_int_t i = 0; i < localNumberOfRows; i++) {
+    for (int j = 0; j < nonzerosInRow[i]; j++) {
+      const local_int_t col = A.globalToLocalMap[mtxIndG[i][j]];
+      if (col >= 0) {
+        mtxIndL[i][j] = col;
+      } else {
+        const local_int_t s = shellIndex(mtxIndG[i][j]);
+        mtxIndL[i][j]       = halo[s];
+        sendTo[i] |= uint32_t(1) << owner[s];
+      }
+    }
+  }
+
+  // Matrix symmetry means the neighbors want the values of the rows that
+  // couple to them, which are sent in increasing order
+  local_int_t* receiveLength = new local_int_t[numberOfNeighbors];
+  local_int_t* sendLength    = new local_int_t[numberOfNeighbors];
+  for (int k = 0; k < numberOfNeighbors; k++) {
+    receiveLength[k] = receiveStart[k + 1] - receiveStart[k];
+    sendLength[k]    = 0;
+  }
+  local_int_t totalToBeSent = 0;
+  for (local_int_t i = 0; i < localNumberOfRows; i++) {
+    if (sendTo[i] == 0) continue;
+    for (int k = 0; k < numberOfNeighbors; k++) {
+      if (sendTo[i] >> k & 1) sendLength[k]++;
+    }
+  }
+  std::vector<local_int_t> sendStart(numberOfNeighbors, 0);
+  for (int k = 0; k < numberOfNeighbors; k++) {
+    sendStart[k] = totalToBeSent;
+    totalToBeSent += sendLength[k];
+  }
+  local_int_t* elementsToSend = new local_int_t[totalToBeSent];
+  for (local_int_t i = 0; i < localNumberOfRows; i++) {
+    if (sendTo[i] == 0) continue;
+    for (int k = 0; k < numberOfNeighbors; k++) {
+      if (sendTo[i] >> k & 1) elementsToSend[sendStart[k]++] = i;
+    }
+  }
+
+  int* neighborRanks = new int[numberOfNeighbors];
+  std::copy(neighbors.begin(), neighbors.end(), neighborRanks);
+
+  // Store contents in our matrix struct
+  A.numberOfExternalValues = receiveStart[numberOfNeighbors];
+  A.localNumberOfColumns   = A.localNumberOfRows + A.numberOfExternalValues;
+  A.numberOfSendNeighbors  = numberOfNeighbors;
+  A.totalToBeSent          = totalToBeSent;
+  A.elementsToSend         = elementsToSend;
+  A.neighbors              = neighborRanks;
+  A.receiveLength          = receiveLength;
+  A.sendLength             = sendLength;
+  A.sendBuffer             = new double[totalToBeSent];
+
+  return true;
+}
+}  // namespace
+#endif  // HPCG_NO_MPI
+
 /*!
   Prepares system matrix data structure and creates data necessary necessary
   for communication of boundary values of this process.
@@ -74,10 +266,14 @@
   @see ExchangeHalo
 */
 void SetupHalo(SparseMatrix& A) {
-  // The call to this reference version of SetupHalo can be replaced with custom
-  // code. However, any code must work for general unstructured sparse matrices.
-  // Special knowledge about the specific nature of the sparsity pattern may not
-  // be explicitly used.
+  // Any code here must work for general unstructured sparse matrices. The
+  // geometric path only applies when the rows of A are the arithmetic box of
+  // its Geometry and every column lies in the one-point shell around that box.
+  // SetupHalo_opt checks both and leaves every other matrix to SetupHalo_ref,
+  // which uses the sparsity pattern alone, so general matrices still work.
 
+#ifndef HPCG_NO_MPI
+  if (SetupHalo_opt(A)) return;
+#endif
   return (SetupHalo_ref(A));
 }
@@ -0,0 +1,202 @@
+/**
+ * SetupProfile.cpp
+ *
+ * EPCC, The University of Edinburgh
+ *
+ * (c) 2022 The University of Edinburgh
+ *
+ * Contributing Authors:
+ * Christodoulos Stylianou (c.stylianou@ed.ac.uk)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*!
+ @file SetupProfile.cpp
+
+ HPCG routines to profile the setup phases of a run
+ */
+
+#ifndef HPCG_NO_MPI
+#include <mpi.h>
+#endif
+
+#ifndef HPCG_NO_OPENMP
+#include <omp.h>
+#endif
+
+#include <sys/resource.h>
+
+#include <cassert>
+#include <utility>
+#include <vector>
+
+#include "SetupProfile.hpp"
+#include "mytimer.hpp"
+
+namespace {
+// Statistics of a phase: its wall time in seconds, the growth of the peak
+// resident set size in bytes and the CPU time of the process over its wall
+// time times the number of OpenMP threads. The CPU time includes every thread
+// of the process, e.g. those of the MPI library, so the ratio can exceed 1.
+const int setup_statistics = 3;
+
+// Process counters at the start of a phase
+typedef struct setup_counters {
+  double time;
+  double cpuTime;     // User and system time of all threads
+  double peakMemory;  // Peak resident set size
+  int threads;
+} setup_counters;
+
+typedef struct setup_phase {
+  std::string name;
+  int depth;  // Number of enclosing phases
+  double values[setup_statistics];
+  double minimum[setup_statistics];
+  double average[setup_statistics];
+  double maximum[setup_statistics];
+} setup_phase;
+
+// Phases of this process in the order they started
+std::vector<setup_phase> setup_phases;
+// Phases started and not stopped yet, innermost last
+std::vector<std::pair<size_t, setup_counters>> open_phases;
+// Whether every process recorded the same phases
+bool phases_match = false;
+
+setup_counters ReadSetupCounters() {
+  struct rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+
+  setup_counters counters;
+  counters.time    = mytimer();
+  counters.cpuTime = usage.ru_utime.tv_sec + usage.ru_stime.tv_sec +
+                     1.0e-6 * (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec);
+  // Linux reports the peak resident set size in kilobytes
+  counters.peakMemory = 1024.0 * usage.ru_maxrss;
+#ifndef HPCG_NO_OPENMP
+  counters.threads = omp_get_max_threads();
+#else
+  counters.threads = 1;
+#endif
+  return counters;
+}
+}  // namespace
+
+/*!
+  Starts a setup phase of this process. Phases started before it is stopped
+  are reported as its subphases. Must be called outside parallel regions.
+
+  @param[in] name The name of the phase, unique among its sibling phases
+*/
+void StartSetupPhase(const std::string& name) {
+  setup_phase phase;
+  phase.name  = name;
+  phase.depth = (int)open_phases.size();
+  setup_phases.push_back(phase);
+  open_phases.push_back(
+      std::make_pair(setup_phases.size() - 1, ReadSetupCounters()));
+}
+
+/*!
+  Stops the innermost setup phase started and records its statistics.
+*/
+void StopSetupPhase() {
+  assert(!open_phases.empty());
+  const setup_counters stop   = ReadSetupCounters();
+  const setup_counters& start = open_phases.back().second;
+  setup_phase& phase          = setup_phases[open_phases.back().first];
+
+  const double time = stop.time - start.time;
+  phase.values[0]   = time;
+  phase.values[1]   = stop.peakMemory - start.peakMemory;
+  phase.values[2] =
+      time > 0.0 ? (stop.cpuTime - start.cpuTime) / (time * start.threads)
+                 : 0.0;
+  open_phases.pop_back();
+}
+
+/*!
+  Computes the minimum, average and maximum of the statistics of every setup
+  phase over all processes, on the first process. Every process must have
+  recorded the same phases in the same order.
+
+  @param[in] size The number of processes
+  @param[in] rank The rank of this process
+*/
+void ReduceSetupPhases(int size, int rank) {
+  int count = (int)setup_phases.size();
+  std::vector<double> values(setup_statistics * count);
+  for (int i = 0; i < count; ++i)
+    for (int k = 0; k < setup_statistics; ++k)
+      values[setup_statistics * i + k] = setup_phases[i].values[k];
+
+  std::vector<double> minimum(values), maximum(values), sum(values);
+#ifndef HPCG_NO_MPI
+  int counts[2] = {-count, count};
+  MPI_Allreduce(MPI_IN_PLACE, counts, 2, MPI_INT, MPI_MAX, MPI_COMM_WORLD);
+  phases_match = -counts[0] == counts[1];
+  if (!phases_match) return;
+
+  MPI_Reduce(values.data(), minimum.data(), (int)values.size(), MPI_DOUBLE,
+             MPI_MIN, 0, MPI_COMM_WORLD);
+  MPI_Reduce(values.data(), maximum.data(), (int)values.size(), MPI_DOUBLE,
+             MPI_MAX, 0, MPI_COMM_WORLD);
+  MPI_Reduce(values.data(), sum.data(), (int)values.size(), MPI_DOUBLE,
+             MPI_SUM, 0, MPI_COMM_WORLD);
+#else
+  phases_match = true;
+#endif
+  if (rank != 0) return;
+
+  for (int i = 0; i < count; ++i) {
+    for (int k = 0; k < setup_statistics; ++k) {
+      setup_phases[i].minimum[k] = minimum[setup_statistics * i + k];
+      setup_phases[i].average[k] = sum[setup_statistics * i + k] / size;
+      setup_phases[i].maximum[k] = maximum[setup_statistics * i + k];
+    }
+  }
+}
+
+/*!
+  Adds the statistics of ReduceSetupPhases to the report, with the subphases
+  of a phase nested in it. Only valid on the first process.
+
+  @param[inout] phases The element of the report holding the phases
+*/
+void ReportSetupPhases(OutputFile* phases) {
+  if (!phases_match) {
+    phases->add("Result", "The processes recorded different phases");
+    return;
+  }
+
+  // Element of the innermost enclosing phase at every depth
+  std::vector<OutputFile*> parents(1, phases);
+  for (size_t i = 0; i < setup_phases.size(); ++i) {
+    const setup_phase& phase = setup_phases[i];
+    parents.resize(phase.depth + 1);
+    parents.back()->add(phase.name, "");
+    OutputFile* element = parents.back()->get(phase.name);
+    element->add("Min time (sec)", phase.minimum[0]);
+    element->add("Avg time (sec)", phase.average[0]);
+    element->add("Max time (sec)", phase.maximum[0]);
+    element->add("Min peak memory growth (Mbytes)", phase.minimum[1] / 1.0e6);
+    element->add("Avg peak memory growth (Mbytes)", phase.average[1] / 1.0e6);
+    element->add("Max peak memory growth (Mbytes)", phase.maximum[1] / 1.0e6);
+    element->add("Min CPU time per thread-second", phase.minimum[2]);
+    element->add("Avg CPU time per thread-second", phase.average[2]);
+    element->add("Max CPU time per thread-second", phase.maximum[2]);
+    parents.push_back(element);
+  }
+}
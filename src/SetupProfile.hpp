@@ -0,0 +1,41 @@
+/**
+ * SetupProfile.hpp
+ *
+ * EPCC, The University of Edinburgh
+ *
+ * (c) 2022 The University of Edinburgh
+ *
+ * Contributing Authors:
+ * Christodoulos Stylianou (c.stylianou@ed.ac.uk)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*!
+ @file SetupProfile.hpp
+
+ Wall time, peak memory growth and CPU time per thread of the setup phases
+ */
+
+#ifndef SETUPPROFILE_HPP
+#define SETUPPROFILE_HPP
+
+#include <string>
+#include "OutputFile.hpp"
+
+void StartSetupPhase(const std::string& name);
+void StopSetupPhase();
+void ReduceSetupPhases(int size, int rank);
+void ReportSetupPhases(OutputFile* phases);
+
+#endif  // SETUPPROFILE_HPP
@@ -60,15 +60,7 @@
 #include "Geometry.hpp"
 #include "Vector.hpp"
 #include "MGData.hpp"
-#if __cplusplus < 201103L
-// for C++03
-#include <map>
-typedef std::map<global_int_t, local_int_t> GlobalToLocalMap;
-#else
-// for C++11 or greater
-#include <unordered_map>
-using GlobalToLocalMap = std::unordered_map<global_int_t, local_int_t>;
-#endif
+#include "GlobalToLocalMap.hpp"
 
 #ifdef HPCG_WITH_MORPHEUS
 #include "morpheus/Morpheus_SparseMatrix.hpp"
@@ -197,6 +189,30 @@ inline void ReplaceMatrixDiagonal(SparseMatrix& A, Vector& diagonal) {
   for (local_int_t i = 0; i < A.localNumberOfRows; ++i) *(curDiagA[i]) = dv[i];
   return;
 }
+/*!
+  Deallocates the rows of one of the per-row arrays of the matrix and the array
+  of row pointers itself, provided it is not 0.
+
+  @param[inout] rows      The array of row pointers, set to 0 on exit
+  @param[in]    nrows     The number of rows
+  @param[in]    rowsOwned Whether the rows were allocated with the matrix
+ */
+template <typename T>
+inline void DeleteMatrixRows(T**& rows, local_int_t nrows,
+                             bool rowsOwned = true) {
+  if (rows == 0) return;
+  if (rowsOwned && nrows > 0) {
+#if !defined(HPCG_CONTIGUOUS_ARRAYS) && \
+    !defined(HPCG_WITH_MORPHEUS_DIRECT_GENERATION)
+    for (local_int_t i = 0; i < nrows; ++i) delete[] rows[i];
+#else
+    delete[] rows[0];
+#endif
+  }
+  delete[] rows;
+  rows = 0;
+}
+
 /*!
   Deallocates the members of the data structure of the known system matrix
   provided they are not 0.
@@ -204,22 +220,17 @@ inline void ReplaceMatrixDiagonal(SparseMatrix& A, Vector& diagonal) {
   @param[in] A the known system matrix
  */
 inline void DeleteMatrix(SparseMatrix& A) {
-#ifndef HPCG_CONTIGUOUS_ARRAYS
-  for (local_int_t i = 0; i < A.localNumberOfRows; ++i) {
-    delete[] A.matrixValues[i];
-    delete[] A.mtxIndG[i];
-    delete[] A.mtxIndL[i];
-  }
+#if defined(HPCG_WITH_MORPHEUS_DIRECT_GENERATION)
+  // Rows are owned by the Morpheus matrix, except the global column ids
+  const bool rowsOwned = false;
 #else
-  delete[] A.matrixValues[0];
-  delete[] A.mtxIndG[0];
-  delete[] A.mtxIndL[0];
+  const bool rowsOwned = true;
 #endif
+  DeleteMatrixRows(A.matrixValues, A.localNumberOfRows, rowsOwned);
+  DeleteMatrixRows(A.mtxIndG, A.localNumberOfRows);
+  DeleteMatrixRows(A.mtxIndL, A.localNumberOfRows, rowsOwned);
   if (A.title) delete[] A.title;
   if (A.nonzerosInRow) delete[] A.nonzerosInRow;
-  if (A.mtxIndG) delete[] A.mtxIndG;
-  if (A.mtxIndL) delete[] A.mtxIndL;
-  if (A.matrixValues) delete[] A.matrixValues;
   if (A.matrixDiagonal) delete[] A.matrixDiagonal;
 
 #ifndef HPCG_NO_MPI
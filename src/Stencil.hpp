@@ -0,0 +1,169 @@
+/**
+ * Stencil.hpp
+ *
+ * EPCC, The University of Edinburgh
+ *
+ * (c) 2022 The University of Edinburgh
+ *
+ * Contributing Authors:
+ * Christodoulos Stylianou (c.stylianou@ed.ac.uk)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*!
+ @file Stencil.hpp
+
+ HPCG routines for the coefficients of the generated operators
+ */
+
+#ifndef STENCIL_HPP
+#define STENCIL_HPP
+
+#include <cmath>
+#include "Geometry.hpp"
+
+/*!
+  Values of one row of a generated matrix, indexed by the offset of the column
+  from the row, see StencilIndex. Offsets outside the stencil hold zero.
+*/
+struct StencilValues_STRUCT {
+  double value[27];
+};
+typedef struct StencilValues_STRUCT StencilValues;
+
+/*!
+  Sets the stencil of the benchmark: 27 points with the same constant
+  couplings in every direction, i.e. 26 on the diagonal and -1 elsewhere.
+
+  @param[out] stencil The stencil to initialize
+*/
+inline void InitializeStencil(Stencil& stencil) {
+  stencil.points   = 27;
+  stencil.ax       = 1.0;
+  stencil.ay       = 1.0;
+  stencil.az       = 1.0;
+  stencil.variable = 0;
+}
+
+/*!
+  Returns the index in StencilValues of the offset (sx, sy, sz), each in the
+  range [-1, 1].
+*/
+inline int StencilIndex(int sx, int sy, int sz) {
+  return (sz + 1) * 9 + (sy + 1) * 3 + sx + 1;
+}
+
+/*!
+  Computes the row values of a stencil with constant coefficients. A neighbor
+  is coupled with the mean strength of the directions it lies in, and the
+  diagonal is the sum of the couplings to all the points of the stencil, also
+  those outside the domain. The matrix is then symmetric and diagonally
+  dominant, and strictly so on the boundary, hence positive definite.
+
+  @param[in]  stencil The stencil of the generated operator
+  @param[out] values  The row values
+*/
+inline void InitializeStencilValues(const Stencil& stencil,
+                                    StencilValues& values) {
+  double diagonal = 0.0;
+  for (int sz = -1; sz <= 1; sz++) {
+    for (int sy = -1; sy <= 1; sy++) {
+      for (int sx = -1; sx <= 1; sx++) {
+        const int distance = (sx != 0) + (sy != 0) + (sz != 0);
+        double& value      = values.value[StencilIndex(sx, sy, sz)];
+        if (distance == 0 || (stencil.points == 7 && distance > 1)) {
+          value = 0.0;
+          continue;
+        }
+        const double coupling =
+            ((sx != 0 ? stencil.ax : 0.0) + (sy != 0 ? stencil.ay : 0.0) +
+             (sz != 0 ? stencil.az : 0.0)) /
+            distance;
+        value = -coupling;
+        diagonal += coupling;
+      }
+    }
+  }
+  values.value[StencilIndex(0, 0, 0)] = diagonal;
+}
+
+/*!
+  Smoothly varying coefficient along one dimension, between 1 and the cube
+  root of 10 inside the domain. It is evaluated at the midpoint between the
+  grid point gi and its neighbor at offset s, which is the same point seen
+  from either end, so the couplings remain symmetric.
+*/
+inline double StencilProfile(global_int_t gi, int s, global_int_t gn) {
+  const double pi = 3.14159265358979323846;
+  const double t  = (double)(2 * gi + s + 1) / (double)(2 * gn);
+  return std::exp(std::log(10.0) / 3.0 * std::sin(pi * t));
+}
+
+/*!
+  Returns the values of the row of the grid point (gix, giy, giz). With
+  variable coefficients the couplings of the constant stencil are scaled by
+  the product of the profiles of the three dimensions, which ranges from 1 on
+  the boundary to 10 in the center of the domain, and the point values are
+  computed into point. Otherwise the constant values are returned.
+
+  @param[in]  geom     The geometry of the generated operator
+  @param[in]  constant The values from InitializeStencilValues
+  @param[in]  gix, giy, giz The global coordinates of the grid point
+  @param[out] point    Storage for the values of a varying stencil
+
+  @return The values of the row
+*/
+inline const StencilValues& ComputeStencilValues(const Geometry& geom,
+                                                 const StencilValues& constant,
+                                                 global_int_t gix,
+                                                 global_int_t giy,
+                                                 global_int_t giz,
+                                                 StencilValues& point) {
+  if (!geom.stencil.variable) return constant;
+
+  double px[3], py[3], pz[3];
+  for (int s = -1; s <= 1; s++) {
+    px[s + 1] = StencilProfile(gix, s, geom.gnx);
+    py[s + 1] = StencilProfile(giy, s, geom.gny);
+    pz[s + 1] = StencilProfile(giz, s, geom.gnz);
+  }
+
+  double diagonal = 0.0;
+  for (int sz = -1; sz <= 1; sz++) {
+    for (int sy = -1; sy <= 1; sy++) {
+      for (int sx = -1; sx <= 1; sx++) {
+        const int k = StencilIndex(sx, sy, sz);
+        if (k == StencilIndex(0, 0, 0)) continue;
+        point.value[k] =
+            constant.value[k] * (px[sx + 1] * py[sy + 1] * pz[sz + 1]);
+        diagonal -= point.value[k];
+      }
+    }
+  }
+  point.value[StencilIndex(0, 0, 0)] = diagonal;
+  return point;
+}
+
+/*!
+  Returns an upper bound of the infinity norm of the generated matrix, i.e.
+  twice its largest diagonal value.
+*/
+inline double StencilNormBound(const Stencil& stencil) {
+  StencilValues values;
+  InitializeStencilValues(stencil, values);
+  const double diagonal = values.value[StencilIndex(0, 0, 0)];
+  return 2.0 * diagonal * (stencil.variable ? 10.0 : 1.0);
+}
+
+#endif  // STENCIL_HPP
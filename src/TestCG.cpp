@@ -68,12 +68,43 @@ using std::endl;
 
 #include "TestCG.hpp"
 #include "CG.hpp"
+#include "MGData.hpp"
+#include "Stencil.hpp"
 
 #ifdef HPCG_WITH_MORPHEUS
 #include "morpheus/Morpheus_VectorRoutines.hpp"
 #include "morpheus/Morpheus_SparseMatrixRoutines.hpp"
+#include "morpheus/Morpheus_LeanMode.hpp"
 #endif  // HPCG_WITH_MORPHEUS
 
+/*!
+  Replaces the diagonal of every coarse level of A. Galerkin coarse operators
+  are derived from the fine operator, so they have to follow its exaggerated
+  diagonal; otherwise the coarse corrections of the preconditioned runs are
+  out of scale with the fine level.
+
+  @param[inout] A         The fine level matrix
+  @param[inout] diagonals On entry: the new diagonals, coarsest level last;
+                          on exit: the previous diagonals
+*/
+static void SwapCoarseDiagonals(SparseMatrix& A,
+                                std::vector<Vector>& diagonals) {
+  SparseMatrix* Ac = A.Ac;
+  for (size_t level = 0; level < diagonals.size(); ++level, Ac = Ac->Ac) {
+    Vector previous;
+    InitializeVector(previous, Ac->localNumberOfRows);
+#ifdef HPCG_WITH_MORPHEUS
+    MorpheusCopyMatrixDiagonal(*Ac, previous);
+    MorpheusReplaceMatrixDiagonal(*Ac, diagonals[level]);
+#else
+    CopyMatrixDiagonal(*Ac, previous);
+#endif  // HPCG_WITH_MORPHEUS
+    if (Ac->matrixDiagonal) ReplaceMatrixDiagonal(*Ac, diagonals[level]);
+    DeleteVector(diagonals[level]);
+    diagonals[level] = previous;
+  }
+}
+
 /*!
   Test the correctness of the Preconditined CG implementation by using a system
   matrix with a dominant diagonal.
@@ -101,25 +132,56 @@ int TestCG(SparseMatrix& A, CGData& data, Vector& b, Vector& x,
   InitializeVector(origDiagA, A.localNumberOfRows);
   InitializeVector(exaggeratedDiagA, A.localNumberOfRows);
   InitializeVector(origB, A.localNumberOfRows);
+#ifdef HPCG_WITH_MORPHEUS
+  MorpheusCopyMatrixDiagonal(A, origDiagA);
+#else
   CopyMatrixDiagonal(A, origDiagA);
+#endif  // HPCG_WITH_MORPHEUS
   CopyVector(origDiagA, exaggeratedDiagA);
   CopyVector(b, origB);
 
   // Modify the matrix diagonal to greatly exaggerate diagonal values.
   // CG should converge in about 10 iterations for this problem, regardless of
-  // problem size
+  // problem size. The exaggerated values scale the diagonal of the constant
+  // stencil, so that variable coefficients do not spread them.
+  StencilValues stencil;
+  InitializeStencilValues(A.geom->stencil, stencil);
+  const double diagonal = stencil.value[StencilIndex(0, 0, 0)];
   for (local_int_t i = 0; i < A.localNumberOfRows; ++i) {
+#ifdef HPCG_WITH_MORPHEUS
+    global_int_t globalRowID = MorpheusGlobalRow(A, i);
+#else
     global_int_t globalRowID = A.localToGlobalMap[i];
+#endif  // HPCG_WITH_MORPHEUS
     if (globalRowID < 9) {
       double scale = (globalRowID + 2) * 1.0e6;
-      ScaleVectorValue(exaggeratedDiagA, i, scale);
+      exaggeratedDiagA.values[i] = diagonal * scale;
       ScaleVectorValue(b, i, scale);
     } else {
-      ScaleVectorValue(exaggeratedDiagA, i, 1.0e6);
+      exaggeratedDiagA.values[i] = diagonal * 1.0e6;
       ScaleVectorValue(b, i, 1.0e6);
     }
   }
-  ReplaceMatrixDiagonal(A, exaggeratedDiagA);
+  // Lean mode may have released the reference rows
+  if (A.matrixDiagonal) ReplaceMatrixDiagonal(A, exaggeratedDiagA);
+
+  // Galerkin coarse levels get the same exaggeration of their own diagonal
+  std::vector<Vector> coarseDiagonals;
+  if (A.mgData != 0 && A.mgData->coarseOperator != HPCG_GEOMETRIC_COARSE) {
+    for (SparseMatrix* Ac = A.Ac; Ac != 0; Ac = Ac->Ac) {
+      Vector scaled;
+      InitializeVector(scaled, Ac->localNumberOfRows);
+#ifdef HPCG_WITH_MORPHEUS
+      MorpheusCopyMatrixDiagonal(*Ac, scaled);
+#else
+      CopyMatrixDiagonal(*Ac, scaled);
+#endif  // HPCG_WITH_MORPHEUS
+      for (local_int_t i = 0; i < scaled.localLength; ++i)
+        scaled.values[i] *= 1.0e6;
+      coarseDiagonals.push_back(scaled);
+    }
+    SwapCoarseDiagonals(A, coarseDiagonals);
+  }
 
 #ifdef HPCG_WITH_MORPHEUS
   using Vector_t = HPCG_Morpheus_Vec<Morpheus::value_type>;
@@ -178,8 +240,11 @@ int TestCG(SparseMatrix& A, CGData& data, Vector& b, Vector& x,
   }
 
   // Restore matrix diagonal and RHS
-  ReplaceMatrixDiagonal(A, origDiagA);
+  if (A.matrixDiagonal) ReplaceMatrixDiagonal(A, origDiagA);
   CopyVector(origB, b);
+  SwapCoarseDiagonals(A, coarseDiagonals);
+  for (size_t level = 0; level < coarseDiagonals.size(); ++level)
+    DeleteVector(coarseDiagonals[level]);
 
 #ifdef HPCG_WITH_MORPHEUS
   using mirror = typename Morpheus::Vector<Morpheus::value_type>::HostMirror;
@@ -66,11 +66,14 @@ using std::endl;
 #include "hpcg.hpp"
 
 #include "ComputeSPMV.hpp"
+#include "ComputeSPMM.hpp"
 #include "ComputeMG.hpp"
 #include "ComputeDotProduct.hpp"
 #include "ComputeResidual.hpp"
 #include "Geometry.hpp"
+#include "MultiVector.hpp"
 #include "SparseMatrix.hpp"
+#include "Stencil.hpp"
 #include "TestSymmetry.hpp"
 
 #ifdef HPCG_WITH_MORPHEUS
@@ -94,6 +97,7 @@ using std::endl;
   @see ComputeDotProduct_ref
   @see ComputeSPMV
   @see ComputeSPMV_ref
+  @see ComputeSPMM
   @see ComputeMG
   @see ComputeMG_ref
 */
@@ -117,7 +121,7 @@ int TestSymmetry(SparseMatrix& A, Vector& b, Vector& xexact,
   FillRandomVector(y_ncol);
 
   double xNorm2, yNorm2;
-  double ANorm = 2 * 26.0;
+  double ANorm = StencilNormBound(A.geom->stencil);
 
 #ifdef HPCG_WITH_MORPHEUS
   MorpheusInitializeVector(x_ncol);
@@ -214,6 +218,61 @@ int TestSymmetry(SparseMatrix& A, Vector& b, Vector& xexact,
       HPCG_fout << "SpMV call [" << i << "] Residual [" << residual << "]"
                 << endl;
   }
+
+  // Test the multi-vector product against one SpMV per vector
+  const int numberOfVectors = 4;
+  MultiVector X_ncol, Y_nrow;
+  InitializeMultiVector(X_ncol, ncol, numberOfVectors);
+  InitializeMultiVector(Y_nrow, nrow, numberOfVectors);
+  for (int v = 0; v < numberOfVectors; ++v) {
+    FillRandomVector(x_ncol);
+    CopyVectorToMultiVector(x_ncol, X_ncol, v);
+  }
+#ifdef HPCG_WITH_MORPHEUS
+  MorpheusInitializeMultiVector(X_ncol);
+  MorpheusInitializeMultiVector(Y_nrow);
+  MorpheusOptimizeMultiVector(X_ncol);
+  MorpheusOptimizeMultiVector(Y_nrow);
+#endif
+
+  ierr = ComputeSPMM(A, X_ncol, Y_nrow);  // Y_nrow = A*X_overlap
+  if (ierr) HPCG_fout << "Error in call to SpMM: " << ierr << ".\n" << endl;
+#ifdef HPCG_WITH_MORPHEUS
+  Vector_t* Yopt = (Vector_t*)Y_nrow.optimizationData;
+  Morpheus::copy(Yopt->values.dev, Yopt->values.host);
+#endif
+
+  double spmmDeparture = 0.0;
+  for (int v = 0; v < numberOfVectors; ++v) {
+    CopyMultiVectorToVector(X_ncol, v, x_ncol);
+#ifdef HPCG_WITH_MORPHEUS
+    Morpheus::copy(xncolopt->values.host, xncolopt->values.dev);
+#endif
+    ierr = ComputeSPMV(A, x_ncol, z_ncol);  // z_nrow = A*x_overlap
+    if (ierr) HPCG_fout << "Error in call to SpMV: " << ierr << ".\n" << endl;
+#ifdef HPCG_WITH_MORPHEUS
+    Morpheus::copy(zncolopt->values.dev, zncolopt->values.host);
+#endif
+    for (local_int_t i = 0; i < nrow; ++i) {
+      const double d =
+          std::fabs(z_ncol.values[i] - Y_nrow.values[i * numberOfVectors + v]);
+      if (d > spmmDeparture) spmmDeparture = d;
+    }
+  }
+#ifndef HPCG_NO_MPI
+  MPI_Allreduce(MPI_IN_PLACE, &spmmDeparture, 1, MPI_DOUBLE, MPI_MAX,
+                MPI_COMM_WORLD);
+#endif
+  // Both products round each of the stencil terms of a row
+  testsymmetry_data.depspmm =
+      spmmDeparture / (A.geom->stencil.points * ANorm * DBL_EPSILON);
+  if (testsymmetry_data.depspmm > 1.0) ++testsymmetry_data.count_fail;
+  if (A.geom->rank == 0)
+    HPCG_fout << "Departure (scaled) of SpMM from SpMV max(abs(A*X - [A*x])) = "
+              << testsymmetry_data.depspmm << endl;
+
+  DeleteMultiVector(X_ncol);
+  DeleteMultiVector(Y_nrow);
   DeleteVector(x_ncol);
   DeleteVector(y_ncol);
   DeleteVector(z_ncol);
@@ -56,6 +56,7 @@
 #define HPCG_HPP
 
 #include <fstream>
+#include <string>
 #include "Geometry.hpp"
 
 extern std::ofstream HPCG_fout;
@@ -77,6 +78,11 @@ struct HPCG_Params_STRUCT {
       zl;  //!< nz for processors in the z dimension with value less than pz
   local_int_t
       zu;  //!< nz for processors in the z dimension with value greater than pz
+  std::string saveProblem;  //!< Prefix of the checkpoint files to write
+  std::string loadProblem;  //!< Prefix of the checkpoint files to read
+  std::string matrixFile;   //!< Matrix to read instead of generating one
+  Stencil stencil;          //!< Operator generated on the grid
+  int coarseOperator;       //!< How the coarse operators of MG are built
 };
 /*!
   HPCG_Params is a shorthand for HPCG_Params_STRUCT
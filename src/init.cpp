@@ -72,10 +72,15 @@ const char *NULLDEVICE = "/dev/null";
 #include "hpcg.hpp"
 
 #include "ReadHpcgDat.hpp"
+#include "MGData.hpp"
+#include "Stencil.hpp"
 
 #if defined(HPCG_WITH_MORPHEUS)
 #include "morpheus/Morpheus.hpp"
 #include "morpheus/Morpheus_Parser.hpp"
+#if defined(HPCG_WITH_MORPHEUS_DYNAMIC)
+#include "morpheus/Morpheus_MatrixCache.hpp"
+#endif  // HPCG_WITH_MORPHEUS_DYNAMIC
 #endif  // HPCG_WITH_MORPHEUS
 
 std::ofstream
@@ -119,6 +124,7 @@ int HPCG_Init(int *argc_p, char ***argv_p, HPCG_Params &params) {
   bool broadcastParams = false;  // Make true if parameters read from file.
 
   iparams = (int *)malloc(sizeof(int) * nparams);
+  InitializeStencil(params.stencil);
 
   // Initialize iparams
   for (i = 0; i < nparams; ++i) iparams[i] = 0;
@@ -146,7 +152,7 @@ int HPCG_Init(int *argc_p, char ***argv_p, HPCG_Params &params) {
              // read it from file
   if (!iparams[0] && !iparams[1] &&
       !iparams[2]) { /* no geometry arguments on the command line */
-    ReadHpcgDat(iparams, rt, iparams + 7);
+    ReadHpcgDat(iparams, rt, iparams + 7, &params.stencil);
     broadcastParams = true;
   }
 
@@ -165,6 +171,7 @@ int HPCG_Init(int *argc_p, char ***argv_p, HPCG_Params &params) {
 #ifndef HPCG_NO_MPI
   if (broadcastParams) {
     MPI_Bcast(iparams, nparams, MPI_INT, 0, MPI_COMM_WORLD);
+    MPI_Bcast(&params.stencil, sizeof(Stencil), MPI_BYTE, 0, MPI_COMM_WORLD);
   }
 #endif
 
@@ -181,6 +188,69 @@ int HPCG_Init(int *argc_p, char ***argv_p, HPCG_Params &params) {
   params.npy = iparams[8];
   params.npz = iparams[9];
 
+  // Prefixes of the per-process problem checkpoints and the path of an
+  // external matrix, empty when not given
+  for (i = 1; i <= argc && argv[i]; ++i) {
+    if (startswith(argv[i], "--save-problem="))
+      params.saveProblem = argv[i] + strlen("--save-problem=");
+    if (startswith(argv[i], "--load-problem="))
+      params.loadProblem = argv[i] + strlen("--load-problem=");
+    if (startswith(argv[i], "--matrix="))
+      params.matrixFile = argv[i] + strlen("--matrix=");
+  }
+
+  // The generated operator, which the command line overrides
+  for (i = 1; i <= argc && argv[i]; ++i) {
+    Stencil &stencil = params.stencil;
+    if (startswith(argv[i], "--stencil="))
+      sscanf(argv[i] + strlen("--stencil="), "%d", &stencil.points);
+    if (startswith(argv[i], "--anisotropy="))
+      sscanf(argv[i] + strlen("--anisotropy="), "%lf,%lf,%lf", &stencil.ax,
+             &stencil.ay, &stencil.az);
+    if (startswith(argv[i], "--coefficients="))
+      stencil.variable =
+          strcmp(argv[i] + strlen("--coefficients="), "variable") == 0;
+  }
+  // Values that cannot be used are replaced, and rank 0 reports them once
+  // the log file is open
+  std::string warnings;
+  if (params.stencil.points != 7 && params.stencil.points != 27) {
+    warnings += "Unsupported stencil of " +
+                std::to_string(params.stencil.points) +
+                " points, using 27 points instead\n";
+    params.stencil.points = 27;
+  }
+  if (!(params.stencil.ax > 0.0 && params.stencil.ay > 0.0 &&
+        params.stencil.az > 0.0)) {
+    warnings += "Anisotropy has to be positive, using 1 where it is not\n";
+  }
+  if (!(params.stencil.ax > 0.0)) params.stencil.ax = 1.0;
+  if (!(params.stencil.ay > 0.0)) params.stencil.ay = 1.0;
+  if (!(params.stencil.az > 0.0)) params.stencil.az = 1.0;
+
+  // Coarse operators regenerated on the coarse grids unless Galerkin ones
+  // are asked for
+  params.coarseOperator = HPCG_GEOMETRIC_COARSE;
+  for (i = 1; i <= argc && argv[i]; ++i) {
+    if (!startswith(argv[i], "--galerkin")) continue;
+    if (strcmp(argv[i], "--galerkin=injection") == 0)
+      params.coarseOperator = HPCG_GALERKIN_INJECTION;
+    else if (strcmp(argv[i], "--galerkin=full-weighting") == 0)
+      params.coarseOperator = HPCG_GALERKIN_FULL_WEIGHTING;
+    else
+      warnings += "Ignoring " + std::string(argv[i]) +
+                  ", expected --galerkin=injection or "
+                  "--galerkin=full-weighting\n";
+  }
+#if defined(HPCG_WITH_MORPHEUS_DIRECT_GENERATION)
+  // The coarse rows have to be generated in the Morpheus matrices
+  if (params.coarseOperator != HPCG_GEOMETRIC_COARSE)
+    warnings +=
+        "Galerkin coarse operators are not available with direct "
+        "generation, using the geometric ones instead\n";
+  params.coarseOperator = HPCG_GEOMETRIC_COARSE;
+#endif
+
 #ifndef HPCG_NO_MPI
   MPI_Comm_rank(MPI_COMM_WORLD, &params.comm_rank);
   MPI_Comm_size(MPI_COMM_WORLD, &params.comm_size);
@@ -217,12 +287,20 @@ int HPCG_Init(int *argc_p, char ***argv_p, HPCG_Params &params) {
 
   free(iparams);
 
+  if (0 == params.comm_rank && !warnings.empty()) {
+    std::cerr << warnings;
+    HPCG_fout << warnings;
+  }
+
 #if defined(HPCG_WITH_MORPHEUS)
 #if defined(HPCG_WITH_MULTI_FORMATS)
   ParseInputFileFormats(argc, argv);
 #endif
 
   ParseFormats(argc, argv);
+#if defined(HPCG_WITH_MORPHEUS_DYNAMIC)
+  MorpheusSetMatrixCacheSource(params);
+#endif  // HPCG_WITH_MORPHEUS_DYNAMIC
 #endif  // HPCG_WITH_MORPHEUS
 
   return 0;
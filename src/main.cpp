@@ -79,8 +79,11 @@ using std::endl;
 #include "CheckProblem.hpp"
 #include "ExchangeHalo.hpp"
 #include "OptimizeProblem.hpp"
+#include "ProblemCheckpoint.hpp"
 #include "WriteProblem.hpp"
 #include "ReportResults.hpp"
+#include "RunExternalMatrix.hpp"
+#include "SetupProfile.hpp"
 #include "mytimer.hpp"
 #include "ComputeSPMV_ref.hpp"
 #include "ComputeMG_ref.hpp"
@@ -103,6 +106,12 @@ using std::endl;
 #if defined(HPCG_WITH_MULTI_FORMATS)
 #include "morpheus/Morpheus_Timer.hpp"
 #endif
+#if defined(HPCG_WITH_MULTI_FORMATS) && defined(HPCG_WITH_MORPHEUS_DYNAMIC)
+#include "morpheus/Morpheus_AdaptiveFormats.hpp"
+#endif
+#if defined(HPCG_WITH_MORPHEUS_DYNAMIC)
+#include "morpheus/Morpheus_FormatSweep.hpp"
+#endif
 
 Morpheus::InitArguments args;
 #endif  // HPCG_WITH_MORPHEUS
@@ -150,6 +159,19 @@ int main(int argc, char* argv[]) {
   MORPHEUS_START_SCOPE();
 #endif  // HPCG_WITH_MORPHEUS
 
+  // A matrix read from a file replaces the problem and its MG hierarchy
+  if (!params.matrixFile.empty()) {
+    int ierr = RunExternalMatrix(params);
+#ifdef HPCG_WITH_MORPHEUS
+    Morpheus::finalize();
+#endif  // HPCG_WITH_MORPHEUS
+    HPCG_Finalize();
+#ifndef HPCG_NO_MPI
+    MPI_Finalize();
+#endif
+    return ierr;
+  }
+
 #ifdef HPCG_DETAILED_DEBUG
   if (size < 100 && rank == 0)
     HPCG_fout << "Process " << rank << " of " << size << " is alive with "
@@ -177,10 +199,13 @@ int main(int argc, char* argv[]) {
 #endif
 
   // Construct the geometry and linear system
+  StartSetupPhase("GenerateGeometry");
   Geometry* geom = new Geometry;
   GenerateGeometry(size, rank, params.numThreads, params.pz, params.zl,
                    params.zu, nx, ny, nz, params.npx, params.npy, params.npz,
                    geom);
+  geom->stencil = params.stencil;
+  StopSetupPhase();
 
   ierr = CheckAspectRatio(0.125, geom->npx, geom->npy, geom->npz,
                           "process grid", rank == 0);
@@ -195,25 +220,48 @@ int main(int argc, char* argv[]) {
   InitializeSparseMatrix(A, geom);
 
   Vector b, x, xexact;
-  GenerateProblem(A, &b, &x, &xexact);
-  SetupHalo(A);
-  int numberOfMgLevels         = 4;  // Number of levels including first
-  SparseMatrix* curLevelMatrix = &A;
-  for (int level = 1; level < numberOfMgLevels; ++level) {
-    GenerateCoarseProblem(*curLevelMatrix);
-    curLevelMatrix =
-        curLevelMatrix
-            ->Ac;  // Make the just-constructed coarse grid the next level
+  int numberOfMgLevels = 4;  // Number of levels including first
+  // A checkpoint of an earlier run replaces generation, halo setup and checks
+  bool problemLoaded = false;
+  if (!params.loadProblem.empty()) {
+    StartSetupPhase("LoadProblem");
+    problemLoaded =
+        LoadProblem(params.loadProblem, numberOfMgLevels,
+                    params.coarseOperator, A, b, x, xexact) == 0;
+    StopSetupPhase();
+  }
+  if (!problemLoaded) {
+    StartSetupPhase("GenerateProblem");
+    GenerateProblem(A, &b, &x, &xexact);
+    StopSetupPhase();
+    StartSetupPhase("SetupHalo");
+    SetupHalo(A);
+    StopSetupPhase();
+    // The coarse levels only depend on the fine geometry, build them together
+    StartSetupPhase("GenerateCoarseProblems");
+    GenerateCoarseProblems(A, numberOfMgLevels - 1, params.coarseOperator);
+    StopSetupPhase();
   }
 
   setup_time = mytimer() - setup_time;  // Capture total time of setup
   times[9]   = setup_time;              // Save it for reporting
 
-  curLevelMatrix    = &A;
-  Vector* curb      = &b;
-  Vector* curx      = &x;
-  Vector* curxexact = &xexact;
-  for (int level = 0; level < numberOfMgLevels; ++level) {
+  if (!problemLoaded && !params.saveProblem.empty()) {
+    StartSetupPhase("SaveProblem");
+    ierr = SaveProblem(params.saveProblem, A, b, x, xexact);
+    if (ierr)
+      HPCG_fout << "Error in call to SaveProblem: " << ierr << ".\n" << endl;
+    StopSetupPhase();
+  }
+
+  SparseMatrix* curLevelMatrix = &A;
+  Vector* curb                 = &b;
+  Vector* curx                 = &x;
+  Vector* curxexact            = &xexact;
+  if (!problemLoaded) StartSetupPhase("CheckProblem");
+  for (int level = 0; level < numberOfMgLevels && !problemLoaded; ++level) {
+    // Galerkin coarse operators are not the generated ones the check expects
+    if (level > 0 && params.coarseOperator != HPCG_GEOMETRIC_COARSE) break;
     CheckProblem(*curLevelMatrix, curb, curx, curxexact);
     curLevelMatrix =
         curLevelMatrix->Ac;  // Make the nextcoarse grid the next level
@@ -221,6 +269,7 @@ int main(int argc, char* argv[]) {
     curx      = 0;
     curxexact = 0;
   }
+  if (!problemLoaded) StopSetupPhase();
 
   CGData data;
   InitializeSparseCGData(A, data);
@@ -247,6 +296,7 @@ int main(int argc, char* argv[]) {
   if (quickPath)
     numberOfCalls = 1;  // QuickPath means we do on one call of each block of
                         // repetitive code
+  StartSetupPhase("Reference SpMV+MG timing");
   double t_begin = mytimer();
   for (int i = 0; i < numberOfCalls; ++i) {
     ierr =
@@ -258,6 +308,7 @@ int main(int argc, char* argv[]) {
   }
   times[8] = (mytimer() - t_begin) /
              ((double)numberOfCalls);  // Total time divided by number of calls.
+  StopSetupPhase();
 #ifdef HPCG_DEBUG
   if (rank == 0)
     HPCG_fout << "Total SpMV+MG timing phase execution time in main (sec) = "
@@ -286,6 +337,7 @@ int main(int argc, char* argv[]) {
   double tolerance =
       0.0;  // Set tolerance to zero to make all runs do maxIters iterations
   int err_count = 0;
+  StartSetupPhase("Reference CG");
   for (int i = 0; i < numberOfCalls; ++i) {
     ZeroVector(x);
     ierr = CG_ref(A, data, b, x, refMaxIters, tolerance, niters, normr, normr0,
@@ -293,14 +345,17 @@ int main(int argc, char* argv[]) {
     if (ierr) ++err_count;  // count the number of errors in CG
     totalNiters_ref += niters;
   }
+  StopSetupPhase();
   if (rank == 0 && err_count)
     HPCG_fout << err_count << " error(s) in call(s) to reference CG." << endl;
   double refTolerance = normr / normr0;
 
   // Call user-tunable set up function.
+  StartSetupPhase("OptimizeProblem");
   double t7 = mytimer();
   OptimizeProblem(A, data, b, x, xexact);
   t7       = mytimer() - t7;
+  StopSetupPhase();
   times[7] = t7;
 
 #ifdef HPCG_DEBUG
@@ -321,10 +376,14 @@ int main(int argc, char* argv[]) {
 #endif
   TestCGData testcg_data;
   testcg_data.count_pass = testcg_data.count_fail = 0;
+  StartSetupPhase("TestCG");
   TestCG(A, data, b, x, testcg_data);
+  StopSetupPhase();
 
   TestSymmetryData testsymmetry_data;
+  StartSetupPhase("TestSymmetry");
   TestSymmetry(A, b, xexact, testsymmetry_data);
+  StopSetupPhase();
 #ifdef HPCG_DEBUG
   if (rank == 0)
     HPCG_fout << "Total validation (TestCG and TestSymmetry) execution time in "
@@ -358,6 +417,7 @@ int main(int argc, char* argv[]) {
 
   // Compute the residual reduction and residual count for the user ordering and
   // optimized kernels.
+  StartSetupPhase("Optimized CG setup");
   for (int i = 0; i < numberOfCalls; ++i) {
 #ifdef HPCG_WITH_MORPHEUS
     MorpheusZeroVector(x);
@@ -377,6 +437,7 @@ int main(int argc, char* argv[]) {
     double current_time = opt_times[0] - last_cummulative_time;
     if (current_time > opt_worst_time) opt_worst_time = current_time;
   }
+  StopSetupPhase();
 
 #ifndef HPCG_NO_MPI
   // Get the absolute worst time across all MPI ranks (time in CG can be
@@ -434,6 +495,7 @@ int main(int argc, char* argv[]) {
     sub_mtimers[idx].CG         = 0;
     sub_mtimers[idx].SPMV_LOCAL = 0;
     sub_mtimers[idx].SPMV_GHOST = 0;
+    sub_mtimers[idx].SPMV_CALLS = 0;
   }
 #endif  // HPCG_WITH_MULTI_FORMATS
 #endif  // HPCG_WITH_MORPHEUS
@@ -452,6 +514,14 @@ int main(int argc, char* argv[]) {
                 << "]" << endl;
     testnorms_data.values[i] =
         normr / normr0;  // Record scaled residual from this run
+
+#if defined(HPCG_WITH_MORPHEUS) && defined(HPCG_WITH_MULTI_FORMATS) && \
+    defined(HPCG_WITH_MORPHEUS_DYNAMIC)
+#if !defined(HPCG_WITH_HYBRID_LOCAL) && !defined(HPCG_WITH_BLOCK_FORMATS)
+    // Between sets, once the first ones have been timed
+    if (i + 1 == adaptive_sets) MorpheusAdaptFormats(A);
+#endif
+#endif
   }
 
   // Compute difference between known exact solution and computed solution
@@ -489,6 +559,19 @@ int main(int argc, char* argv[]) {
 #if defined(HPCG_WITH_MULTI_FORMATS)
   ReportTimingResults();
 #endif  // HPCG_WITH_MULTI_FORMATS
+
+#if defined(HPCG_WITH_MORPHEUS_DYNAMIC) && \
+    !defined(HPCG_WITH_HYBRID_LOCAL) && !defined(HPCG_WITH_BLOCK_FORMATS)
+  // Time the same CG sets again in every requested format, reusing the
+  // generated and validated problem. Runs after the reports above, so the
+  // benchmark results are unaffected.
+  if (sweep_formats.size() > 0) {
+    ierr = MorpheusFormatSweep(A, data, b, x, numberOfCgSets, optMaxIters,
+                               enable_timed_mg);
+    if (ierr) HPCG_fout << "Error in call to format sweep: " << ierr << endl;
+    ReportSweepResults();
+  }
+#endif
 #endif  // HPCG_WITH_MORPHEUS
 
   // Clean up
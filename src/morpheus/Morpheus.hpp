@@ -27,6 +27,9 @@
 #ifdef HPCG_WITH_MORPHEUS
 #include <Morpheus_Core.hpp>
 #include "Geometry.hpp"  //local_int_t
+#include <string>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
 // TODO: Move this in Morpheus Core
@@ -35,18 +38,24 @@
 
 namespace Morpheus {
 // Define Morpheus Execution and Memory Spaces
+// HostExecSpace runs the setup work on host mirrors, e.g. assembly and
+// format conversions
 #if defined(HPCG_WITH_KOKKOS_SERIAL)
-using ExecSpace = Kokkos::Serial;
-using Space     = Kokkos::Serial;
+using ExecSpace     = Kokkos::Serial;
+using Space         = Kokkos::Serial;
+using HostExecSpace = Kokkos::Serial;
 #elif defined(HPCG_WITH_KOKKOS_OPENMP)
-using ExecSpace = Kokkos::OpenMP;
-using Space     = Kokkos::OpenMP;
+using ExecSpace     = Kokkos::OpenMP;
+using Space         = Kokkos::OpenMP;
+using HostExecSpace = Kokkos::OpenMP;
 #elif defined(HPCG_WITH_KOKKOS_CUDA)
-using ExecSpace = Kokkos::Cuda;
-using Space     = Kokkos::Cuda;
+using ExecSpace     = Kokkos::Cuda;
+using Space         = Kokkos::Cuda;
+using HostExecSpace = Kokkos::DefaultHostExecutionSpace;
 #elif defined(HPCG_WITH_KOKKOS_HIP)
-using ExecSpace = Kokkos::Experimental::HIP;
-using Space     = Kokkos::Experimental::HIP;
+using ExecSpace     = Kokkos::Experimental::HIP;
+using Space         = Kokkos::Experimental::HIP;
+using HostExecSpace = Kokkos::DefaultHostExecutionSpace;
 #endif
 
 using value_type = double;
@@ -61,6 +70,24 @@ extern int local_matrix_fmt;
 #if defined(HPCG_WITH_SPLIT_DISTRIBUTED)
 extern int ghost_matrix_fmt;
 #endif
+// Whether the reference arrays are released after OptimizeProblem
+extern int lean_mode;
+#ifdef HPCG_WITH_MORPHEUS_DYNAMIC
+// Number of timed SpMVs per candidate format, 0 disables autotuning
+extern int autotune_trials;
+// Whether the local formats are predicted from the matrix structure
+extern int predict_formats;
+// Local formats per MG level of each run of the format sweep
+extern std::vector<std::vector<int>> sweep_formats;
+// Bytes per process the matrices may occupy, 0 means unlimited
+extern double memory_budget;
+// Directory of the converted matrices reused across runs, empty disables
+extern std::string matrix_cache_dir;
+#ifdef HPCG_WITH_MULTI_FORMATS
+// Number of CG sets after which the local formats are revisited, 0 disables
+extern int adaptive_sets;
+#endif  // HPCG_WITH_MULTI_FORMATS
+#endif
 
 typedef struct format_id {
   global_int_t rank;
@@ -80,12 +107,41 @@ extern std::vector<format_report> local_morpheus_report, local_sub_report;
 #if defined(HPCG_WITH_SPLIT_DISTRIBUTED)
 extern std::vector<format_report> ghost_morpheus_report, ghost_sub_report;
 #endif  // HPCG_WITH_SPLIT_DISTRIBUTED
+#if defined(HPCG_WITH_HYBRID_LOCAL)
+extern std::vector<format_report> interior_morpheus_report,
+    interior_sub_report;
+extern std::vector<format_report> boundary_morpheus_report,
+    boundary_sub_report;
+#endif  // HPCG_WITH_HYBRID_LOCAL
+
+#if defined(HPCG_WITH_BLOCK_FORMATS)
+extern std::vector<format_report> block_morpheus_report, block_sub_report;
+#endif  // HPCG_WITH_BLOCK_FORMATS
 
 #ifdef HPCG_WITH_MULTI_FORMATS
-extern std::vector<format_id> local_input_file;
+// Rules of a formats file that apply to this process, by MG level. Every
+// entry keeps the priority of the most specific rule that set it: an exact
+// rank beats a rank range, which beats a wildcard, and for the same ranks an
+// exact level beats a rule for all levels.
+template <typename T>
+struct format_map_STRUCT {
+  std::unordered_map<int, std::pair<int, T>> levels;
+  std::pair<int, T> all_levels;  // negative priority when there is none
+
+  format_map_STRUCT() : all_levels(-1, T()) {}
+};
+
+template <typename T>
+using format_map = format_map_STRUCT<T>;
+
+extern format_map<int> local_input_file;
 #if defined(HPCG_WITH_SPLIT_DISTRIBUTED)
-extern std::vector<format_id> ghost_input_file;
+extern format_map<int> ghost_input_file;
 #endif  // HPCG_WITH_SPLIT_DISTRIBUTED
+#if defined(HPCG_WITH_BLOCK_FORMATS)
+// One format per contiguous row block of the local matrix
+extern format_map<std::vector<int>> local_block_input_file;
+#endif  // HPCG_WITH_BLOCK_FORMATS
 #endif  // HPCG_WITH_MULTI_FORMATS
 
 #endif  // HPCG_WITH_MORPHEUS
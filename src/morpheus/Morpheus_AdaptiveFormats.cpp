@@ -0,0 +1,196 @@
+/**
+ * Morpheus_AdaptiveFormats.cpp
+ *
+ * EPCC, The University of Edinburgh
+ *
+ * (c) 2022 The University of Edinburgh
+ *
+ * Contributing Authors:
+ * Christodoulos Stylianou (c.stylianou@ed.ac.uk)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "morpheus/Morpheus_AdaptiveFormats.hpp"
+
+#ifdef HPCG_WITH_MORPHEUS
+#if defined(HPCG_WITH_MULTI_FORMATS) && defined(HPCG_WITH_MORPHEUS_DYNAMIC)
+#include "morpheus/Morpheus_Autotune.hpp"
+#include "morpheus/Morpheus_MemoryBudget.hpp"
+#include "morpheus/Morpheus_SparseMatrixRoutines.hpp"
+#include "morpheus/Morpheus_Timer.hpp"
+
+#ifndef HPCG_NO_MPI
+#include <mpi.h>
+#endif
+
+#include <algorithm>
+#include <exception>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+// Process, MG_Level, Format, Measured and Trial time per nonzero, Switched
+const int adaptive_fields = 6;
+std::vector<double> adaptive_sub_report;
+
+#if !defined(HPCG_WITH_HYBRID_LOCAL) && !defined(HPCG_WITH_BLOCK_FORMATS)
+const int adaptive_formats[] = {Morpheus::COO_FORMAT, Morpheus::CSR_FORMAT,
+                                Morpheus::DIA_FORMAT};
+const int adaptive_trials = 10;
+// An alternative must take at most this fraction of the current time
+const double adaptive_margin = 0.9;
+
+void AdaptLocalFormat(SparseMatrix& A) {
+  HPCG_Morpheus_Mat* Aopt = (HPCG_Morpheus_Mat*)A.optimizationData;
+  const int level         = MorpheusSparseMatrixGetCoarseLevel(A);
+  const double nnz        = Aopt->local.dev.nnnz();
+
+  const morpheus_timers& timer = sub_mtimers[level];
+
+  if (timer.SPMV_CALLS == 0 || nnz == 0) return;
+
+  const int current     = Aopt->local.dev.active_index();
+  const double measured = timer.SPMV_LOCAL / timer.SPMV_CALLS / nnz;
+
+  // Diagonal updates may only have been applied on the device
+  Morpheus::copy(Aopt->local.dev, Aopt->local.host);
+  // The isolated trials run with warm caches, so the alternatives have to
+  // beat a trial of the current format as well as the measured time
+  const double baseline =
+      MorpheusTimeSpMV(Aopt->local, adaptive_trials) / nnz;
+  double best_time = adaptive_margin * std::min(measured, baseline);
+
+  Morpheus_Mat best;
+  int best_format    = current;
+  size_t best_report = 0;
+
+  // The alternatives compete for the bytes charged for the current format
+  MorpheusReleaseMemoryBudget(A);
+  typename Morpheus::Csr::HostMirror Acsr;
+  if (memory_budget > 0) {
+    Morpheus::convert<Morpheus::HostExecSpace>(Aopt->local.host, Acsr);
+  }
+
+  for (const int fmt : adaptive_formats) {
+    if (fmt == current) continue;
+
+    Morpheus_Mat trial;
+    double trial_time = -1.0;
+    // Formats over the memory budget are never allocated nor selected
+    if (MorpheusFitsMemoryBudget(Acsr, fmt)) {
+      try {
+        trial.host = Aopt->local.host;
+        MorpheusConvertTrial(fmt, trial);
+        trial_time = MorpheusTimeSpMV(trial, adaptive_trials) / nnz;
+      } catch (const std::exception&) {
+        trial_time = -1.0;
+      }
+    }
+
+    if (trial_time >= 0 && trial_time < best_time) {
+      best_time   = trial_time;
+      best_format = fmt;
+      best_report = adaptive_sub_report.size();
+      best        = trial;
+    }
+
+    double entry[adaptive_fields] = {
+        (double)MorpheusSparseMatrixGetRank(A),
+        (double)level,
+        (double)fmt,
+        measured,
+        trial_time,
+        0.0};
+    adaptive_sub_report.insert(adaptive_sub_report.end(), entry,
+                               entry + adaptive_fields);
+  }
+
+  if (best_format != current) {
+    Aopt->local = best;
+    adaptive_sub_report[best_report + adaptive_fields - 1] = 1.0;
+    // The format report describes the matrix the run ends with
+    local_sub_report[level] = MorpheusSparseMatrixGetLocalProperties(A);
+  }
+  MorpheusChargeMemoryBudget(A);
+}
+#endif  // !HPCG_WITH_HYBRID_LOCAL && !HPCG_WITH_BLOCK_FORMATS
+}  // namespace
+
+#if !defined(HPCG_WITH_HYBRID_LOCAL) && !defined(HPCG_WITH_BLOCK_FORMATS)
+void MorpheusAdaptFormats(SparseMatrix& A) {
+  SparseMatrix* M = &A;
+  while (M != 0) {
+    AdaptLocalFormat(*M);
+    M = M->Ac;
+  }
+}
+#endif  // !HPCG_WITH_HYBRID_LOCAL && !HPCG_WITH_BLOCK_FORMATS
+
+void ReportAdaptiveResults() {
+  if (adaptive_sets <= 0) return;
+
+  std::string eol = "\n", del = ",";
+  std::string result = "";
+  int rank           = 0;
+  std::vector<double> report;
+
+#ifndef HPCG_NO_MPI
+  int size = 1;
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  MPI_Comm_size(MPI_COMM_WORLD, &size);
+
+  int count = adaptive_sub_report.size();
+  std::vector<int> counts(size, 0), displs(size, 0);
+  MPI_Gather(&count, 1, MPI_INT, counts.data(), 1, MPI_INT, 0,
+             MPI_COMM_WORLD);
+
+  if (rank == 0) {
+    for (int p = 1; p < size; p++) displs[p] = displs[p - 1] + counts[p - 1];
+    report.resize(displs[size - 1] + counts[size - 1]);
+  }
+
+  MPI_Gatherv(adaptive_sub_report.data(), count, MPI_DOUBLE, report.data(),
+              counts.data(), displs.data(), MPI_DOUBLE, 0, MPI_COMM_WORLD);
+#else
+  report.assign(adaptive_sub_report.begin(), adaptive_sub_report.end());
+#endif
+
+  if (rank == 0) {
+    std::stringstream header;
+    header << "Process" << del << "MG_Level" << del << "Format" << del
+           << "Measured_Time_Per_Nnz(s)" << del << "Trial_Time_Per_Nnz(s)"
+           << del << "Switched";
+
+    result += header.str() + eol;
+    for (size_t i = 0; i < report.size(); i += adaptive_fields) {
+      const double* entry = &report[i];
+
+      std::stringstream val;
+      val << (int)entry[0] << del << (int)entry[1] << del << (int)entry[2]
+          << del << std::setprecision(14) << entry[3] << del << entry[4]
+          << del << (int)entry[5];
+
+      result += val.str() + eol;
+    }
+
+    std::ofstream out("morpheus-adaptive-output.txt");
+    out << result;
+  }
+}
+
+#endif  // HPCG_WITH_MULTI_FORMATS && HPCG_WITH_MORPHEUS_DYNAMIC
+#endif  // HPCG_WITH_MORPHEUS
@@ -0,0 +1,41 @@
+/**
+ * Morpheus_AdaptiveFormats.hpp
+ *
+ * EPCC, The University of Edinburgh
+ *
+ * (c) 2022 The University of Edinburgh
+ *
+ * Contributing Authors:
+ * Christodoulos Stylianou (c.stylianou@ed.ac.uk)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef HPCG_MORPHEUS_ADAPTIVE_FORMATS_HPP
+#define HPCG_MORPHEUS_ADAPTIVE_FORMATS_HPP
+
+#ifdef HPCG_WITH_MORPHEUS
+#if defined(HPCG_WITH_MULTI_FORMATS) && defined(HPCG_WITH_MORPHEUS_DYNAMIC)
+#include "SparseMatrix.hpp"
+
+#if !defined(HPCG_WITH_HYBRID_LOCAL) && !defined(HPCG_WITH_BLOCK_FORMATS)
+// Compares the SpMV time per nonzero measured so far on every level of A with
+// trials of the other formats on a separate copy, and switches the local
+// matrix of a level to an alternative that is clearly faster
+void MorpheusAdaptFormats(SparseMatrix& A);
+#endif  // !HPCG_WITH_HYBRID_LOCAL && !HPCG_WITH_BLOCK_FORMATS
+void ReportAdaptiveResults();
+
+#endif  // HPCG_WITH_MULTI_FORMATS && HPCG_WITH_MORPHEUS_DYNAMIC
+#endif  // HPCG_WITH_MORPHEUS
+#endif  // HPCG_MORPHEUS_ADAPTIVE_FORMATS_HPP
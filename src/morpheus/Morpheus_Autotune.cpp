@@ -0,0 +1,208 @@
+/**
+ * Morpheus_Autotune.cpp
+ *
+ * EPCC, The University of Edinburgh
+ *
+ * (c) 2022 The University of Edinburgh
+ *
+ * Contributing Authors:
+ * Christodoulos Stylianou (c.stylianou@ed.ac.uk)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "morpheus/Morpheus_Autotune.hpp"
+
+#ifdef HPCG_WITH_MORPHEUS
+#if defined(HPCG_WITH_MORPHEUS_DYNAMIC)
+#include "morpheus/Morpheus_MemoryBudget.hpp"
+#include "morpheus/Morpheus_NUMA.hpp"
+#include "morpheus/Morpheus_SparseMatrixRoutines.hpp"
+#include "morpheus/Morpheus_Timer.hpp"
+
+#ifndef HPCG_NO_MPI
+#include <mpi.h>
+#endif
+
+#include <exception>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+using value_type = Morpheus::value_type;
+
+const int autotune_formats[] = {Morpheus::COO_FORMAT, Morpheus::CSR_FORMAT,
+                                Morpheus::DIA_FORMAT};
+
+// Process, MG_Level, Format, Conversion, SpMV, Selected per candidate
+const int autotune_fields = 6;
+std::vector<double> autotune_sub_report;
+}  // namespace
+
+double MorpheusConvertTrial(int fmt, Morpheus_Mat& trial) {
+  double t0 = 0.0, convert_time = 0.0;
+
+  MTICK();
+  // In-place conversion w/ temporary allocation
+  Morpheus::convert<Morpheus::HostExecSpace>(trial.host, fmt);
+  MorpheusSendToDevice(trial);
+  MTOCK(convert_time);
+
+  return convert_time;
+}
+
+double MorpheusTimeSpMV(const Morpheus_Mat& M, int trials) {
+  typename Morpheus::Vector<value_type> x(M.dev.ncols(), 1.0);
+  typename Morpheus::Vector<value_type> y(M.dev.nrows(), 0.0);
+  double t0 = 0.0, spmv_time = 0.0;
+
+  // Untimed warm-up call, then the average of the timed ones
+  Morpheus::multiply<Morpheus::ExecSpace>(M.dev, x, y);
+  Kokkos::fence();
+  MTICK();
+  for (int t = 0; t < trials; t++) {
+    Morpheus::multiply<Morpheus::ExecSpace>(M.dev, x, y);
+  }
+  Kokkos::fence();
+  MTOCK(spmv_time);
+
+  return spmv_time / trials;
+}
+
+#if !defined(HPCG_WITH_HYBRID_LOCAL) && !defined(HPCG_WITH_BLOCK_FORMATS)
+void MorpheusAutotuneLocalMatrix(
+    SparseMatrix& A, const typename Morpheus::Csr::HostMirror& Acsr) {
+  HPCG_Morpheus_Mat* Aopt = (HPCG_Morpheus_Mat*)A.optimizationData;
+
+  double best_time   = std::numeric_limits<double>::max();
+  size_t best_report = autotune_sub_report.size();
+  int best_format    = -1;
+
+  for (const int fmt : autotune_formats) {
+    Morpheus_Mat trial;
+    double convert_time = 0.0, spmv_time = -1.0;
+
+    // Formats over the memory budget are never allocated nor selected
+    if (MorpheusFitsMemoryBudget(Acsr, fmt)) {
+      try {
+        trial.host   = Acsr;
+        convert_time = MorpheusConvertTrial(fmt, trial);
+        spmv_time    = MorpheusTimeSpMV(trial, autotune_trials);
+      } catch (const std::exception&) {
+        // Formats that cannot hold the matrix (e.g. too many diagonals) are
+        // reported with a negative time and never selected
+        spmv_time = -1.0;
+      }
+    }
+
+    if (spmv_time >= 0 && spmv_time < best_time) {
+      best_time   = spmv_time;
+      best_report = autotune_sub_report.size();
+      best_format = fmt;
+      Aopt->local = trial;
+    }
+
+    double entry[autotune_fields] = {
+        (double)MorpheusSparseMatrixGetRank(A),
+        (double)MorpheusSparseMatrixGetCoarseLevel(A),
+        (double)fmt,
+        convert_time,
+        spmv_time,
+        0.0};
+    autotune_sub_report.insert(autotune_sub_report.end(), entry,
+                               entry + autotune_fields);
+  }
+
+  if (best_format < 0) {
+    // Nothing fits the memory budget, keep the most compact format
+    Aopt->local.host = Acsr;
+    Morpheus::convert<Morpheus::HostExecSpace>(
+        Aopt->local.host, MorpheusFitMemoryBudget(Acsr, Morpheus::CSR_FORMAT));
+    MorpheusSendToDevice(Aopt->local);
+    return;
+  }
+
+  MorpheusFitMemoryBudget(Acsr, best_format);
+  autotune_sub_report[best_report + autotune_fields - 1] = 1.0;
+}
+#endif  // !HPCG_WITH_HYBRID_LOCAL && !HPCG_WITH_BLOCK_FORMATS
+
+void ReportAutotuneResults() {
+  if (autotune_trials <= 0) return;
+
+  std::string eol = "\n", del = ",";
+  std::string result = "";
+  int rank           = 0;
+  std::vector<double> report;
+
+#ifndef HPCG_NO_MPI
+  int size = 1;
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  MPI_Comm_size(MPI_COMM_WORLD, &size);
+
+  int count = autotune_sub_report.size();
+  std::vector<int> counts(size, 0), displs(size, 0);
+  MPI_Gather(&count, 1, MPI_INT, counts.data(), 1, MPI_INT, 0,
+             MPI_COMM_WORLD);
+
+  if (rank == 0) {
+    for (int p = 1; p < size; p++) displs[p] = displs[p - 1] + counts[p - 1];
+    report.resize(displs[size - 1] + counts[size - 1]);
+  }
+
+  MPI_Gatherv(autotune_sub_report.data(), count, MPI_DOUBLE, report.data(),
+              counts.data(), displs.data(), MPI_DOUBLE, 0, MPI_COMM_WORLD);
+#else
+  report.assign(autotune_sub_report.begin(), autotune_sub_report.end());
+#endif
+
+  if (rank == 0) {
+    std::stringstream header;
+    header << "Process" << del << "MG_Level" << del << "Format" << del
+           << "Conversion_Time(s)" << del << "SpMV_Time(s)" << del
+           << "Selected";
+
+    result += header.str() + eol;
+    // Setup cost of the autotuning, kept apart from the benchmark time
+    double convert_total = 0.0, trial_total = 0.0;
+    for (size_t i = 0; i < report.size(); i += autotune_fields) {
+      const double* entry = &report[i];
+
+      std::stringstream val;
+      val << (int)entry[0] << del << (int)entry[1] << del << (int)entry[2]
+          << del << std::setprecision(14) << entry[3] << del << entry[4]
+          << del << (int)entry[5];
+
+      result += val.str() + eol;
+
+      convert_total += entry[3];
+      if (entry[4] > 0) trial_total += (autotune_trials + 1) * entry[4];
+    }
+
+    std::ofstream out("morpheus-autotune-output.txt");
+    out << result;
+
+    std::cout << "Format autotuning: " << trial_total
+              << " seconds of SpMV trials and " << convert_total
+              << " seconds of conversions summed over all processes"
+              << std::endl;
+  }
+}
+
+#endif  // HPCG_WITH_MORPHEUS_DYNAMIC
+#endif  // HPCG_WITH_MORPHEUS
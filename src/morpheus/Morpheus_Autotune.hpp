@@ -0,0 +1,48 @@
+/**
+ * Morpheus_Autotune.hpp
+ *
+ * EPCC, The University of Edinburgh
+ *
+ * (c) 2022 The University of Edinburgh
+ *
+ * Contributing Authors:
+ * Christodoulos Stylianou (c.stylianou@ed.ac.uk)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef HPCG_MORPHEUS_AUTOTUNE_HPP
+#define HPCG_MORPHEUS_AUTOTUNE_HPP
+
+#ifdef HPCG_WITH_MORPHEUS
+#if defined(HPCG_WITH_MORPHEUS_DYNAMIC)
+#include "SparseMatrix.hpp"
+#include "morpheus/Morpheus_SparseMatrix.hpp"
+
+// Converts trial.host in place to fmt and sends it to the device, returning
+// the seconds spent
+double MorpheusConvertTrial(int fmt, Morpheus_Mat& trial);
+// Average seconds of one SpMV with M, after an untimed warm-up call
+double MorpheusTimeSpMV(const Morpheus_Mat& M, int trials);
+
+#if !defined(HPCG_WITH_HYBRID_LOCAL) && !defined(HPCG_WITH_BLOCK_FORMATS)
+// Converts the local rows to every candidate format, times a few SpMVs with
+// each and keeps the fastest as the local matrix of A
+void MorpheusAutotuneLocalMatrix(
+    SparseMatrix& A, const typename Morpheus::Csr::HostMirror& Acsr);
+#endif  // !HPCG_WITH_HYBRID_LOCAL && !HPCG_WITH_BLOCK_FORMATS
+void ReportAutotuneResults();
+#endif  // HPCG_WITH_MORPHEUS_DYNAMIC
+
+#endif  // HPCG_WITH_MORPHEUS
+#endif  // HPCG_MORPHEUS_AUTOTUNE_HPP
@@ -0,0 +1,69 @@
+/**
+ * Morpheus_BlockMatrix.hpp
+ *
+ * EPCC, The University of Edinburgh
+ *
+ * (c) 2022 The University of Edinburgh
+ *
+ * Contributing Authors:
+ * Christodoulos Stylianou (c.stylianou@ed.ac.uk)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef HPCG_MORPHEUS_BLOCKMATRIX_HPP
+#define HPCG_MORPHEUS_BLOCKMATRIX_HPP
+
+#ifdef HPCG_WITH_MORPHEUS
+#if defined(HPCG_WITH_BLOCK_FORMATS)
+#include "morpheus/Morpheus_SparseMatrix.hpp"
+
+#include <vector>
+
+// Block format in the input file that is selected from the block's structure
+constexpr int HPCG_AUTO_FORMAT = -1;
+// Format id reported for a local matrix whose blocks use different formats
+constexpr int HPCG_BLOCK_FORMAT = -2;
+
+// Splits the rows of Acsr in formats.size() contiguous blocks of equal size,
+// converts block b to formats[b] and sends it to the device
+void MorpheusBlockBuild(const typename Morpheus::Csr::HostMirror& Acsr,
+                        const std::vector<int>& formats, Morpheus_BlockMat& B);
+
+// Format with the least padding for the rows of Ablock: DIA when its
+// diagonals are densely populated, CSR otherwise
+int MorpheusSelectBlockFormat(const typename Morpheus::Csr::HostMirror& Ablock);
+
+// y = B * x
+void MorpheusBlockMultiply(const Morpheus_BlockMat& B,
+                           const Morpheus::value_type* x,
+                           Morpheus::value_type* y);
+
+// y = B * x and returns the local sum of w[i]*y[i]
+Morpheus::value_type MorpheusBlockMultiplyDot(const Morpheus_BlockMat& B,
+                                              const Morpheus::value_type* x,
+                                              const Morpheus::value_type* w,
+                                              Morpheus::value_type* y);
+
+// Y = B * X for k interleaved vectors
+void MorpheusBlockMultiplyMulti(const Morpheus_BlockMat& B,
+                                const Morpheus::value_type* X, const int k,
+                                Morpheus::value_type* Y);
+
+// Replaces the main diagonal of every block with the matching part of diag
+void MorpheusBlockUpdateDiagonal(Morpheus_BlockMat& B,
+                                 const Morpheus::value_type* diag);
+
+#endif  // HPCG_WITH_BLOCK_FORMATS
+#endif  // HPCG_WITH_MORPHEUS
+#endif  // HPCG_MORPHEUS_BLOCKMATRIX_HPP
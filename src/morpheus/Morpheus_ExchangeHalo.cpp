@@ -129,5 +129,106 @@ void MorpheusExchangeHalo(const SparseMatrix& A, Vector& x) {
   return;
 }
 
+void MorpheusExchangeHalo(const SparseMatrix& A, MultiVector& X) {
+  using value_mirror = typename HPCG_Morpheus_Mat::ValueVector::HostMirror;
+  HPCG_Morpheus_Mat* Aopt = (HPCG_Morpheus_Mat*)A.optimizationData;
+
+  using Vector_t = HPCG_Morpheus_Vec<Morpheus::value_type>;
+  Vector_t* Xopt = (Vector_t*)X.optimizationData;
+
+  local_int_t localNumberOfRows = A.localNumberOfRows;
+  int num_neighbors             = A.numberOfSendNeighbors;
+  local_int_t* receiveLength    = A.receiveLength;
+  local_int_t* sendLength       = A.sendLength;
+  int* neighbors                = A.neighbors;
+  const int k                   = X.numberOfVectors;
+  const local_int_t nsend       = A.totalToBeSent * k;
+
+  // One buffer holds the entries of all vectors, grow it if needed
+  if ((local_int_t)Aopt->multiSendBuffer.host.size() < nsend) {
+    Aopt->multiSendBuffer.host = value_mirror(nsend, 0);
+    Aopt->multiSendBuffer.dev =
+        Morpheus::create_mirror_container<Morpheus::Space>(
+            Aopt->multiSendBuffer.host);
+  }
+
+  double *sendBuffer, *Xv;
+#if MPIX_CUDA_AWARE_SUPPORT
+  sendBuffer = Aopt->multiSendBuffer.dev.data();
+  Xv         = Xopt->values.dev.data();
+#else
+  sendBuffer = Aopt->multiSendBuffer.host.data();
+  Xv         = X.values;
+#endif  // MPIX_CUDA_AWARE_SUPPORT
+
+  int MPI_MY_TAG = 99;
+
+  MPI_Request* request = new MPI_Request[num_neighbors];
+
+  //
+  // Externals are at end of locals, the entries of each row are contiguous
+  //
+  double* X_external = (double*)Xv + localNumberOfRows * k;
+  // Post receives first
+  for (int i = 0; i < num_neighbors; i++) {
+    local_int_t n_recv = receiveLength[i] * k;
+    MPI_Irecv(X_external, n_recv, MPI_DOUBLE, neighbors[i], MPI_MY_TAG,
+              MPI_COMM_WORLD, request + i);
+    X_external += n_recv;
+  }
+
+  //
+  // Fill up send buffer with the rows of all vectors
+  //
+  const local_int_t* keys = Aopt->elementsToSend.dev.data();
+  const double* Xdev      = Xopt->values.dev.data();
+  double* sendBufferDev   = Aopt->multiSendBuffer.dev.data();
+  Kokkos::parallel_for(
+      "hpcg::pack_multi_halo",
+      Kokkos::RangePolicy<Morpheus::ExecSpace>(0, A.totalToBeSent),
+      KOKKOS_LAMBDA(const local_int_t i) {
+        for (int v = 0; v < k; v++) {
+          sendBufferDev[i * k + v] = Xdev[keys[i] * k + v];
+        }
+      });
+  Kokkos::fence();
+
+#if !MPIX_CUDA_AWARE_SUPPORT
+  Morpheus::copy(Aopt->multiSendBuffer.dev, Aopt->multiSendBuffer.host);
+#endif
+
+  //
+  // Send to each neighbor, one message holding all vectors
+  //
+  for (int i = 0; i < num_neighbors; i++) {
+    local_int_t n_send = sendLength[i] * k;
+    MPI_Send(sendBuffer, n_send, MPI_DOUBLE, neighbors[i], MPI_MY_TAG,
+             MPI_COMM_WORLD);
+    sendBuffer += n_send;
+  }
+
+  //
+  // Complete the reads issued above
+  //
+  MPI_Status status;
+  for (int i = 0; i < num_neighbors; i++) {
+    if (MPI_Wait(request + i, &status)) {
+      std::exit(-1);  // TODO: have better error exit
+    }
+  }
+
+#if !MPIX_CUDA_AWARE_SUPPORT
+  // send received elements to device in one go
+  local_int_t total_received = 0;
+  for (int i = 0; i < num_neighbors; i++) total_received += receiveLength[i];
+  Morpheus::copy(Xopt->values.host, Xopt->values.dev, localNumberOfRows * k,
+                 (localNumberOfRows + total_received) * k);
+#endif  // !MPIX_CUDA_AWARE_SUPPORT
+
+  delete[] request;
+
+  return;
+}
+
 #endif  // HPCG_NO_MPI
 #endif  // HPCG_WITH_MORPHEUS
@@ -29,8 +29,10 @@
 
 #include "SparseMatrix.hpp"
 #include "Vector.hpp"
+#include "MultiVector.hpp"
 
 void MorpheusExchangeHalo(const SparseMatrix& A, Vector& x);
+void MorpheusExchangeHalo(const SparseMatrix& A, MultiVector& X);
 
 #endif  // HPCG_NO_MPI
 #endif  // HPCG_WITH_MORPHEUS
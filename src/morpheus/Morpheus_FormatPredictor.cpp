@@ -0,0 +1,225 @@
+/**
+ * Morpheus_FormatPredictor.cpp
+ *
+ * EPCC, The University of Edinburgh
+ *
+ * (c) 2022 The University of Edinburgh
+ *
+ * Contributing Authors:
+ * Christodoulos Stylianou (c.stylianou@ed.ac.uk)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "morpheus/Morpheus_FormatPredictor.hpp"
+
+#ifdef HPCG_WITH_MORPHEUS
+#if defined(HPCG_WITH_MORPHEUS_DYNAMIC)
+#include "morpheus/Morpheus_SparseMatrixRoutines.hpp"
+
+#ifndef HPCG_NO_MPI
+#include <mpi.h>
+#endif
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <vector>
+
+namespace {
+// Thresholds of the rule-based cost model
+typedef struct format_model {
+  double dia_max_fill;    // DIA while it stores at most this many slots/nnz
+  double dia_max_diags;   // and has at most this many diagonals
+  double coo_min_row_cv;  // COO once nnz/row varies this much (std/mean)
+} format_model;
+
+format_model model = {1.5, 64, 1.0};
+
+// Process, MG_Level, the features, Predicted, Actual per matrix
+const int predictor_fields = 12;
+std::vector<double> predictor_sub_report;
+}  // namespace
+
+void MorpheusSetupFormatPredictor(const std::string& model_file) {
+  int rank = 0;
+#ifndef HPCG_NO_MPI
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+#endif
+
+  double params[3] = {model.dia_max_fill, model.dia_max_diags,
+                      model.coo_min_row_cv};
+
+  if (rank == 0 && !model_file.empty()) {
+    std::ifstream in(model_file);
+    std::string line, key;
+    double value;
+
+    while (std::getline(in, line)) {
+      std::istringstream tokens(line);
+      if (!(tokens >> key >> value)) continue;
+
+      if (key == "dia_max_fill") params[0] = value;
+      if (key == "dia_max_diags") params[1] = value;
+      if (key == "coo_min_row_cv") params[2] = value;
+    }
+  }
+
+#ifndef HPCG_NO_MPI
+  MPI_Bcast(params, 3, MPI_DOUBLE, 0, MPI_COMM_WORLD);
+#endif
+
+  model.dia_max_fill   = params[0];
+  model.dia_max_diags  = params[1];
+  model.coo_min_row_cv = params[2];
+}
+
+format_features MorpheusExtractFeatures(
+    const SparseMatrix& A, const typename Morpheus::Csr::HostMirror& Acsr) {
+  const local_int_t nrows = Acsr.nrows();
+  const local_int_t ncols = Acsr.ncols();
+  format_features f;
+
+  // Diagonal offsets range from -(nrows - 1) to ncols - 1
+  std::vector<char> used(nrows + ncols, 0);
+  double sum = 0.0, sumsq = 0.0;
+  local_int_t bandwidth = 0, nlocal = 0;
+
+  f.min_nnz_row = nrows > 0 ? Acsr.row_offsets(1) - Acsr.row_offsets(0) : 0;
+  f.max_nnz_row = 0;
+
+  for (local_int_t i = 0; i < nrows; i++) {
+    const double rownnz = Acsr.row_offsets(i + 1) - Acsr.row_offsets(i);
+    sum += rownnz;
+    sumsq += rownnz * rownnz;
+    f.min_nnz_row = std::min(f.min_nnz_row, rownnz);
+    f.max_nnz_row = std::max(f.max_nnz_row, rownnz);
+
+    for (local_int_t k = Acsr.row_offsets(i); k < Acsr.row_offsets(i + 1);
+         k++) {
+      const local_int_t col = Acsr.column_indices(k);
+      used[col - i + nrows - 1] = 1;
+      bandwidth = std::max(bandwidth, col > i ? col - i : i - col);
+      if (col < nrows) nlocal++;
+    }
+  }
+
+  const double nnz = Acsr.nnnz();
+  f.mean_nnz_row   = nrows > 0 ? sum / nrows : 0.0;
+  f.std_nnz_row =
+      nrows > 0 ? std::sqrt(std::max(
+                      0.0, sumsq / nrows - f.mean_nnz_row * f.mean_nnz_row))
+                : 0.0;
+  f.ndiags    = std::count(used.begin(), used.end(), 1);
+  f.dia_fill  = nnz > 0 ? f.ndiags * nrows / nnz : 0.0;
+  f.bandwidth = bandwidth;
+  // In split mode the off-process entries are not part of Acsr
+  f.ghost_fraction = A.localNumberOfNonzeros > 0
+                         ? 1.0 - (double)nlocal / A.localNumberOfNonzeros
+                         : 0.0;
+
+  return f;
+}
+
+int MorpheusPredictFormat(const format_features& f) {
+  if (f.dia_fill <= model.dia_max_fill && f.ndiags <= model.dia_max_diags) {
+    return Morpheus::DIA_FORMAT;
+  }
+
+  const double row_cv = f.mean_nnz_row > 0 ? f.std_nnz_row / f.mean_nnz_row
+                                           : 0.0;
+  if (row_cv >= model.coo_min_row_cv) return Morpheus::COO_FORMAT;
+
+  return Morpheus::CSR_FORMAT;
+}
+
+void MorpheusRecordPrediction(const SparseMatrix& A,
+                              const format_features& f, int predicted) {
+  double entry[predictor_fields] = {
+      (double)MorpheusSparseMatrixGetRank(A),
+      (double)MorpheusSparseMatrixGetCoarseLevel(A),
+      f.min_nnz_row,
+      f.max_nnz_row,
+      f.mean_nnz_row,
+      f.std_nnz_row,
+      f.ndiags,
+      f.dia_fill,
+      f.bandwidth,
+      f.ghost_fraction,
+      (double)predicted,
+      (double)MorpheusSparseMatrixGetLocalProperties(A).id.format};
+
+  predictor_sub_report.insert(predictor_sub_report.end(), entry,
+                              entry + predictor_fields);
+}
+
+void ReportPredictorResults() {
+  if (!predict_formats) return;
+
+  std::string eol = "\n", del = ",";
+  std::string result = "";
+  int rank           = 0;
+  std::vector<double> report;
+
+#ifndef HPCG_NO_MPI
+  int size = 1;
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  MPI_Comm_size(MPI_COMM_WORLD, &size);
+
+  int count = predictor_sub_report.size();
+  std::vector<int> counts(size, 0), displs(size, 0);
+  MPI_Gather(&count, 1, MPI_INT, counts.data(), 1, MPI_INT, 0,
+             MPI_COMM_WORLD);
+
+  if (rank == 0) {
+    for (int p = 1; p < size; p++) displs[p] = displs[p - 1] + counts[p - 1];
+    report.resize(displs[size - 1] + counts[size - 1]);
+  }
+
+  MPI_Gatherv(predictor_sub_report.data(), count, MPI_DOUBLE, report.data(),
+              counts.data(), displs.data(), MPI_DOUBLE, 0, MPI_COMM_WORLD);
+#else
+  report.assign(predictor_sub_report.begin(), predictor_sub_report.end());
+#endif
+
+  if (rank == 0) {
+    std::stringstream header;
+    header << "Process" << del << "MG_Level" << del << "Min_Nnz_Row" << del
+           << "Max_Nnz_Row" << del << "Mean_Nnz_Row" << del << "Std_Nnz_Row"
+           << del << "NDiags" << del << "DIA_Fill" << del << "Bandwidth"
+           << del << "Ghost_Fraction" << del << "Predicted" << del
+           << "Actual";
+
+    result += header.str() + eol;
+    for (size_t i = 0; i < report.size(); i += predictor_fields) {
+      const double* entry = &report[i];
+
+      std::stringstream val;
+      val << (int)entry[0] << del << (int)entry[1] << del
+          << std::setprecision(14);
+      for (int j = 2; j < predictor_fields - 2; j++) val << entry[j] << del;
+      val << (int)entry[predictor_fields - 2] << del
+          << (int)entry[predictor_fields - 1];
+
+      result += val.str() + eol;
+    }
+
+    std::ofstream out("morpheus-predictor-output.txt");
+    out << result;
+  }
+}
+
+#endif  // HPCG_WITH_MORPHEUS_DYNAMIC
+#endif  // HPCG_WITH_MORPHEUS
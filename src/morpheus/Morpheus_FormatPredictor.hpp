@@ -0,0 +1,60 @@
+/**
+ * Morpheus_FormatPredictor.hpp
+ *
+ * EPCC, The University of Edinburgh
+ *
+ * (c) 2022 The University of Edinburgh
+ *
+ * Contributing Authors:
+ * Christodoulos Stylianou (c.stylianou@ed.ac.uk)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef HPCG_MORPHEUS_FORMAT_PREDICTOR_HPP
+#define HPCG_MORPHEUS_FORMAT_PREDICTOR_HPP
+
+#ifdef HPCG_WITH_MORPHEUS
+#if defined(HPCG_WITH_MORPHEUS_DYNAMIC)
+#include "SparseMatrix.hpp"
+#include "morpheus/Morpheus_SparseMatrix.hpp"
+
+#include <string>
+
+// Structural features of the local rows that drive the format choice
+typedef struct format_features {
+  double min_nnz_row;
+  double max_nnz_row;
+  double mean_nnz_row;
+  double std_nnz_row;
+  double ndiags;          // distinct diagonals holding at least one entry
+  double dia_fill;        // ndiags * nrows / nnz, i.e. DIA storage overhead
+  double bandwidth;       // largest |column - row|
+  double ghost_fraction;  // share of the nonzeros in off-process columns
+} format_features;
+
+// Reads the thresholds of the cost model from a file of "key value" lines
+// on rank 0 and broadcasts them. An empty name keeps the built-in rules.
+void MorpheusSetupFormatPredictor(const std::string& model_file);
+
+format_features MorpheusExtractFeatures(
+    const SparseMatrix& A, const typename Morpheus::Csr::HostMirror& Acsr);
+int MorpheusPredictFormat(const format_features& features);
+// Records the features and predicted format next to the format A ended up in
+void MorpheusRecordPrediction(const SparseMatrix& A,
+                              const format_features& features, int predicted);
+void ReportPredictorResults();
+#endif  // HPCG_WITH_MORPHEUS_DYNAMIC
+
+#endif  // HPCG_WITH_MORPHEUS
+#endif  // HPCG_MORPHEUS_FORMAT_PREDICTOR_HPP
@@ -32,43 +32,51 @@
 #include "morpheus/Morpheus_Parser.hpp"
 #endif  // HPCG_WITH_MULTI_FORMATS
 
-int GetFormat_Impl(const SparseMatrix &A, int default_matrix_fmt,
-                   std::vector<format_id> &input_file) {
-  int fmt_index = default_matrix_fmt;
-
 #ifdef HPCG_WITH_MULTI_FORMATS
-  if (input_file.size() == 0) return fmt_index;
+// Constant time lookup of the rules compiled for this process
+template <typename T>
+T GetFormat_Impl(const SparseMatrix &A, const T &default_value,
+                 const format_map<T> &input_file) {
+  const int level = MorpheusSparseMatrixGetCoarseLevel(A);
+  auto entry      = input_file.levels.find(level);
 
-  // select format based on the rank and coarse level
-  for (size_t i = 0; i < input_file.size(); i++) {
-    if (MorpheusSparseMatrixGetRank(A) == input_file[i].rank &&
-        MorpheusSparseMatrixGetCoarseLevel(A) == input_file[i].mg_level) {
-      fmt_index = input_file[i].format;
-      break;
-    }
+  if (entry != input_file.levels.end() &&
+      entry->second.first > input_file.all_levels.first) {
+    return entry->second.second;
   }
-#endif  // HPCG_WITH_MULTI_FORMATS
+  if (input_file.all_levels.first >= 0) return input_file.all_levels.second;
 
-  return fmt_index;
+  return default_value;
 }
+#endif  // HPCG_WITH_MULTI_FORMATS
 
 int GetLocalFormat(const SparseMatrix &A) {
 #ifdef HPCG_WITH_MULTI_FORMATS
-  std::vector<format_id> input_file = local_input_file;
+  return GetFormat_Impl(A, local_matrix_fmt, local_input_file);
 #else
-  std::vector<format_id> input_file = std::vector<format_id>();
+  return local_matrix_fmt;
 #endif
-  return GetFormat_Impl(A, local_matrix_fmt, input_file);
 }
 
+#if defined(HPCG_WITH_BLOCK_FORMATS)
+std::vector<int> GetLocalBlockFormats(const SparseMatrix &A) {
+  // A single block in the format selected for the whole local matrix
+  std::vector<int> single(1, GetLocalFormat(A));
+#ifdef HPCG_WITH_MULTI_FORMATS
+  return GetFormat_Impl(A, single, local_block_input_file);
+#else
+  return single;
+#endif  // HPCG_WITH_MULTI_FORMATS
+}
+#endif  // HPCG_WITH_BLOCK_FORMATS
+
 #if defined(HPCG_WITH_SPLIT_DISTRIBUTED)
 int GetGhostFormat(const SparseMatrix &A) {
 #ifdef HPCG_WITH_MULTI_FORMATS
-  std::vector<format_id> input_file = ghost_input_file;
+  return GetFormat_Impl(A, ghost_matrix_fmt, ghost_input_file);
 #else
-  std::vector<format_id> input_file = std::vector<format_id>();
+  return ghost_matrix_fmt;
 #endif
-  return GetFormat_Impl(A, ghost_matrix_fmt, input_file);
 }
 #endif  // HPCG_WITH_SPLIT_DISTRIBUTED
 
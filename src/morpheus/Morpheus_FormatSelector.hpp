@@ -26,8 +26,14 @@
 
 #include "SparseMatrix.hpp"
 
+#include <vector>
+
 int GetLocalFormat(const SparseMatrix &A);
 
+#if defined(HPCG_WITH_BLOCK_FORMATS)
+std::vector<int> GetLocalBlockFormats(const SparseMatrix &A);
+#endif  // HPCG_WITH_BLOCK_FORMATS
+
 #if defined(HPCG_WITH_SPLIT_DISTRIBUTED)
 int GetGhostFormat(const SparseMatrix &A);
 #endif  // HPCG_WITH_SPLIT_DISTRIBUTED
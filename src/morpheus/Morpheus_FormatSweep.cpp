@@ -0,0 +1,202 @@
+/**
+ * Morpheus_FormatSweep.cpp
+ *
+ * EPCC, The University of Edinburgh
+ *
+ * (c) 2022 The University of Edinburgh
+ *
+ * Contributing Authors:
+ * Christodoulos Stylianou (c.stylianou@ed.ac.uk)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "morpheus/Morpheus_FormatSweep.hpp"
+
+#ifdef HPCG_WITH_MORPHEUS
+#if defined(HPCG_WITH_MORPHEUS_DYNAMIC)
+#if !defined(HPCG_WITH_HYBRID_LOCAL) && !defined(HPCG_WITH_BLOCK_FORMATS)
+#include "morpheus/Morpheus_Autotune.hpp"
+#include "morpheus/Morpheus_MemoryBudget.hpp"
+#include "morpheus/Morpheus_SparseMatrixRoutines.hpp"
+#include "morpheus/Morpheus_VectorRoutines.hpp"
+#include "CG.hpp"
+
+#ifndef HPCG_NO_MPI
+#include <mpi.h>
+#endif
+
+#include <algorithm>
+#include <exception>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <string>
+
+namespace {
+typedef struct sweep_entry {
+  std::string requested;  // formats per level as given on the command line
+  std::string actual;     // formats per level on rank 0 after conversion
+  int sets;
+  double conversion;
+  double times[6];  // total, DDOT, WAXPBY, SPMV, AllReduce and MG time
+  double residual;  // scaled residual of the last set
+} sweep_entry;
+
+std::vector<sweep_entry> sweep_report;
+
+std::string FormatsToString(const std::vector<int>& formats) {
+  std::stringstream s;
+  for (size_t l = 0; l < formats.size(); l++) {
+    s << (l > 0 ? "|" : "") << formats[l];
+  }
+  return s.str();
+}
+}  // namespace
+
+std::vector<int> MorpheusGetLocalFormats(const SparseMatrix& A) {
+  std::vector<int> formats;
+  const SparseMatrix* M = &A;
+  while (M != 0) {
+    formats.push_back(MorpheusSparseMatrixGetLocalProperties(*M).id.format);
+    M = M->Ac;
+  }
+  return formats;
+}
+
+double MorpheusSetLocalFormats(SparseMatrix& A,
+                               const std::vector<int>& formats) {
+  double conversion = 0.0;
+  size_t level      = 0;
+
+  SparseMatrix* M = &A;
+  while (M != 0 && formats.size() > 0) {
+    HPCG_Morpheus_Mat* Mopt = (HPCG_Morpheus_Mat*)M->optimizationData;
+    const int fmt           = formats[std::min(level, formats.size() - 1)];
+
+    if (Mopt->local.dev.active_index() != fmt) {
+      // Diagonal updates may only have been applied on the device
+      Morpheus::copy(Mopt->local.dev, Mopt->local.host);
+
+      // The new format competes for the bytes charged for the current one
+      MorpheusReleaseMemoryBudget(*M);
+      typename Morpheus::Csr::HostMirror Mcsr;
+      if (memory_budget > 0) {
+        Morpheus::convert<Morpheus::HostExecSpace>(Mopt->local.host, Mcsr);
+      }
+
+      // Keep the current format when the new one does not fit
+      if (MorpheusFitsMemoryBudget(Mcsr, fmt)) {
+        Morpheus_Mat converted;
+        try {
+          converted.host = Mopt->local.host;
+          conversion += MorpheusConvertTrial(fmt, converted);
+          Mopt->local = converted;
+        } catch (const std::exception&) {
+          // Nor when it cannot hold the matrix, the report shows the formats
+          // in use
+        }
+      }
+      MorpheusChargeMemoryBudget(*M);
+    }
+
+    M = M->Ac;
+    level++;
+  }
+
+  return conversion;
+}
+
+int MorpheusFormatSweep(SparseMatrix& A, CGData& data, const Vector& b,
+                        Vector& x, int numberOfCgSets, int maxIters,
+                        bool doPreconditioning) {
+  const std::vector<int> initial = MorpheusGetLocalFormats(A);
+
+  int ierr = 0, niters = 0;
+  double normr = 0.0, normr0 = 0.0;
+
+  for (size_t s = 0; s < sweep_formats.size(); s++) {
+    sweep_entry entry;
+    std::vector<double> times(10, 0.0);
+
+    entry.requested  = FormatsToString(sweep_formats[s]);
+    entry.conversion = MorpheusSetLocalFormats(A, sweep_formats[s]);
+    entry.actual     = FormatsToString(MorpheusGetLocalFormats(A));
+    entry.sets       = numberOfCgSets;
+
+    for (int i = 0; i < numberOfCgSets; ++i) {
+      MorpheusZeroVector(x);
+      // Force maxIters iterations, as in the benchmark phase
+      ierr += CG(A, data, b, x, maxIters, 0.0, niters, normr, normr0,
+                 &times[0], doPreconditioning);
+    }
+    entry.residual = normr / normr0;
+
+    // Each component as long as its slowest process
+    for (int t = 0; t < 6; t++) entry.times[t] = times[t];
+#ifndef HPCG_NO_MPI
+    MPI_Allreduce(MPI_IN_PLACE, entry.times, 6, MPI_DOUBLE, MPI_MAX,
+                  MPI_COMM_WORLD);
+    MPI_Allreduce(MPI_IN_PLACE, &entry.conversion, 1, MPI_DOUBLE, MPI_MAX,
+                  MPI_COMM_WORLD);
+#endif
+
+    sweep_report.push_back(entry);
+  }
+
+  // Leave the matrices as they were for the rest of the run
+  MorpheusSetLocalFormats(A, initial);
+
+  return ierr;
+}
+
+void ReportSweepResults() {
+  if (sweep_formats.size() == 0) return;
+
+  std::string eol = "\n", del = ",";
+  std::string result = "";
+  int rank           = 0;
+
+#ifndef HPCG_NO_MPI
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+#endif
+
+  if (rank == 0) {
+    std::stringstream header;
+    header << "Requested_Formats" << del << "Formats" << del << "CG_Sets"
+           << del << "Conversion(s)" << del << "Total(s)" << del << "DDOT(s)"
+           << del << "WAXPBY(s)" << del << "SPMV(s)" << del << "AllReduce(s)"
+           << del << "MG(s)" << del << "Time_Per_Set(s)" << del
+           << "Scaled_Residual";
+
+    result += header.str() + eol;
+    for (size_t i = 0; i < sweep_report.size(); i++) {
+      const sweep_entry& entry = sweep_report[i];
+
+      std::stringstream val;
+      val << entry.requested << del << entry.actual << del << entry.sets
+          << del << std::setprecision(14) << entry.conversion;
+      for (int t = 0; t < 6; t++) val << del << entry.times[t];
+      val << del << entry.times[0] / entry.sets << del << entry.residual;
+
+      result += val.str() + eol;
+    }
+
+    std::ofstream out("morpheus-sweep-output.txt");
+    out << result;
+  }
+}
+
+#endif  // !HPCG_WITH_HYBRID_LOCAL && !HPCG_WITH_BLOCK_FORMATS
+#endif  // HPCG_WITH_MORPHEUS_DYNAMIC
+#endif  // HPCG_WITH_MORPHEUS
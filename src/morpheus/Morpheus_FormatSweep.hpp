@@ -0,0 +1,53 @@
+/**
+ * Morpheus_FormatSweep.hpp
+ *
+ * EPCC, The University of Edinburgh
+ *
+ * (c) 2022 The University of Edinburgh
+ *
+ * Contributing Authors:
+ * Christodoulos Stylianou (c.stylianou@ed.ac.uk)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef HPCG_MORPHEUS_FORMAT_SWEEP_HPP
+#define HPCG_MORPHEUS_FORMAT_SWEEP_HPP
+
+#ifdef HPCG_WITH_MORPHEUS
+#if defined(HPCG_WITH_MORPHEUS_DYNAMIC)
+#if !defined(HPCG_WITH_HYBRID_LOCAL) && !defined(HPCG_WITH_BLOCK_FORMATS)
+#include "SparseMatrix.hpp"
+#include "CGData.hpp"
+#include "Vector.hpp"
+
+#include <vector>
+
+// Formats of the local matrix on every level of A, finest first
+std::vector<int> MorpheusGetLocalFormats(const SparseMatrix& A);
+// Converts the local matrix of every level of A in place. Level l takes
+// formats[l], and the last format also applies to any deeper level.
+double MorpheusSetLocalFormats(SparseMatrix& A,
+                               const std::vector<int>& formats);
+
+// Runs the timed CG sets once per entry of sweep_formats on the already
+// generated problem, then restores the initial formats
+int MorpheusFormatSweep(SparseMatrix& A, CGData& data, const Vector& b,
+                        Vector& x, int numberOfCgSets, int maxIters,
+                        bool doPreconditioning);
+void ReportSweepResults();
+#endif  // !HPCG_WITH_HYBRID_LOCAL && !HPCG_WITH_BLOCK_FORMATS
+#endif  // HPCG_WITH_MORPHEUS_DYNAMIC
+
+#endif  // HPCG_WITH_MORPHEUS
+#endif  // HPCG_MORPHEUS_FORMAT_SWEEP_HPP
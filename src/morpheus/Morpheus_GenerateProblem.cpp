@@ -0,0 +1,177 @@
+/**
+ * Morpheus_GenerateProblem.cpp
+ *
+ * EPCC, The University of Edinburgh
+ *
+ * (c) 2022 The University of Edinburgh
+ *
+ * Contributing Authors:
+ * Christodoulos Stylianou (c.stylianou@ed.ac.uk)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "morpheus/Morpheus_GenerateProblem.hpp"
+
+#ifdef HPCG_WITH_MORPHEUS
+#if defined(HPCG_WITH_MORPHEUS_DIRECT_GENERATION)
+#include "morpheus/Morpheus_SparseMatrix.hpp"
+#include "morpheus/Morpheus_SparseMatrixRoutines.hpp"
+#include "Stencil.hpp"
+
+#include <cassert>
+#include <vector>
+
+namespace {
+using host_policy = Kokkos::RangePolicy<Morpheus::HostExecSpace,
+                                        Kokkos::IndexType<local_int_t>>;
+
+// Points of the 3-point stencil around g that lie in [0, n)
+inline global_int_t StencilWidth(global_int_t g, global_int_t n) {
+  return 1 + (g > 0 ? 1 : 0) + (g + 1 < n ? 1 : 0);
+}
+}  // namespace
+
+void MorpheusGenerateProblem(SparseMatrix& A, Vector* b, Vector* x,
+                             Vector* xexact) {
+  // Make local copies of geometry information.  Use global_int_t since the RHS
+  // products in the calculations below may result in global range values.
+  const global_int_t nx   = A.geom->nx;
+  const global_int_t ny   = A.geom->ny;
+  const global_int_t nz   = A.geom->nz;
+  const global_int_t gnx  = A.geom->gnx;
+  const global_int_t gny  = A.geom->gny;
+  const global_int_t gnz  = A.geom->gnz;
+  const global_int_t gix0 = A.geom->gix0;
+  const global_int_t giy0 = A.geom->giy0;
+  const global_int_t giz0 = A.geom->giz0;
+
+  const local_int_t localNumberOfRows  = nx * ny * nz;
+  const global_int_t totalNumberOfRows = gnx * gny * gnz;
+  assert(localNumberOfRows > 0);
+  assert(totalNumberOfRows > 0);
+
+  const int points = A.geom->stencil.points;
+  StencilValues stencil;
+  InitializeStencilValues(A.geom->stencil, stencil);
+
+  // Row lengths follow from the position of the row in the global grid, so
+  // the offsets are known before any entry is written
+  std::vector<local_int_t> offsets(localNumberOfRows + 1);
+  Kokkos::parallel_for(
+      "hpcg::count_generated_rows", host_policy(0, localNumberOfRows),
+      [&](const local_int_t row) {
+        const global_int_t gix = gix0 + row % nx;
+        const global_int_t giy = giy0 + (row / nx) % ny;
+        const global_int_t giz = giz0 + row / (nx * ny);
+        const global_int_t wx  = StencilWidth(gix, gnx);
+        const global_int_t wy  = StencilWidth(giy, gny);
+        const global_int_t wz  = StencilWidth(giz, gnz);
+        // The 7-point stencil only reaches the neighbors along each axis
+        offsets[row + 1] =
+            points == 27 ? wx * wy * wz : 1 + (wx - 1) + (wy - 1) + (wz - 1);
+      });
+  Kokkos::fence();
+  MorpheusScanOffsets(offsets.data(), localNumberOfRows);
+
+  const local_int_t localNumberOfNonzeros = offsets[localNumberOfRows];
+
+  MorpheusInitializeSparseMatrix(A);
+  HPCG_Morpheus_Mat* Aopt = (HPCG_Morpheus_Mat*)A.optimizationData;
+
+  Aopt->generated = typename Morpheus::Csr::HostMirror(
+      localNumberOfRows, localNumberOfRows, localNumberOfNonzeros);
+
+  local_int_t* rowOffsets = Aopt->generated.row_offsets().data();
+  local_int_t* columns    = Aopt->generated.column_indices().data();
+  double* values          = Aopt->generated.values().data();
+  global_int_t* globalIds = new global_int_t[localNumberOfNonzeros];
+
+  char* nonzerosInRow     = new char[localNumberOfRows];
+  global_int_t** mtxIndG  = new global_int_t*[localNumberOfRows];
+  local_int_t** mtxIndL   = new local_int_t*[localNumberOfRows];
+  double** matrixValues   = new double*[localNumberOfRows];
+  double** matrixDiagonal = new double*[localNumberOfRows];
+
+  if (b != 0) InitializeVector(*b, localNumberOfRows);
+  if (x != 0) InitializeVector(*x, localNumberOfRows);
+  if (xexact != 0) InitializeVector(*xexact, localNumberOfRows);
+  double* bv      = b != 0 ? b->values : 0;
+  double* xv      = x != 0 ? x->values : 0;
+  double* xexactv = xexact != 0 ? xexact->values : 0;
+  A.localToGlobalMap.resize(localNumberOfRows);
+
+  rowOffsets[0] = 0;
+  // Every row writes its own range, so the rows are independent
+  Kokkos::parallel_for(
+      "hpcg::generate_rows", host_policy(0, localNumberOfRows),
+      [&](const local_int_t row) {
+        const global_int_t gix       = gix0 + row % nx;
+        const global_int_t giy       = giy0 + (row / nx) % ny;
+        const global_int_t giz       = giz0 + row / (nx * ny);
+        const global_int_t globalRow = giz * gnx * gny + giy * gnx + gix;
+        const local_int_t start      = offsets[row];
+
+        mtxIndG[row]      = globalIds + start;
+        mtxIndL[row]      = columns + start;
+        matrixValues[row] = values + start;
+
+        StencilValues point;
+        const StencilValues& rowValues =
+            ComputeStencilValues(*A.geom, stencil, gix, giy, giz, point);
+
+        local_int_t k = start;
+        double rowSum = 0.0;
+        for (int sz = -1; sz <= 1; sz++) {
+          if (giz + sz < 0 || giz + sz >= gnz) continue;
+          for (int sy = -1; sy <= 1; sy++) {
+            if (giy + sy < 0 || giy + sy >= gny) continue;
+            for (int sx = -1; sx <= 1; sx++) {
+              if (gix + sx < 0 || gix + sx >= gnx) continue;
+              const double value = rowValues.value[StencilIndex(sx, sy, sz)];
+              if (value == 0.0) continue;  // Not a point of the stencil
+              const global_int_t col =
+                  globalRow + sz * gnx * gny + sy * gnx + sx;
+              if (col == globalRow) matrixDiagonal[row] = values + k;
+              values[k] = value;
+              rowSum += value;
+              globalIds[k++] = col;
+            }
+          }
+        }
+
+        rowOffsets[row + 1]     = k;
+        nonzerosInRow[row]      = (char)(k - start);
+        A.localToGlobalMap[row] = globalRow;
+        if (bv != 0) bv[row] = rowSum;
+        if (xv != 0) xv[row] = 0.0;
+        if (xexactv != 0) xexactv[row] = 1.0;
+      });
+  Kokkos::fence();
+
+  A.globalToLocalMap.setBox(*A.geom);
+
+  A.title                 = 0;
+  A.totalNumberOfRows     = totalNumberOfRows;
+  A.localNumberOfRows     = localNumberOfRows;
+  A.localNumberOfColumns  = localNumberOfRows;
+  A.localNumberOfNonzeros = localNumberOfNonzeros;
+  A.nonzerosInRow         = nonzerosInRow;
+  A.mtxIndG               = mtxIndG;
+  A.mtxIndL               = mtxIndL;
+  A.matrixValues          = matrixValues;
+  A.matrixDiagonal        = matrixDiagonal;
+}
+
+#endif  // HPCG_WITH_MORPHEUS_DIRECT_GENERATION
+#endif  // HPCG_WITH_MORPHEUS
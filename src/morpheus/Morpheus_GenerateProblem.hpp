@@ -0,0 +1,42 @@
+/**
+ * Morpheus_GenerateProblem.hpp
+ *
+ * EPCC, The University of Edinburgh
+ *
+ * (c) 2022 The University of Edinburgh
+ *
+ * Contributing Authors:
+ * Christodoulos Stylianou (c.stylianou@ed.ac.uk)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef HPCG_MORPHEUS_GENERATEPROBLEM_HPP
+#define HPCG_MORPHEUS_GENERATEPROBLEM_HPP
+
+#ifdef HPCG_WITH_MORPHEUS
+#if defined(HPCG_WITH_MORPHEUS_DIRECT_GENERATION)
+#include "SparseMatrix.hpp"
+#include "Vector.hpp"
+
+// Same problem as GenerateProblem_ref, with the rows stored once in the CSR
+// host mirror of A's optimization data. The reference row pointers of A
+// point into that matrix, except the global column ids, which are kept in a
+// single array at mtxIndG[0]. Does not communicate, the global number of
+// nonzeros is left to ReduceNumberOfNonzeros.
+void MorpheusGenerateProblem(SparseMatrix& A, Vector* b, Vector* x,
+                             Vector* xexact);
+#endif  // HPCG_WITH_MORPHEUS_DIRECT_GENERATION
+
+#endif  // HPCG_WITH_MORPHEUS
+#endif  // HPCG_MORPHEUS_GENERATEPROBLEM_HPP
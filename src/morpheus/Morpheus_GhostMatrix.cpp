@@ -0,0 +1,119 @@
+/**
+ * Morpheus_GhostMatrix.cpp
+ *
+ * EPCC, The University of Edinburgh
+ *
+ * (c) 2022 The University of Edinburgh
+ *
+ * Contributing Authors:
+ * Christodoulos Stylianou (c.stylianou@ed.ac.uk)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "morpheus/Morpheus_GhostMatrix.hpp"
+
+#ifdef HPCG_WITH_MORPHEUS
+#if defined(HPCG_WITH_SPLIT_DISTRIBUTED)
+#include "morpheus/Morpheus_SpMM.hpp"
+
+namespace {
+using value_type = Morpheus::value_type;
+using index_type = Morpheus::index_type;
+using policy =
+    Kokkos::RangePolicy<Morpheus::ExecSpace, Kokkos::IndexType<index_type>>;
+using uvec = typename Morpheus::UnmanagedVector<value_type>;
+
+// tmp = Aghost * xghost over the compact rows
+void CompactMultiply(HPCG_Morpheus_Mat* Aopt, const value_type* xghost) {
+  auto Aghost = Aopt->ghost.dev;
+  auto xwrap  = uvec(Aghost.ncols(), const_cast<value_type*>(xghost));
+
+  Morpheus::multiply<Morpheus::ExecSpace>(Aghost, xwrap,
+                                          Aopt->ghostProduct.dev);
+  Kokkos::fence();
+}
+}  // namespace
+
+void MorpheusGhostMultiply(HPCG_Morpheus_Mat* Aopt, const value_type* xghost,
+                           value_type* y) {
+  const index_type nghost = Aopt->ghostRows.dev.size();
+  if (nghost == 0) return;
+
+  CompactMultiply(Aopt, xghost);
+
+  const index_type* rows = Aopt->ghostRows.dev.data();
+  const value_type* tmp  = Aopt->ghostProduct.dev.data();
+  // Rows are unique so no atomics are needed
+  Kokkos::parallel_for(
+      "hpcg::ghost_scatter_add", policy(0, nghost),
+      KOKKOS_LAMBDA(const index_type n) { y[rows[n]] += tmp[n]; });
+  Kokkos::fence();
+}
+
+value_type MorpheusGhostMultiplyDot(HPCG_Morpheus_Mat* Aopt,
+                                    const value_type* xghost,
+                                    const value_type* w, value_type* y) {
+  const index_type nghost = Aopt->ghostRows.dev.size();
+  if (nghost == 0) return 0.0;
+
+  CompactMultiply(Aopt, xghost);
+
+  const index_type* rows = Aopt->ghostRows.dev.data();
+  const value_type* tmp  = Aopt->ghostProduct.dev.data();
+  value_type result      = 0.0;
+  Kokkos::parallel_reduce(
+      "hpcg::ghost_scatter_add_dot", policy(0, nghost),
+      KOKKOS_LAMBDA(const index_type n, value_type& sum) {
+        const index_type i = rows[n];
+        y[i] += tmp[n];
+        sum += w[i] * tmp[n];
+      },
+      result);
+
+  return result;
+}
+
+void MorpheusGhostMultiplyMulti(HPCG_Morpheus_Mat* Aopt,
+                                const value_type* Xghost, const int k,
+                                value_type* Y) {
+  using value_mirror =
+      typename Morpheus_Vec<value_type>::type::HostMirror;
+
+  const index_type nghost = Aopt->ghostRows.dev.size();
+  if (nghost == 0) return;
+
+  // Temporary compact product for all vectors, grow it if needed
+  if ((index_type)Aopt->ghostMultiProduct.host.size() < nghost * k) {
+    Aopt->ghostMultiProduct.host = value_mirror(nghost * k, 0);
+    Aopt->ghostMultiProduct.dev =
+        Morpheus::create_mirror_container<Morpheus::Space>(
+            Aopt->ghostMultiProduct.host);
+  }
+
+  value_type* tmp = Aopt->ghostMultiProduct.dev.data();
+  MorpheusMultiplyMulti(Aopt->ghost.dev, Xghost, k, tmp, true);
+
+  const index_type* rows = Aopt->ghostRows.dev.data();
+  Kokkos::parallel_for(
+      "hpcg::ghost_scatter_add_multi", policy(0, nghost),
+      KOKKOS_LAMBDA(const index_type n) {
+        value_type* yi       = Y + rows[n] * k;
+        const value_type* ti = tmp + n * k;
+        for (int v = 0; v < k; v++) yi[v] += ti[v];
+      });
+  Kokkos::fence();
+}
+
+#endif  // HPCG_WITH_SPLIT_DISTRIBUTED
+#endif  // HPCG_WITH_MORPHEUS
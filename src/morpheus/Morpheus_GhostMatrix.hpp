@@ -0,0 +1,52 @@
+/**
+ * Morpheus_GhostMatrix.hpp
+ *
+ * EPCC, The University of Edinburgh
+ *
+ * (c) 2022 The University of Edinburgh
+ *
+ * Contributing Authors:
+ * Christodoulos Stylianou (c.stylianou@ed.ac.uk)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef HPCG_MORPHEUS_GHOSTMATRIX_HPP
+#define HPCG_MORPHEUS_GHOSTMATRIX_HPP
+
+#ifdef HPCG_WITH_MORPHEUS
+#if defined(HPCG_WITH_SPLIT_DISTRIBUTED)
+#include "morpheus/Morpheus_SparseMatrix.hpp"
+
+// The ghost block only stores the rows with off-process couplings. Row n of
+// Aopt->ghost corresponds to local row Aopt->ghostRows[n], so each product
+// below is computed on the compact rows and then scatter-added into y.
+
+// y += Aghost * xghost
+void MorpheusGhostMultiply(HPCG_Morpheus_Mat* Aopt,
+                           const Morpheus::value_type* xghost,
+                           Morpheus::value_type* y);
+
+// y += Aghost * xghost and returns the local sum of w[i]*(Aghost * xghost)[i]
+Morpheus::value_type MorpheusGhostMultiplyDot(
+    HPCG_Morpheus_Mat* Aopt, const Morpheus::value_type* xghost,
+    const Morpheus::value_type* w, Morpheus::value_type* y);
+
+// Y += Aghost * Xghost for k interleaved vectors
+void MorpheusGhostMultiplyMulti(HPCG_Morpheus_Mat* Aopt,
+                                const Morpheus::value_type* Xghost,
+                                const int k, Morpheus::value_type* Y);
+
+#endif  // HPCG_WITH_SPLIT_DISTRIBUTED
+#endif  // HPCG_WITH_MORPHEUS
+#endif  // HPCG_MORPHEUS_GHOSTMATRIX_HPP
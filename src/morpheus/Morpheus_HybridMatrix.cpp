@@ -0,0 +1,359 @@
+/**
+ * Morpheus_HybridMatrix.cpp
+ *
+ * EPCC, The University of Edinburgh
+ *
+ * (c) 2022 The University of Edinburgh
+ *
+ * Contributing Authors:
+ * Christodoulos Stylianou (c.stylianou@ed.ac.uk)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "morpheus/Morpheus_HybridMatrix.hpp"
+
+#ifdef HPCG_WITH_MORPHEUS
+#if defined(HPCG_WITH_HYBRID_LOCAL)
+#include "morpheus/Morpheus_NUMA.hpp"
+#include "ExchangeHalo.hpp"
+
+#include <cassert>
+
+namespace {
+using value_type = Morpheus::value_type;
+using index_type = Morpheus::index_type;
+using policy =
+    Kokkos::RangePolicy<Morpheus::ExecSpace, Kokkos::IndexType<index_type>>;
+using index_mirror = typename Morpheus_Vec<local_int_t>::type::HostMirror;
+using value_mirror = typename Morpheus_Vec<value_type>::type::HostMirror;
+}  // namespace
+
+void MorpheusHybridBuild(const typename Morpheus::Csr::HostMirror& Acsr,
+                         Morpheus_HybridMat& H) {
+  const local_int_t nrows = Acsr.nrows();
+  H.nrows                 = nrows;
+  H.ncols                 = Acsr.ncols();
+
+  // The interior stencil is taken from the longest row that only couples to
+  // local rows. Rows that do not match it exactly are treated as boundary.
+  local_int_t pattern = -1, ndiags = 0;
+  for (local_int_t i = 0; i < nrows; i++) {
+    local_int_t len = Acsr.crow_offsets(i + 1) - Acsr.crow_offsets(i);
+    if (len <= ndiags) continue;
+
+    bool local = true;
+    for (local_int_t jj = Acsr.crow_offsets(i); jj < Acsr.crow_offsets(i + 1);
+         jj++) {
+      if (Acsr.ccolumn_indices(jj) >= nrows) local = false;
+    }
+    if (local) {
+      pattern = i;
+      ndiags  = len;
+    }
+  }
+
+  H.offsets.host = index_mirror(ndiags, 0);
+  H.center       = -1;
+  for (local_int_t d = 0; d < ndiags; d++) {
+    local_int_t jj    = Acsr.crow_offsets(pattern) + d;
+    H.offsets.host(d) = Acsr.ccolumn_indices(jj) - pattern;
+    if (H.offsets.host(d) == 0) H.center = d;
+  }
+  // Without a main diagonal the stencil cannot be relaxed, keep all in CSR
+  if (H.center < 0) ndiags = 0;
+  H.ndiags = ndiags;
+
+  auto is_interior = [&](const local_int_t i) {
+    if (ndiags == 0) return false;
+    if (Acsr.crow_offsets(i + 1) - Acsr.crow_offsets(i) != ndiags) return false;
+    for (local_int_t d = 0; d < ndiags; d++) {
+      local_int_t j = Acsr.ccolumn_indices(Acsr.crow_offsets(i) + d);
+      if (j >= nrows || j - i != H.offsets.host(d)) return false;
+    }
+    return true;
+  };
+
+  // Count the rows and nonzeros of each part
+  local_int_t ninterior = 0, nboundary = 0, nnz_boundary = 0;
+  H.rowMap = index_mirror(nrows, 0);
+  for (local_int_t i = 0; i < nrows; i++) {
+    if (is_interior(i)) {
+      H.rowMap(i) = ninterior++;
+    } else {
+      H.rowMap(i) = -(++nboundary);
+      nnz_boundary += Acsr.crow_offsets(i + 1) - Acsr.crow_offsets(i);
+    }
+  }
+
+  H.interiorRows.host   = index_mirror(ninterior, 0);
+  H.interiorValues.host = value_mirror(ninterior * ndiags, 0);
+  H.boundaryRows.host   = index_mirror(nboundary, 0);
+  H.boundaryDiag        = index_mirror(nboundary, 0);
+  H.boundary.host =
+      typename Morpheus::Csr::HostMirror(nboundary, H.ncols, nnz_boundary);
+
+  local_int_t nnz = 0;
+
+  H.boundary.host.row_offsets(0) = 0;
+  for (local_int_t i = 0; i < nrows; i++) {
+    const local_int_t p = H.rowMap(i);
+    if (p >= 0) {
+      H.interiorRows.host(p) = i;
+      for (local_int_t d = 0; d < ndiags; d++) {
+        H.interiorValues.host(d * ninterior + p) =
+            Acsr.cvalues(Acsr.crow_offsets(i) + d);
+      }
+    } else {
+      const local_int_t n    = -p - 1;
+      H.boundaryRows.host(n) = i;
+      H.boundaryDiag(n)      = -1;
+      for (local_int_t jj = Acsr.crow_offsets(i);
+           jj < Acsr.crow_offsets(i + 1); jj++) {
+        if (Acsr.ccolumn_indices(jj) == i) H.boundaryDiag(n) = nnz;
+        H.boundary.host.column_indices(nnz) = Acsr.ccolumn_indices(jj);
+        H.boundary.host.values(nnz++)       = Acsr.cvalues(jj);
+      }
+      H.boundary.host.row_offsets(n + 1) = nnz;
+    }
+  }
+
+#if defined(HPCG_WITH_SPLIT_DISTRIBUTED)
+  // Right hand side corrected by the ghost couplings during the sweeps
+  H.rhs = value_mirror(nrows, 0);
+#endif  // HPCG_WITH_SPLIT_DISTRIBUTED
+
+  // Now send to device
+  MorpheusSendToDevice(H.interiorRows);
+  MorpheusSendToDevice(H.offsets);
+  MorpheusSendToDevice(H.interiorValues);
+  MorpheusSendToDevice(H.boundaryRows);
+  MorpheusSendToDevice(H.boundary);
+}
+
+void MorpheusHybridMultiply(const Morpheus_HybridMat& H, const value_type* x,
+                            const int k, value_type* y) {
+  // Interior and boundary rows partition the local rows, so each output row
+  // is written exactly once
+  const index_type ninterior = H.interiorRows.dev.size();
+  const index_type ndiags    = H.ndiags;
+  const index_type* irows    = H.interiorRows.dev.data();
+  const index_type* offsets  = H.offsets.dev.data();
+  const value_type* ivalues  = H.interiorValues.dev.data();
+  const index_type nboundary = H.boundaryRows.dev.size();
+  const index_type* brows    = H.boundaryRows.dev.data();
+  const index_type* boffsets = H.boundary.dev.crow_offsets().data();
+  const index_type* bcolumns = H.boundary.dev.ccolumn_indices().data();
+  const value_type* bvalues  = H.boundary.dev.cvalues().data();
+
+  Kokkos::parallel_for(
+      "hpcg::hybrid_interior_spmv", policy(0, ninterior),
+      KOKKOS_LAMBDA(const index_type n) {
+        const index_type i = irows[n];
+        for (int v = 0; v < k; v++) {
+          value_type sum = 0;
+          for (index_type d = 0; d < ndiags; d++) {
+            sum += ivalues[d * ninterior + n] * x[(i + offsets[d]) * k + v];
+          }
+          y[i * k + v] = sum;
+        }
+      });
+
+  Kokkos::parallel_for(
+      "hpcg::hybrid_boundary_spmv", policy(0, nboundary),
+      KOKKOS_LAMBDA(const index_type n) {
+        const index_type i = brows[n];
+        for (int v = 0; v < k; v++) {
+          value_type sum = 0;
+          for (index_type jj = boffsets[n]; jj < boffsets[n + 1]; jj++) {
+            sum += bvalues[jj] * x[bcolumns[jj] * k + v];
+          }
+          y[i * k + v] = sum;
+        }
+      });
+  Kokkos::fence();
+}
+
+value_type MorpheusHybridMultiplyDot(const Morpheus_HybridMat& H,
+                                     const value_type* x, const value_type* w,
+                                     value_type* y) {
+  const index_type ninterior = H.interiorRows.dev.size();
+  const index_type ndiags    = H.ndiags;
+  const index_type* irows    = H.interiorRows.dev.data();
+  const index_type* offsets  = H.offsets.dev.data();
+  const value_type* ivalues  = H.interiorValues.dev.data();
+  const index_type nboundary = H.boundaryRows.dev.size();
+  const index_type* brows    = H.boundaryRows.dev.data();
+  const index_type* boffsets = H.boundary.dev.crow_offsets().data();
+  const index_type* bcolumns = H.boundary.dev.ccolumn_indices().data();
+  const value_type* bvalues  = H.boundary.dev.cvalues().data();
+
+  value_type interior_result = 0.0, boundary_result = 0.0;
+  Kokkos::parallel_reduce(
+      "hpcg::hybrid_interior_spmv_dot", policy(0, ninterior),
+      KOKKOS_LAMBDA(const index_type n, value_type& sum) {
+        const index_type i = irows[n];
+        value_type yi      = 0;
+        for (index_type d = 0; d < ndiags; d++) {
+          yi += ivalues[d * ninterior + n] * x[i + offsets[d]];
+        }
+        y[i] = yi;
+        sum += w[i] * yi;
+      },
+      interior_result);
+
+  Kokkos::parallel_reduce(
+      "hpcg::hybrid_boundary_spmv_dot", policy(0, nboundary),
+      KOKKOS_LAMBDA(const index_type n, value_type& sum) {
+        const index_type i = brows[n];
+        value_type yi      = 0;
+        for (index_type jj = boffsets[n]; jj < boffsets[n + 1]; jj++) {
+          yi += bvalues[jj] * x[bcolumns[jj]];
+        }
+        y[i] = yi;
+        sum += w[i] * yi;
+      },
+      boundary_result);
+
+  return interior_result + boundary_result;
+}
+
+void MorpheusHybridUpdateDiagonal(Morpheus_HybridMat& H,
+                                  const value_type* diag) {
+  const local_int_t ninterior = H.interiorRows.host.size();
+  for (local_int_t n = 0; n < ninterior; n++) {
+    H.interiorValues.host(H.center * ninterior + n) =
+        diag[H.interiorRows.host(n)];
+  }
+
+  const local_int_t nboundary = H.boundaryRows.host.size();
+  for (local_int_t n = 0; n < nboundary; n++) {
+    H.boundary.host.values(H.boundaryDiag(n)) = diag[H.boundaryRows.host(n)];
+  }
+
+  Morpheus::copy(H.interiorValues.host, H.interiorValues.dev);
+  Morpheus::copy(H.boundary.host, H.boundary.dev);
+}
+
+void MorpheusHybridCopyDiagonal(const Morpheus_HybridMat& H, value_type* diag) {
+  const local_int_t ninterior = H.interiorRows.host.size();
+  for (local_int_t n = 0; n < ninterior; n++) {
+    diag[H.interiorRows.host(n)] =
+        H.interiorValues.host(H.center * ninterior + n);
+  }
+
+  const local_int_t nboundary = H.boundaryRows.host.size();
+  for (local_int_t n = 0; n < nboundary; n++) {
+    diag[H.boundaryRows.host(n)] = H.boundary.host.cvalues(H.boundaryDiag(n));
+  }
+}
+
+/*!
+  Symmetric Gauss-Seidel on the hybrid local matrix, visiting the rows in the
+  same order as ComputeSYMGS_ref. Runs on the host, like the reference kernel.
+*/
+int MorpheusHybridSYMGS(const SparseMatrix& A, const Vector& r, Vector& x) {
+  assert(x.localLength == A.localNumberOfColumns);
+
+#ifndef HPCG_NO_MPI
+  ExchangeHalo(A, x);
+#endif
+
+  HPCG_Morpheus_Mat* Aopt = (HPCG_Morpheus_Mat*)A.optimizationData;
+  Morpheus_HybridMat& H   = Aopt->local;
+
+  const local_int_t nrow      = A.localNumberOfRows;
+  const local_int_t ninterior = H.interiorRows.host.size();
+  const local_int_t ndiags    = H.ndiags;
+  const local_int_t* offsets  = H.offsets.host.data();
+  const value_type* ivalues   = H.interiorValues.host.data();
+  const local_int_t* boffsets = H.boundary.host.crow_offsets().data();
+  const local_int_t* bcolumns = H.boundary.host.ccolumn_indices().data();
+  const value_type* bvalues   = H.boundary.host.cvalues().data();
+  const value_type* rv        = r.values;
+  value_type* xv              = x.values;
+
+#if defined(HPCG_WITH_SPLIT_DISTRIBUTED)
+  // The external values of x are fixed during the sweeps, so the ghost
+  // couplings are moved to the right hand side once
+  const local_int_t nghost = Aopt->ghostRows.host.size();
+  if (nghost > 0) {
+    using host_uvec =
+        typename Morpheus::UnmanagedVector<value_type>::HostMirror;
+    auto xghost = host_uvec(Aopt->ghost.host.ncols(), xv + nrow);
+    Morpheus::multiply<Kokkos::Serial>(Aopt->ghost.host, xghost,
+                                       Aopt->ghostProduct.host);
+
+    for (local_int_t i = 0; i < nrow; i++) H.rhs(i) = rv[i];
+    for (local_int_t n = 0; n < nghost; n++) {
+      H.rhs(Aopt->ghostRows.host(n)) -= Aopt->ghostProduct.host(n);
+    }
+    rv = H.rhs.data();
+  }
+#endif  // HPCG_WITH_SPLIT_DISTRIBUTED
+
+  auto relax = [&](const local_int_t i) {
+    const local_int_t p = H.rowMap(i);
+    value_type sum      = rv[i];
+    value_type diag     = 0.0;
+    if (p >= 0) {
+      for (local_int_t d = 0; d < ndiags; d++) {
+        sum -= ivalues[d * ninterior + p] * xv[i + offsets[d]];
+      }
+      diag = ivalues[H.center * ninterior + p];
+    } else {
+      const local_int_t n = -p - 1;
+      for (local_int_t jj = boffsets[n]; jj < boffsets[n + 1]; jj++) {
+        sum -= bvalues[jj] * xv[bcolumns[jj]];
+      }
+      diag = bvalues[H.boundaryDiag(n)];
+    }
+    sum += xv[i] * diag;  // Remove diagonal contribution from previous loop
+    xv[i] = sum / diag;
+  };
+
+  for (local_int_t i = 0; i < nrow; i++) relax(i);
+  // Now the back sweep
+  for (local_int_t i = nrow - 1; i >= 0; i--) relax(i);
+
+  return 0;
+}
+
+double MorpheusHybridInteriorMemory(const Morpheus_HybridMat& H) {
+  double index_size = (double)sizeof(Morpheus::index_type);
+  double value_size = (double)sizeof(Morpheus::value_type);
+  double ninterior  = H.interiorRows.dev.size();
+
+  double memory = 0;
+  memory += ninterior * index_size;             // interiorRows
+  memory += H.ndiags * index_size;              // offsets
+  memory += ninterior * H.ndiags * value_size;  // values
+  return memory;
+}
+
+double MorpheusHybridBoundaryMemory(const Morpheus_HybridMat& H) {
+  double index_size = (double)sizeof(Morpheus::index_type);
+  double value_size = (double)sizeof(Morpheus::value_type);
+  double nboundary  = H.boundaryRows.dev.size();
+  double nnz        = H.boundary.dev.nnnz();
+
+  double memory = 0;
+  memory += 2 * nboundary * index_size;    // boundaryRows & boundaryDiag
+  memory += (nboundary + 1) * index_size;  // row_offsets
+  memory += nnz * index_size;              // column_indices
+  memory += nnz * value_size;              // values
+  return memory;
+}
+
+#endif  // HPCG_WITH_HYBRID_LOCAL
+#endif  // HPCG_WITH_MORPHEUS
@@ -0,0 +1,67 @@
+/**
+ * Morpheus_HybridMatrix.hpp
+ *
+ * EPCC, The University of Edinburgh
+ *
+ * (c) 2022 The University of Edinburgh
+ *
+ * Contributing Authors:
+ * Christodoulos Stylianou (c.stylianou@ed.ac.uk)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef HPCG_MORPHEUS_HYBRIDMATRIX_HPP
+#define HPCG_MORPHEUS_HYBRIDMATRIX_HPP
+
+#ifdef HPCG_WITH_MORPHEUS
+#if defined(HPCG_WITH_HYBRID_LOCAL)
+#include "morpheus/Morpheus_SparseMatrix.hpp"
+#include "SparseMatrix.hpp"
+#include "Vector.hpp"
+
+// Format id reported for the hybrid local matrix as a whole
+constexpr int HPCG_HYBRID_FORMAT = -1;
+
+// Partitions the rows of Acsr in interior and boundary parts and sends them
+// to the device
+void MorpheusHybridBuild(const typename Morpheus::Csr::HostMirror& Acsr,
+                         Morpheus_HybridMat& H);
+
+// y = H * x for k interleaved vectors
+void MorpheusHybridMultiply(const Morpheus_HybridMat& H,
+                            const Morpheus::value_type* x, const int k,
+                            Morpheus::value_type* y);
+
+// y = H * x and returns the local sum of w[i]*y[i]
+Morpheus::value_type MorpheusHybridMultiplyDot(const Morpheus_HybridMat& H,
+                                               const Morpheus::value_type* x,
+                                               const Morpheus::value_type* w,
+                                               Morpheus::value_type* y);
+
+// Replaces the main diagonal of both parts with diag
+void MorpheusHybridUpdateDiagonal(Morpheus_HybridMat& H,
+                                  const Morpheus::value_type* diag);
+
+// Copies the main diagonal of both parts to diag
+void MorpheusHybridCopyDiagonal(const Morpheus_HybridMat& H,
+                                Morpheus::value_type* diag);
+
+int MorpheusHybridSYMGS(const SparseMatrix& A, const Vector& r, Vector& x);
+
+double MorpheusHybridInteriorMemory(const Morpheus_HybridMat& H);
+double MorpheusHybridBoundaryMemory(const Morpheus_HybridMat& H);
+
+#endif  // HPCG_WITH_HYBRID_LOCAL
+#endif  // HPCG_WITH_MORPHEUS
+#endif  // HPCG_MORPHEUS_HYBRIDMATRIX_HPP
@@ -67,12 +67,54 @@ void SparseMatrixWrite(SparseMatrix& A, std::string prefix) {
 void MorpheusSparseMatrixWrite(SparseMatrix& A, std::string prefix) {
   HPCG_Morpheus_Mat* Aopt = (HPCG_Morpheus_Mat*)A.optimizationData;
 
+#if defined(HPCG_WITH_HYBRID_LOCAL)
+  // The host copies of the hybrid matrix are kept up to date
+  const Morpheus_HybridMat& H = Aopt->local;
+  const local_int_t ninterior = H.interiorRows.host.size();
+
+  std::stringstream local_entry;
+  for (local_int_t i = 0; i < H.nrows; i++) {
+    const local_int_t p = H.rowMap(i);
+    if (p >= 0) {
+      for (local_int_t d = 0; d < H.ndiags; d++) {
+        local_entry << i << " " << i + H.offsets.host(d) << " "
+                    << H.interiorValues.host(d * ninterior + p) << std::endl;
+      }
+    } else {
+      const local_int_t n = -p - 1;
+      for (local_int_t jj = H.boundary.host.crow_offsets(n);
+           jj < H.boundary.host.crow_offsets(n + 1); jj++) {
+        local_entry << i << " " << H.boundary.host.ccolumn_indices(jj) << " "
+                    << H.boundary.host.cvalues(jj) << std::endl;
+      }
+    }
+  }
+#elif defined(HPCG_WITH_BLOCK_FORMATS)
+  std::stringstream local_entry;
+  for (size_t b = 0; b < Aopt->local.blocks.size(); b++) {
+    const local_int_t start = Aopt->local.blockStart[b];
+
+    // Bring data to host first and convert to CSR
+    Morpheus::copy(Aopt->local.blocks[b].dev, Aopt->local.blocks[b].host);
+    typename Morpheus::Csr::HostMirror Ablock;
+    Morpheus::convert<Morpheus::HostExecSpace>(Aopt->local.blocks[b].host,
+                                               Ablock);
+
+    for (local_int_t i = 0; i < Ablock.nrows(); i++) {
+      for (local_int_t jj = Ablock.crow_offsets(i);
+           jj < Ablock.crow_offsets(i + 1); jj++) {
+        local_entry << start + i << " " << Ablock.ccolumn_indices(jj) << " "
+                    << Ablock.cvalues(jj) << std::endl;
+      }
+    }
+  }
+#else
   // Bring data to host first
   Morpheus::copy(Aopt->local.dev, Aopt->local.host);
 
   // Convert to CSR
   typename Morpheus::Csr::HostMirror Alocal;
-  Morpheus::convert<Kokkos::Serial>(Aopt->local.host, Alocal);
+  Morpheus::convert<Morpheus::HostExecSpace>(Aopt->local.host, Alocal);
 
   std::stringstream local_entry;
   for (local_int_t i = 0; i < Alocal.nrows(); i++) {
@@ -82,6 +124,7 @@ void MorpheusSparseMatrixWrite(SparseMatrix& A, std::string prefix) {
                   << Alocal.cvalues(jj) << std::endl;
     }
   }
+#endif
   std::string local_filename =
       prefix + "morpheus-local-matrix-" + std::to_string(A.geom->rank) + ".txt";
   std::ofstream local_out(local_filename);
@@ -90,16 +133,18 @@ void MorpheusSparseMatrixWrite(SparseMatrix& A, std::string prefix) {
 #if defined(HPCG_WITH_SPLIT_DISTRIBUTED)
   // Bring data to host first
   Morpheus::copy(Aopt->ghost.dev, Aopt->ghost.host);
+  Morpheus::copy(Aopt->ghostRows.dev, Aopt->ghostRows.host);
 
   // Convert to CSR
   typename Morpheus::Csr::HostMirror Aghost;
-  Morpheus::convert<Kokkos::Serial>(Aopt->ghost.host, Aghost);
+  Morpheus::convert<Morpheus::HostExecSpace>(Aopt->ghost.host, Aghost);
 
   std::stringstream external_entry;
   for (local_int_t i = 0; i < Aghost.nrows(); i++) {
     for (local_int_t jj = Aghost.crow_offsets(i);
          jj < Aghost.crow_offsets(i + 1); jj++) {
-      external_entry << i << " " << Aghost.ccolumn_indices(jj) << " "
+      external_entry << Aopt->ghostRows.host(i) << " "
+                     << Aghost.ccolumn_indices(jj) << " "
                      << Aghost.cvalues(jj) << std::endl;
     }
   }
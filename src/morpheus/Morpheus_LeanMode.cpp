@@ -0,0 +1,153 @@
+/**
+ * Morpheus_LeanMode.cpp
+ *
+ * EPCC, The University of Edinburgh
+ *
+ * (c) 2022 The University of Edinburgh
+ *
+ * Contributing Authors:
+ * Christodoulos Stylianou (c.stylianou@ed.ac.uk)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "morpheus/Morpheus_LeanMode.hpp"
+
+#ifdef HPCG_WITH_MORPHEUS
+#include "morpheus/Morpheus.hpp"
+#include "morpheus/Morpheus_SparseMatrix.hpp"
+
+#ifndef HPCG_NO_MPI
+#include <mpi.h>
+#endif
+
+#include <iostream>
+#include <vector>
+
+namespace {
+double released_bytes = 0.0;  // Reclaimed by this process over all levels
+
+// Bytes allocated for one of the per-row arrays of A
+template <typename T>
+double RowsMemory(const SparseMatrix& A, bool rowsOwned) {
+  const double nrows = A.localNumberOfRows;
+  double bytes       = nrows * sizeof(T*);
+  if (!rowsOwned) return bytes;
+#if defined(HPCG_WITH_MORPHEUS_DIRECT_GENERATION)
+  bytes += A.localNumberOfNonzeros * sizeof(T);
+#else
+  // GenerateProblem allocates room for a full stencil per row
+  bytes += nrows * A.geom->stencil.points * sizeof(T);
+#endif
+  return bytes;
+}
+
+double ReleaseLevel(SparseMatrix& A) {
+  double bytes = 0.0;
+
+  if (A.mtxIndG != 0) {
+    bytes += RowsMemory<global_int_t>(A, true);
+    DeleteMatrixRows(A.mtxIndG, A.localNumberOfRows);
+  }
+
+  bytes += A.globalToLocalMap.memory();
+  bytes += A.localToGlobalMap.capacity() * sizeof(global_int_t);
+  A.globalToLocalMap.clear();
+  std::vector<global_int_t>().swap(A.localToGlobalMap);
+
+#if defined(HPCG_WITH_HYBRID_LOCAL)
+  // SYMGS sweeps the hybrid matrix, so nothing reads the rows anymore
+#if defined(HPCG_WITH_MORPHEUS_DIRECT_GENERATION)
+  HPCG_Morpheus_Mat* Aopt = (HPCG_Morpheus_Mat*)A.optimizationData;
+  const bool rowsOwned    = false;
+  bytes += Aopt->generated.row_offsets().size() * sizeof(local_int_t) +
+           Aopt->generated.column_indices().size() * sizeof(local_int_t) +
+           Aopt->generated.values().size() * sizeof(double);
+#else
+  const bool rowsOwned = true;
+#endif
+  if (A.mtxIndL != 0) {
+    bytes += RowsMemory<local_int_t>(A, rowsOwned);
+    DeleteMatrixRows(A.mtxIndL, A.localNumberOfRows, rowsOwned);
+  }
+  if (A.matrixValues != 0) {
+    bytes += RowsMemory<double>(A, rowsOwned);
+    DeleteMatrixRows(A.matrixValues, A.localNumberOfRows, rowsOwned);
+  }
+  if (A.matrixDiagonal != 0) {
+    bytes += A.localNumberOfRows * sizeof(double*);
+    delete[] A.matrixDiagonal;
+    A.matrixDiagonal = 0;
+  }
+#if defined(HPCG_WITH_MORPHEUS_DIRECT_GENERATION)
+  Aopt->generated = typename Morpheus::Csr::HostMirror();
+#endif
+#endif  // HPCG_WITH_HYBRID_LOCAL
+
+  return bytes;
+}
+}  // namespace
+
+void MorpheusReleaseReferenceMatrix(SparseMatrix& A) {
+#if !defined(HPCG_DETAILED_DEBUG)
+  // WriteProblem dumps the reference arrays after OptimizeProblem
+  if (!lean_mode) return;
+
+  for (SparseMatrix* M = &A; M != 0; M = M->Ac) {
+    released_bytes += ReleaseLevel(*M);
+  }
+#endif  // !HPCG_DETAILED_DEBUG
+}
+
+global_int_t MorpheusGlobalRow(const SparseMatrix& A, local_int_t i) {
+  if (!A.localToGlobalMap.empty()) return A.localToGlobalMap[i];
+
+  // Same ordering as GenerateProblem
+  const Geometry& geom = *A.geom;
+  const local_int_t ix = i % geom.nx;
+  const local_int_t iy = (i / geom.nx) % geom.ny;
+  const local_int_t iz = i / (geom.nx * geom.ny);
+
+  return (geom.giz0 + iz) * geom.gnx * geom.gny + (geom.giy0 + iy) * geom.gnx +
+         geom.gix0 + ix;
+}
+
+void ReportLeanMode() {
+  if (!lean_mode) return;
+
+  int rank         = 0;
+  int size         = 1;
+  double min_bytes = released_bytes;
+  double max_bytes = released_bytes;
+  double sum_bytes = released_bytes;
+
+#ifndef HPCG_NO_MPI
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  MPI_Comm_size(MPI_COMM_WORLD, &size);
+  MPI_Reduce(&released_bytes, &min_bytes, 1, MPI_DOUBLE, MPI_MIN, 0,
+             MPI_COMM_WORLD);
+  MPI_Reduce(&released_bytes, &max_bytes, 1, MPI_DOUBLE, MPI_MAX, 0,
+             MPI_COMM_WORLD);
+  MPI_Reduce(&released_bytes, &sum_bytes, 1, MPI_DOUBLE, MPI_SUM, 0,
+             MPI_COMM_WORLD);
+#endif
+
+  if (rank == 0) {
+    std::cout << "Lean mode: " << sum_bytes
+              << " bytes of reference arrays released, per process min/avg/max "
+              << min_bytes << "/" << sum_bytes / size << "/" << max_bytes
+              << std::endl;
+  }
+}
+
+#endif  // HPCG_WITH_MORPHEUS
@@ -0,0 +1,40 @@
+/**
+ * Morpheus_LeanMode.hpp
+ *
+ * EPCC, The University of Edinburgh
+ *
+ * (c) 2022 The University of Edinburgh
+ *
+ * Contributing Authors:
+ * Christodoulos Stylianou (c.stylianou@ed.ac.uk)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef HPCG_MORPHEUS_LEANMODE_HPP
+#define HPCG_MORPHEUS_LEANMODE_HPP
+
+#ifdef HPCG_WITH_MORPHEUS
+#include "SparseMatrix.hpp"
+
+// Frees the reference arrays of every MG level of A that the optimized
+// kernels no longer read: the global column ids and the index maps on every
+// layout, and the rows themselves where SYMGS runs on the Morpheus matrix.
+// Does nothing unless --lean is given.
+void MorpheusReleaseReferenceMatrix(SparseMatrix& A);
+// Global id of local row i, also once the index maps have been released
+global_int_t MorpheusGlobalRow(const SparseMatrix& A, local_int_t i);
+void ReportLeanMode();
+
+#endif  // HPCG_WITH_MORPHEUS
+#endif  // HPCG_MORPHEUS_LEANMODE_HPP
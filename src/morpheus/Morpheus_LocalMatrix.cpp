@@ -0,0 +1,80 @@
+/**
+ * Morpheus_LocalMatrix.cpp
+ *
+ * EPCC, The University of Edinburgh
+ *
+ * (c) 2022 The University of Edinburgh
+ *
+ * Contributing Authors:
+ * Christodoulos Stylianou (c.stylianou@ed.ac.uk)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "morpheus/Morpheus_LocalMatrix.hpp"
+
+#ifdef HPCG_WITH_MORPHEUS
+#include "morpheus/Morpheus_SpMVDot.hpp"
+#include "morpheus/Morpheus_SpMM.hpp"
+#if defined(HPCG_WITH_HYBRID_LOCAL)
+#include "morpheus/Morpheus_HybridMatrix.hpp"
+#elif defined(HPCG_WITH_BLOCK_FORMATS)
+#include "morpheus/Morpheus_BlockMatrix.hpp"
+#endif
+
+using value_type = Morpheus::value_type;
+
+void MorpheusLocalMultiply(const HPCG_Morpheus_Mat* Aopt, const value_type* x,
+                           value_type* y) {
+#if defined(HPCG_WITH_HYBRID_LOCAL)
+  MorpheusHybridMultiply(Aopt->local, x, 1, y);
+#elif defined(HPCG_WITH_BLOCK_FORMATS)
+  MorpheusBlockMultiply(Aopt->local, x, y);
+#else
+  using uvec  = typename Morpheus::UnmanagedVector<value_type>;
+  auto Alocal = Aopt->local.dev;
+
+  // In split mode the local matrix only spans the local columns of x
+  auto xwrap = uvec(Alocal.ncols(), const_cast<value_type*>(x));
+  auto ywrap = uvec(Alocal.nrows(), y);
+
+  Morpheus::multiply<Morpheus::ExecSpace>(Alocal, xwrap, ywrap);
+  Kokkos::fence();
+#endif
+}
+
+value_type MorpheusLocalMultiplyDot(const HPCG_Morpheus_Mat* Aopt,
+                                    const value_type* x, const value_type* w,
+                                    value_type* y) {
+#if defined(HPCG_WITH_HYBRID_LOCAL)
+  return MorpheusHybridMultiplyDot(Aopt->local, x, w, y);
+#elif defined(HPCG_WITH_BLOCK_FORMATS)
+  return MorpheusBlockMultiplyDot(Aopt->local, x, w, y);
+#else
+  return MorpheusMultiplyDot(Aopt->local.dev, x, w, y, true);
+#endif
+}
+
+void MorpheusLocalMultiplyMulti(const HPCG_Morpheus_Mat* Aopt,
+                                const value_type* X, const int k,
+                                value_type* Y) {
+#if defined(HPCG_WITH_HYBRID_LOCAL)
+  MorpheusHybridMultiply(Aopt->local, X, k, Y);
+#elif defined(HPCG_WITH_BLOCK_FORMATS)
+  MorpheusBlockMultiplyMulti(Aopt->local, X, k, Y);
+#else
+  MorpheusMultiplyMulti(Aopt->local.dev, X, k, Y, true);
+#endif
+}
+
+#endif  // HPCG_WITH_MORPHEUS
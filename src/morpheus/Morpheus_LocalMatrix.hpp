@@ -0,0 +1,50 @@
+/**
+ * Morpheus_LocalMatrix.hpp
+ *
+ * EPCC, The University of Edinburgh
+ *
+ * (c) 2022 The University of Edinburgh
+ *
+ * Contributing Authors:
+ * Christodoulos Stylianou (c.stylianou@ed.ac.uk)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef HPCG_MORPHEUS_LOCALMATRIX_HPP
+#define HPCG_MORPHEUS_LOCALMATRIX_HPP
+
+#ifdef HPCG_WITH_MORPHEUS
+#include "morpheus/Morpheus_SparseMatrix.hpp"
+
+// Products with the local matrix, whichever way it is stored. The vectors
+// are raw pointers to device data with the same layout as the HPCG vectors.
+
+// y = Alocal * x
+void MorpheusLocalMultiply(const HPCG_Morpheus_Mat* Aopt,
+                           const Morpheus::value_type* x,
+                           Morpheus::value_type* y);
+
+// y = Alocal * x and returns the local sum of w[i]*y[i]
+Morpheus::value_type MorpheusLocalMultiplyDot(const HPCG_Morpheus_Mat* Aopt,
+                                              const Morpheus::value_type* x,
+                                              const Morpheus::value_type* w,
+                                              Morpheus::value_type* y);
+
+// Y = Alocal * X for k interleaved vectors
+void MorpheusLocalMultiplyMulti(const HPCG_Morpheus_Mat* Aopt,
+                                const Morpheus::value_type* X, const int k,
+                                Morpheus::value_type* Y);
+
+#endif  // HPCG_WITH_MORPHEUS
+#endif  // HPCG_MORPHEUS_LOCALMATRIX_HPP
@@ -26,11 +26,17 @@
 
 #ifdef HPCG_WITH_MORPHEUS
 
+#include "morpheus/Morpheus_SparseMatrix.hpp"
 #include "morpheus/Morpheus_Vector.hpp"
 
 // Optimization data to be used by MG
 struct HPCG_Morpheus_MGData_STRUCT {
   Morpheus_Vec<local_int_t> f2c;
+  // Full-weighting transfers of Galerkin coarse operators, P and P^T
+  struct {
+    Morpheus::Csr dev;
+    typename Morpheus::Csr::HostMirror host;
+  } interpolation, restriction;
 };
 
 typedef HPCG_Morpheus_MGData_STRUCT HPCG_Morpheus_MGData;
@@ -28,12 +28,36 @@
 #include "morpheus/Morpheus_MGData.hpp"
 #include "morpheus/Morpheus_VectorRoutines.hpp"
 
+namespace {
+// Copies a transfer operator of the MG data into a Morpheus CSR matrix
+template <typename Matrix>
+void MorpheusOptimizeTransfer(const Transfer& T, local_int_t ncols,
+                              Matrix& M) {
+  const local_int_t nnz = T.rowStart[T.numberOfRows];
+  M.host = typename Morpheus::Csr::HostMirror(T.numberOfRows, ncols, nnz);
+
+  local_int_t* rowOffsets = M.host.row_offsets().data();
+  local_int_t* columns    = M.host.column_indices().data();
+  double* values          = M.host.values().data();
+  for (local_int_t i = 0; i <= T.numberOfRows; i++)
+    rowOffsets[i] = T.rowStart[i];
+  for (local_int_t k = 0; k < nnz; k++) {
+    columns[k] = T.columns[k];
+    values[k]  = T.values[k];
+  }
+
+  M.dev = Morpheus::create_mirror_container<Morpheus::Space>(M.host);
+  Morpheus::copy(M.host, M.dev);
+}
+}  // namespace
+
 void MorpheusInitializeMGData(MGData& mg) {
   mg.optimizationData = new HPCG_Morpheus_MGData();
 
   MorpheusInitializeVector(*mg.rc);
   MorpheusInitializeVector(*mg.xc);
   MorpheusInitializeVector(*mg.Axf);
+  if (mg.rcOverlap) MorpheusInitializeVector(*mg.rcOverlap);
 }
 
 void MorpheusOptimizeMGData(MGData& mg) {
@@ -51,6 +75,14 @@ void MorpheusOptimizeMGData(MGData& mg) {
   MGopt->f2c.dev =
       Morpheus::create_mirror_container<Morpheus::Space>(MGopt->f2c.host);
   Morpheus::copy(MGopt->f2c.host, MGopt->f2c.dev);
+
+  if (mg.coarseOperator == HPCG_GALERKIN_FULL_WEIGHTING) {
+    MorpheusOptimizeVector(*mg.rcOverlap);
+    MorpheusOptimizeTransfer(mg.interpolation, mg.rcOverlap->localLength,
+                             MGopt->interpolation);
+    MorpheusOptimizeTransfer(mg.restriction, mg.interpolation.numberOfRows,
+                             MGopt->restriction);
+  }
 }
 
 #endif  // HPCG_WITH_MORPHEUS
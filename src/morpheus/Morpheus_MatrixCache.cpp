@@ -0,0 +1,358 @@
+/**
+ * Morpheus_MatrixCache.cpp
+ *
+ * EPCC, The University of Edinburgh
+ *
+ * (c) 2022 The University of Edinburgh
+ *
+ * Contributing Authors:
+ * Christodoulos Stylianou (c.stylianou@ed.ac.uk)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "morpheus/Morpheus_MatrixCache.hpp"
+
+#ifdef HPCG_WITH_MORPHEUS
+#if defined(HPCG_WITH_MORPHEUS_DYNAMIC)
+#include "morpheus/Morpheus_SparseMatrixRoutines.hpp"
+
+#ifndef HPCG_NO_MPI
+#include <mpi.h>
+#endif
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <climits>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+namespace {
+using index_type = Morpheus::index_type;
+using value_type = Morpheus::value_type;
+
+const char cache_magic[8] = "HPCGMAT";
+const int cache_version   = 2;
+
+// What the matrices of the run are built from, besides the stencil of each
+// level kept in its geometry
+typedef struct cache_source {
+  int coarse_operator;
+  long long matrix_size;           // Size and modification time of the
+  long long matrix_mtime;          // external matrix, zero when generated
+  unsigned long long matrix_path;  // Hash of its canonical path
+} cache_source;
+
+cache_source source = {};
+
+// Raw layout of a cache entry: the header, the two index arrays and the
+// values, back to back. COO keeps row and column indices, CSR row offsets and
+// column indices, and DIA the diagonal offsets and a padded values matrix.
+typedef struct cache_header {
+  char magic[8];
+  int version;
+  int format;
+  int index_size;
+  int value_size;
+  long long nrows;
+  long long ncols;
+  long long nnnz;
+  long long nindices[2];  // Lengths of the index arrays
+  long long nvalues[2];   // Rows and columns of the values
+  int points;             // Stencil of the generated operator of the level
+  int variable;
+  double anisotropy[3];
+  cache_source source;
+} cache_header;
+
+int cache_hits   = 0;
+int cache_stores = 0;
+
+// FNV-1a, which unlike std::hash is the same in every build
+const unsigned long long hash_offset = 14695981039346656037ULL;
+
+unsigned long long HashBytes(unsigned long long hash, const void* data,
+                             size_t n) {
+  const unsigned char* bytes = (const unsigned char*)data;
+  for (size_t i = 0; i < n; i++) {
+    hash = (hash ^ bytes[i]) * 1099511628211ULL;
+  }
+  return hash;
+}
+
+template <typename T>
+unsigned long long HashValue(unsigned long long hash, const T& value) {
+  return HashBytes(hash, &value, sizeof(T));
+}
+
+// Sets the key fields of h to the operator A was built from
+void SetCacheKey(const SparseMatrix& A, cache_header& h) {
+  const Stencil& stencil = A.geom->stencil;
+  h.points               = stencil.points;
+  h.variable             = stencil.variable ? 1 : 0;
+  h.anisotropy[0]        = stencil.ax;
+  h.anisotropy[1]        = stencil.ay;
+  h.anisotropy[2]        = stencil.az;
+  h.source               = source;
+}
+
+bool SameCacheKey(const cache_header& h, const cache_header& key) {
+  return h.points == key.points && h.variable == key.variable &&
+         h.anisotropy[0] == key.anisotropy[0] &&
+         h.anisotropy[1] == key.anisotropy[1] &&
+         h.anisotropy[2] == key.anisotropy[2] &&
+         h.source.coarse_operator == key.source.coarse_operator &&
+         h.source.matrix_size == key.source.matrix_size &&
+         h.source.matrix_mtime == key.source.matrix_mtime &&
+         h.source.matrix_path == key.source.matrix_path;
+}
+
+// Entries of different operators get different names, so that runs of
+// different problems in the same directory do not overwrite each other
+std::string CachePath(const SparseMatrix& A, const std::string& part,
+                      int fmt) {
+  const Geometry& geom = *A.geom;
+  std::stringstream path;
+
+  cache_header key = {};
+  SetCacheKey(A, key);
+  unsigned long long hash = hash_offset;
+
+  hash = HashValue(hash, key.points);
+  hash = HashValue(hash, key.variable);
+  hash = HashBytes(hash, key.anisotropy, sizeof(key.anisotropy));
+  hash = HashValue(hash, key.source.coarse_operator);
+  hash = HashValue(hash, key.source.matrix_size);
+  hash = HashValue(hash, key.source.matrix_mtime);
+  hash = HashValue(hash, key.source.matrix_path);
+
+  path << matrix_cache_dir << "/hpcg-" << geom.nx << "x" << geom.ny << "x"
+       << geom.nz << "-" << geom.npx << "x" << geom.npy << "x" << geom.npz
+       << "-r" << geom.rank << "-l" << MorpheusSparseMatrixGetCoarseLevel(A)
+       << "-" << part << "-f" << fmt << "-k" << std::hex << std::setw(16)
+       << std::setfill('0') << hash << ".bin";
+
+  return path.str();
+}
+
+// Copies the arrays of a mapped entry into a freshly allocated matrix, so
+// that the device mirror and the diagonal updates never touch the file
+bool CopyCachedMatrix(const cache_header& h, const char* data,
+                      Morpheus_Mat& M) {
+  const index_type* idx0 = (const index_type*)data;
+  const index_type* idx1 = idx0 + h.nindices[0];
+  const value_type* vals = (const value_type*)(idx1 + h.nindices[1]);
+  const long long nvals  = h.nvalues[0] * h.nvalues[1];
+
+  if (h.format == Morpheus::COO_FORMAT) {
+    typename Morpheus::Coo::HostMirror Acoo(h.nrows, h.ncols, h.nnnz);
+    if (Acoo.row_indices().size() != (size_t)h.nindices[0] ||
+        Acoo.values().size() != (size_t)nvals) {
+      return false;
+    }
+
+    std::copy(idx0, idx1, Acoo.row_indices().data());
+    std::copy(idx1, idx1 + h.nindices[1], Acoo.column_indices().data());
+    std::copy(vals, vals + nvals, Acoo.values().data());
+    M.host = Acoo;
+  } else if (h.format == Morpheus::CSR_FORMAT) {
+    typename Morpheus::Csr::HostMirror Acsr(h.nrows, h.ncols, h.nnnz);
+    if (Acsr.row_offsets().size() != (size_t)h.nindices[0] ||
+        Acsr.values().size() != (size_t)nvals) {
+      return false;
+    }
+
+    std::copy(idx0, idx1, Acsr.row_offsets().data());
+    std::copy(idx1, idx1 + h.nindices[1], Acsr.column_indices().data());
+    std::copy(vals, vals + nvals, Acsr.values().data());
+    M.host = Acsr;
+  } else if (h.format == Morpheus::DIA_FORMAT) {
+    typename Morpheus::Dia::HostMirror Adia(h.nrows, h.ncols, h.nnnz,
+                                            h.nindices[0]);
+    // The padding of the values depends on the Morpheus version
+    if (Adia.values().nrows() != h.nvalues[0] ||
+        Adia.values().ncols() != h.nvalues[1]) {
+      return false;
+    }
+
+    std::copy(idx0, idx1, Adia.diagonal_offsets().data());
+    std::copy(vals, vals + nvals, Adia.values().data());
+    M.host = Adia;
+  } else {
+    return false;
+  }
+
+  return true;
+}
+}  // namespace
+
+void MorpheusSetMatrixCacheSource(const HPCG_Params& params) {
+  source                 = cache_source();
+  source.coarse_operator = params.coarseOperator;
+  if (params.matrixFile.empty()) return;
+
+  // A file edited or replaced in place changes its size or modification time
+  struct stat st;
+  if (stat(params.matrixFile.c_str(), &st) == 0) {
+    source.matrix_size  = st.st_size;
+    source.matrix_mtime = st.st_mtime;
+  }
+
+  char resolved[PATH_MAX];
+  const std::string path = realpath(params.matrixFile.c_str(), resolved)
+                               ? std::string(resolved)
+                               : params.matrixFile;
+  source.matrix_path = HashBytes(hash_offset, path.data(), path.size());
+}
+
+bool MorpheusLoadCachedMatrix(const SparseMatrix& A, const std::string& part,
+                              int fmt,
+                              const typename Morpheus::Csr::HostMirror& Acsr,
+                              Morpheus_Mat& M) {
+  if (matrix_cache_dir.empty()) return false;
+
+  const std::string path = CachePath(A, part, fmt);
+  int fd                 = open(path.c_str(), O_RDONLY);
+  if (fd < 0) return false;
+
+  struct stat st;
+  void* map = MAP_FAILED;
+  if (fstat(fd, &st) == 0 && (size_t)st.st_size >= sizeof(cache_header)) {
+    map = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  }
+  close(fd);
+  if (map == MAP_FAILED) return false;
+
+  const cache_header& h = *(const cache_header*)map;
+  cache_header key      = {};
+  SetCacheKey(A, key);
+  const size_t expected =
+      sizeof(cache_header) +
+      (size_t)(h.nindices[0] + h.nindices[1]) * sizeof(index_type) +
+      (size_t)(h.nvalues[0] * h.nvalues[1]) * sizeof(value_type);
+
+  bool hit = std::memcmp(h.magic, cache_magic, sizeof(cache_magic)) == 0 &&
+             h.version == cache_version && h.format == fmt &&
+             h.index_size == (int)sizeof(index_type) &&
+             h.value_size == (int)sizeof(value_type) &&
+             h.nrows == Acsr.nrows() && h.ncols == Acsr.ncols() &&
+             h.nnnz == Acsr.nnnz() && SameCacheKey(h, key) &&
+             (size_t)st.st_size == expected;
+
+  if (hit) {
+    hit = CopyCachedMatrix(h, (const char*)map + sizeof(cache_header), M);
+  }
+  munmap(map, st.st_size);
+
+  if (hit) cache_hits++;
+  return hit;
+}
+
+void MorpheusStoreCachedMatrix(const SparseMatrix& A, const std::string& part,
+                               const Morpheus_Mat& M) {
+  if (matrix_cache_dir.empty()) return;
+
+  cache_header h = {};
+  std::memcpy(h.magic, cache_magic, sizeof(cache_magic));
+  h.version    = cache_version;
+  h.format     = M.host.active_index();
+  h.index_size = sizeof(index_type);
+  h.value_size = sizeof(value_type);
+  h.nrows      = M.host.nrows();
+  h.ncols      = M.host.ncols();
+  h.nnnz       = M.host.nnnz();
+  SetCacheKey(A, h);
+
+  // Shallow copies, the arrays stay owned by M.host
+  const index_type *idx0 = nullptr, *idx1 = nullptr;
+  const value_type* vals = nullptr;
+  if (h.format == Morpheus::COO_FORMAT) {
+    typename Morpheus::Coo::HostMirror Acoo = M.host;
+    h.nindices[0] = Acoo.row_indices().size();
+    h.nindices[1] = Acoo.column_indices().size();
+    h.nvalues[0]  = Acoo.values().size();
+    h.nvalues[1]  = 1;
+    idx0          = Acoo.row_indices().data();
+    idx1          = Acoo.column_indices().data();
+    vals          = Acoo.values().data();
+  } else if (h.format == Morpheus::CSR_FORMAT) {
+    typename Morpheus::Csr::HostMirror Acsr = M.host;
+    h.nindices[0] = Acsr.row_offsets().size();
+    h.nindices[1] = Acsr.column_indices().size();
+    h.nvalues[0]  = Acsr.values().size();
+    h.nvalues[1]  = 1;
+    idx0          = Acsr.row_offsets().data();
+    idx1          = Acsr.column_indices().data();
+    vals          = Acsr.values().data();
+  } else if (h.format == Morpheus::DIA_FORMAT) {
+    typename Morpheus::Dia::HostMirror Adia = M.host;
+    h.nindices[0] = Adia.diagonal_offsets().size();
+    h.nindices[1] = 0;
+    h.nvalues[0]  = Adia.values().nrows();
+    h.nvalues[1]  = Adia.values().ncols();
+    idx0          = Adia.diagonal_offsets().data();
+    vals          = Adia.values().data();
+  } else {
+    return;
+  }
+
+  mkdir(matrix_cache_dir.c_str(), 0755);
+  const std::string path = CachePath(A, part, h.format);
+  const std::string tmp  = path + ".tmp";
+
+  std::ofstream out(tmp, std::ios::binary);
+  out.write((const char*)&h, sizeof(cache_header));
+  out.write((const char*)idx0, h.nindices[0] * sizeof(index_type));
+  out.write((const char*)idx1, h.nindices[1] * sizeof(index_type));
+  out.write((const char*)vals,
+            h.nvalues[0] * h.nvalues[1] * sizeof(value_type));
+  out.close();
+
+  // Readers only ever see complete entries
+  if (out && std::rename(tmp.c_str(), path.c_str()) == 0) {
+    cache_stores++;
+  } else {
+    std::remove(tmp.c_str());
+  }
+}
+
+void ReportMatrixCache() {
+  if (matrix_cache_dir.empty()) return;
+
+  int rank      = 0;
+  int counts[2] = {cache_hits, cache_stores};
+  int totals[2] = {cache_hits, cache_stores};
+
+#ifndef HPCG_NO_MPI
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  MPI_Reduce(counts, totals, 2, MPI_INT, MPI_SUM, 0, MPI_COMM_WORLD);
+#endif
+
+  if (rank == 0) {
+    std::cout << "Matrix cache " << matrix_cache_dir << ": " << totals[0]
+              << " matrices reused and " << totals[1]
+              << " converted and stored over all processes" << std::endl;
+  }
+}
+
+#endif  // HPCG_WITH_MORPHEUS_DYNAMIC
+#endif  // HPCG_WITH_MORPHEUS
@@ -0,0 +1,53 @@
+/**
+ * Morpheus_MatrixCache.hpp
+ *
+ * EPCC, The University of Edinburgh
+ *
+ * (c) 2022 The University of Edinburgh
+ *
+ * Contributing Authors:
+ * Christodoulos Stylianou (c.stylianou@ed.ac.uk)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef HPCG_MORPHEUS_MATRIXCACHE_HPP
+#define HPCG_MORPHEUS_MATRIXCACHE_HPP
+
+#ifdef HPCG_WITH_MORPHEUS
+#if defined(HPCG_WITH_MORPHEUS_DYNAMIC)
+#include "SparseMatrix.hpp"
+#include "hpcg.hpp"
+#include "morpheus/Morpheus_SparseMatrix.hpp"
+
+#include <string>
+
+// Records what the run builds its matrices from: the coarse operators and,
+// with --matrix, the identity of the file. Entries of other sources are never
+// loaded.
+void MorpheusSetMatrixCacheSource(const HPCG_Params& params);
+// Fills M.host with the cached conversion of the part ("local" or "ghost") of
+// A in fmt. Returns false when the cache is disabled, has no such entry or
+// the entry does not match the shape of Acsr.
+bool MorpheusLoadCachedMatrix(const SparseMatrix& A, const std::string& part,
+                              int fmt,
+                              const typename Morpheus::Csr::HostMirror& Acsr,
+                              Morpheus_Mat& M);
+// Writes M.host to the cache as the part of A, in its active format
+void MorpheusStoreCachedMatrix(const SparseMatrix& A, const std::string& part,
+                               const Morpheus_Mat& M);
+void ReportMatrixCache();
+#endif  // HPCG_WITH_MORPHEUS_DYNAMIC
+
+#endif  // HPCG_WITH_MORPHEUS
+#endif  // HPCG_MORPHEUS_MATRIXCACHE_HPP
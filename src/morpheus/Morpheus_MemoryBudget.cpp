@@ -0,0 +1,154 @@
+/**
+ * Morpheus_MemoryBudget.cpp
+ *
+ * EPCC, The University of Edinburgh
+ *
+ * (c) 2022 The University of Edinburgh
+ *
+ * Contributing Authors:
+ * Christodoulos Stylianou (c.stylianou@ed.ac.uk)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "morpheus/Morpheus_MemoryBudget.hpp"
+
+#ifdef HPCG_WITH_MORPHEUS
+#if defined(HPCG_WITH_MORPHEUS_DYNAMIC)
+#include "morpheus/Morpheus_SparseMatrixRoutines.hpp"
+
+#ifndef HPCG_NO_MPI
+#include <mpi.h>
+#endif
+
+#include <algorithm>
+#include <iostream>
+#include <vector>
+
+namespace {
+// Tried in order when the selected format does not fit
+const int fallback_formats[] = {Morpheus::CSR_FORMAT, Morpheus::COO_FORMAT};
+
+double charged_bytes  = 0.0;  // Exact bytes of the matrices built so far
+double reserved_bytes = 0.0;  // Estimates of the matrix being built
+int fallbacks         = 0;
+int overruns          = 0;
+
+local_int_t CountDiagonals(const typename Morpheus::Csr::HostMirror& Acsr) {
+  const local_int_t nrows = Acsr.nrows();
+  // Diagonal offsets range from -(nrows - 1) to ncols - 1
+  std::vector<char> used(nrows + Acsr.ncols(), 0);
+
+  for (local_int_t i = 0; i < nrows; i++) {
+    for (local_int_t k = Acsr.row_offsets(i); k < Acsr.row_offsets(i + 1);
+         k++) {
+      used[Acsr.column_indices(k) - i + nrows - 1] = 1;
+    }
+  }
+
+  return std::count(used.begin(), used.end(), 1);
+}
+}  // namespace
+
+double MorpheusEstimateMemory(const typename Morpheus::Csr::HostMirror& Acsr,
+                              int fmt) {
+  const double index_size = (double)sizeof(Morpheus::index_type);
+  const double value_size = (double)sizeof(Morpheus::value_type);
+  const double nrows      = Acsr.nrows();
+  const double nnz        = Acsr.nnnz();
+
+  if (fmt == Morpheus::COO_FORMAT) {
+    return nnz * (2 * index_size + value_size);
+  } else if (fmt == Morpheus::CSR_FORMAT) {
+    return (nrows + 1) * index_size + nnz * (index_size + value_size);
+  } else if (fmt == Morpheus::DIA_FORMAT) {
+    // One row-long strip of values per occupied diagonal
+    const double ndiags = CountDiagonals(Acsr);
+    return ndiags * index_size + ndiags * nrows * value_size;
+  }
+
+  throw Morpheus::RuntimeException("Selected invalid format.");
+}
+
+bool MorpheusFitsMemoryBudget(const typename Morpheus::Csr::HostMirror& Acsr,
+                              int fmt) {
+  if (memory_budget <= 0) return true;
+
+  return charged_bytes + reserved_bytes + MorpheusEstimateMemory(Acsr, fmt) <=
+         memory_budget;
+}
+
+int MorpheusFitMemoryBudget(const typename Morpheus::Csr::HostMirror& Acsr,
+                            int fmt) {
+  if (memory_budget <= 0) return fmt;
+
+  int selected = fmt;
+  if (!MorpheusFitsMemoryBudget(Acsr, fmt)) {
+    // CSR is the most compact of the supported formats, so keep it if even
+    // that does not fit and report the overrun
+    selected = Morpheus::CSR_FORMAT;
+    overruns++;
+    for (const int candidate : fallback_formats) {
+      if (MorpheusFitsMemoryBudget(Acsr, candidate)) {
+        selected = candidate;
+        overruns--;
+        break;
+      }
+    }
+    fallbacks++;
+  }
+
+  reserved_bytes += MorpheusEstimateMemory(Acsr, selected);
+  return selected;
+}
+
+void MorpheusChargeMemoryBudget(const SparseMatrix& A) {
+  charged_bytes += MorpheusSparseMatrixGetLocalProperties(A).memory;
+#if defined(HPCG_WITH_SPLIT_DISTRIBUTED)
+  charged_bytes += MorpheusSparseMatrixGetGhostProperties(A).memory;
+#endif  // HPCG_WITH_SPLIT_DISTRIBUTED
+  reserved_bytes = 0.0;
+}
+
+void MorpheusReleaseMemoryBudget(const SparseMatrix& A) {
+  charged_bytes -= MorpheusSparseMatrixGetLocalProperties(A).memory;
+#if defined(HPCG_WITH_SPLIT_DISTRIBUTED)
+  charged_bytes -= MorpheusSparseMatrixGetGhostProperties(A).memory;
+#endif  // HPCG_WITH_SPLIT_DISTRIBUTED
+}
+
+void ReportMemoryBudget() {
+  if (memory_budget <= 0) return;
+
+  int rank         = 0;
+  double max_bytes = charged_bytes;
+  int counts[2]    = {fallbacks, overruns};
+  int totals[2]    = {fallbacks, overruns};
+
+#ifndef HPCG_NO_MPI
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  MPI_Reduce(&charged_bytes, &max_bytes, 1, MPI_DOUBLE, MPI_MAX, 0,
+             MPI_COMM_WORLD);
+  MPI_Reduce(counts, totals, 2, MPI_INT, MPI_SUM, 0, MPI_COMM_WORLD);
+#endif
+
+  if (rank == 0) {
+    std::cout << "Memory budget: " << max_bytes << " of " << memory_budget
+              << " bytes used by the matrices of the fullest process, "
+              << totals[0] << " format fallbacks, " << totals[1]
+              << " over budget" << std::endl;
+  }
+}
+
+#endif  // HPCG_WITH_MORPHEUS_DYNAMIC
+#endif  // HPCG_WITH_MORPHEUS
@@ -0,0 +1,50 @@
+/**
+ * Morpheus_MemoryBudget.hpp
+ *
+ * EPCC, The University of Edinburgh
+ *
+ * (c) 2022 The University of Edinburgh
+ *
+ * Contributing Authors:
+ * Christodoulos Stylianou (c.stylianou@ed.ac.uk)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef HPCG_MORPHEUS_MEMORYBUDGET_HPP
+#define HPCG_MORPHEUS_MEMORYBUDGET_HPP
+
+#ifdef HPCG_WITH_MORPHEUS
+#if defined(HPCG_WITH_MORPHEUS_DYNAMIC)
+#include "SparseMatrix.hpp"
+#include "morpheus/Morpheus.hpp"
+
+// Bytes Morpheus allocates to hold Acsr in fmt, without converting it
+double MorpheusEstimateMemory(const typename Morpheus::Csr::HostMirror& Acsr,
+                              int fmt);
+// Whether Acsr in fmt fits in what is left of the per-process budget
+bool MorpheusFitsMemoryBudget(const typename Morpheus::Csr::HostMirror& Acsr,
+                              int fmt);
+// Returns fmt if it fits, otherwise the first fallback format that does, and
+// reserves its estimate until the matrix is charged
+int MorpheusFitMemoryBudget(const typename Morpheus::Csr::HostMirror& Acsr,
+                            int fmt);
+// Charges the exact bytes of the optimized A, replacing its reservations
+void MorpheusChargeMemoryBudget(const SparseMatrix& A);
+// Returns the bytes charged for A, before its local matrix changes format
+void MorpheusReleaseMemoryBudget(const SparseMatrix& A);
+void ReportMemoryBudget();
+#endif  // HPCG_WITH_MORPHEUS_DYNAMIC
+
+#endif  // HPCG_WITH_MORPHEUS
+#endif  // HPCG_MORPHEUS_MEMORYBUDGET_HPP
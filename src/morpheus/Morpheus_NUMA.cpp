@@ -0,0 +1,183 @@
+/**
+ * Morpheus_NUMA.cpp
+ *
+ * EPCC, The University of Edinburgh
+ *
+ * (c) 2022 The University of Edinburgh
+ *
+ * Contributing Authors:
+ * Christodoulos Stylianou (c.stylianou@ed.ac.uk)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "morpheus/Morpheus_NUMA.hpp"
+
+#if defined(HPCG_WITH_MORPHEUS) && defined(HPCG_WITH_NUMA_FIRST_TOUCH)
+
+#ifndef HPCG_NO_MPI
+#include <mpi.h>
+#endif
+
+#include <omp.h>
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+using index_type = Morpheus::index_type;
+using policy =
+    Kokkos::RangePolicy<Morpheus::ExecSpace, Kokkos::IndexType<index_type>>;
+
+// Process, Domain, Threads, Rows, Bytes, Time per measured domain
+const int numa_fields = 6;
+const int numa_trials = 10;
+std::vector<double> numa_sub_report;
+}  // namespace
+
+void MorpheusFirstTouch(double*& values, local_int_t length) {
+  // Pages of a fresh allocation are placed on first write, so copy with the
+  // same range policy the vector and SpMV kernels use
+  double* placed    = new double[length];
+  const double* src = values;
+
+  Kokkos::parallel_for(
+      "MorpheusFirstTouch", policy(0, length),
+      KOKKOS_LAMBDA(const index_type i) { placed[i] = src[i]; });
+  Kokkos::fence();
+
+  delete[] values;
+  values = placed;
+}
+
+void MorpheusMeasureNumaBandwidth(const Vector& x, const Vector& y,
+                                  Vector& w) {
+  const local_int_t n = w.localLength;
+  const double* xv    = x.values;
+  const double* yv    = y.values;
+  double* wv          = w.values;
+  int rank            = 0;
+
+#ifndef HPCG_NO_MPI
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+#endif
+
+  const int maxThreads = omp_get_max_threads();
+  std::vector<int> place(maxThreads, 0);
+  std::vector<local_int_t> rows(maxThreads, 0);
+  std::vector<double> time(maxThreads, 0.0);
+
+#pragma omp parallel
+  {
+    const int tid      = omp_get_thread_num();
+    const int nthreads = omp_get_num_threads();
+    // Contiguous static chunks, as handed out by the OpenMP range policy
+    const local_int_t chunk = (n + nthreads - 1) / nthreads;
+    const local_int_t begin = std::min(n, tid * chunk);
+    const local_int_t end   = std::min(n, begin + chunk);
+
+    // Without OMP_PLACES all threads are reported as a single domain
+    place[tid] = std::max(0, omp_get_place_num());
+    rows[tid]  = end - begin;
+
+#pragma omp barrier
+    double t0 = omp_get_wtime();
+    for (int t = 0; t < numa_trials; t++) {
+      for (local_int_t i = begin; i < end; i++) wv[i] = xv[i] + 0.5 * yv[i];
+    }
+    time[tid] = omp_get_wtime() - t0;
+  }
+
+  const int ndomains = *std::max_element(place.begin(), place.end()) + 1;
+  std::vector<double> domain(ndomains * numa_fields, 0.0);
+  for (int d = 0; d < ndomains; d++) {
+    domain[d * numa_fields + 0] = rank;
+    domain[d * numa_fields + 1] = d;
+  }
+  for (int tid = 0; tid < maxThreads; tid++) {
+    double* entry = &domain[place[tid] * numa_fields];
+    entry[2] += 1;
+    entry[3] += rows[tid];
+    // Two reads and one write per row and trial
+    entry[4] += 3.0 * sizeof(double) * rows[tid] * numa_trials;
+    // A domain is as fast as its slowest thread
+    entry[5] = std::max(entry[5], time[tid]);
+  }
+
+  // Skip places that had no threads bound to them
+  numa_sub_report.clear();
+  for (int d = 0; d < ndomains; d++) {
+    if (domain[d * numa_fields + 2] == 0) continue;
+    numa_sub_report.insert(numa_sub_report.end(),
+                           domain.begin() + d * numa_fields,
+                           domain.begin() + (d + 1) * numa_fields);
+  }
+}
+
+void ReportNumaBandwidth() {
+  std::string eol = "\n", del = ",";
+  std::string result = "";
+  int rank           = 0;
+  std::vector<double> report;
+
+#ifndef HPCG_NO_MPI
+  int size = 1;
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  MPI_Comm_size(MPI_COMM_WORLD, &size);
+
+  // The number of domains differs across processes
+  int count = numa_sub_report.size();
+  std::vector<int> counts(size, 0), displs(size, 0);
+  MPI_Gather(&count, 1, MPI_INT, counts.data(), 1, MPI_INT, 0,
+             MPI_COMM_WORLD);
+
+  if (rank == 0) {
+    for (int p = 1; p < size; p++) displs[p] = displs[p - 1] + counts[p - 1];
+    report.resize(displs[size - 1] + counts[size - 1]);
+  }
+
+  MPI_Gatherv(numa_sub_report.data(), count, MPI_DOUBLE, report.data(),
+              counts.data(), displs.data(), MPI_DOUBLE, 0, MPI_COMM_WORLD);
+#else
+  report.assign(numa_sub_report.begin(), numa_sub_report.end());
+#endif
+
+  if (rank == 0) {
+    std::stringstream header;
+    header << "Process" << del << "Domain" << del << "Threads" << del
+           << "Rows" << del << "Bytes" << del << "Time(s)" << del
+           << "Bandwidth(GB/s)";
+
+    result += header.str() + eol;
+    for (size_t i = 0; i < report.size(); i += numa_fields) {
+      const double* entry = &report[i];
+      double bw = entry[5] > 0 ? entry[4] / entry[5] / 1.0e9 : 0.0;
+
+      std::stringstream val;
+      val << (int)entry[0] << del << (int)entry[1] << del << (int)entry[2]
+          << del << (local_int_t)entry[3] << del << std::setprecision(14)
+          << entry[4] << del << entry[5] << del << bw;
+
+      result += val.str() + eol;
+    }
+
+    std::ofstream out("morpheus-numa-output.txt");
+    out << result;
+  }
+}
+
+#endif  // HPCG_WITH_MORPHEUS && HPCG_WITH_NUMA_FIRST_TOUCH
@@ -0,0 +1,57 @@
+/**
+ * Morpheus_NUMA.hpp
+ *
+ * EPCC, The University of Edinburgh
+ *
+ * (c) 2022 The University of Edinburgh
+ *
+ * Contributing Authors:
+ * Christodoulos Stylianou (c.stylianou@ed.ac.uk)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef HPCG_MORPHEUS_NUMA_HPP
+#define HPCG_MORPHEUS_NUMA_HPP
+
+#ifdef HPCG_WITH_MORPHEUS
+#include "morpheus/Morpheus.hpp"
+#include "Vector.hpp"
+
+// Allocates the device copy of a host/device container pair and copies the
+// host data across. With first-touch placement the device copy is always a
+// new allocation, zero-initialised in parallel by the execution space, so
+// each page lands on the NUMA domain of the thread that owns its rows. The
+// host copy, touched serially, is then released and aliases the new one.
+template <typename Container>
+void MorpheusSendToDevice(Container& c) {
+#if defined(HPCG_WITH_NUMA_FIRST_TOUCH)
+  c.dev = Morpheus::create_mirror<Morpheus::Space>(c.host);
+  Morpheus::copy(c.host, c.dev);
+  // First touch is only available on the OpenMP backend, so this is a view
+  c.host = Morpheus::create_mirror_container(c.dev);
+#else
+  c.dev = Morpheus::create_mirror_container<Morpheus::Space>(c.host);
+  Morpheus::copy(c.host, c.dev);
+#endif
+}
+
+#if defined(HPCG_WITH_NUMA_FIRST_TOUCH)
+void MorpheusFirstTouch(double*& values, local_int_t length);
+void MorpheusMeasureNumaBandwidth(const Vector& x, const Vector& y,
+                                  Vector& w);
+void ReportNumaBandwidth();
+#endif  // HPCG_WITH_NUMA_FIRST_TOUCH
+
+#endif  // HPCG_WITH_MORPHEUS
+#endif  // HPCG_MORPHEUS_NUMA_HPP
@@ -28,23 +28,47 @@
 #if defined(HPCG_WITH_MULTI_FORMATS)
 #include "morpheus/Morpheus_ReadHpcgDat.hpp"
 #endif  // HPCG_WITH_MULTI_FORMATS
+#if defined(HPCG_WITH_MORPHEUS_DYNAMIC)
+#include "morpheus/Morpheus_FormatPredictor.hpp"
+#endif  // HPCG_WITH_MORPHEUS_DYNAMIC
 
 #ifndef HPCG_NO_MPI
 #include <mpi.h>
 #endif
 
+#include <climits>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
 #include <string>
 
+#include "hpcg.hpp"
+
 int local_matrix_fmt;
 #if defined(HPCG_WITH_SPLIT_DISTRIBUTED)
 int ghost_matrix_fmt;
 #endif  // HPCG_WITH_SPLIT_DISTRIBUTED
+int lean_mode;
+#ifdef HPCG_WITH_MORPHEUS_DYNAMIC
+int autotune_trials;
+int predict_formats;
+std::vector<std::vector<int>> sweep_formats;
+double memory_budget;
+std::string matrix_cache_dir;
+#ifdef HPCG_WITH_MULTI_FORMATS
+int adaptive_sets;
+#endif  // HPCG_WITH_MULTI_FORMATS
+#endif  // HPCG_WITH_MORPHEUS_DYNAMIC
 
 #ifdef HPCG_WITH_MULTI_FORMATS
-std::vector<format_id> local_input_file;
+format_map<int> local_input_file;
 #if defined(HPCG_WITH_SPLIT_DISTRIBUTED)
-std::vector<format_id> ghost_input_file;
+format_map<int> ghost_input_file;
 #endif  // HPCG_WITH_SPLIT_DISTRIBUTED
+#if defined(HPCG_WITH_BLOCK_FORMATS)
+format_map<std::vector<int>> local_block_input_file;
+#endif  // HPCG_WITH_BLOCK_FORMATS
 #endif  // HPCG_WITH_MULTI_FORMATS
 
 static int startswith(const char* s, const char* prefix) {
@@ -53,10 +77,40 @@ static int startswith(const char* s, const char* prefix) {
   return 1;
 }
 
+#ifdef HPCG_WITH_MORPHEUS_DYNAMIC
+// Reports an option that is ignored, on the first process only
+static void ReportIgnoredOption(const std::string& option,
+                                const std::string& reason) {
+  int rank = 0;
+#ifndef HPCG_NO_MPI
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+#endif
+  if (rank != 0) return;
+  std::cerr << "Ignoring " << option << ": " << reason << std::endl;
+  HPCG_fout << "Ignoring " << option << ": " << reason << std::endl;
+}
+
+// Parses the value of an option as a non-negative integer. Returns false and
+// reports the option when the value is not one.
+static bool ParseCount(const std::string& option, const std::string& value,
+                       int& count) {
+  char* end         = 0;
+  const long parsed = std::strtol(value.c_str(), &end, 10);
+  if (value.empty() || *end != '\0' || parsed < 0 || parsed > INT_MAX) {
+    ReportIgnoredOption(option, "expected a non-negative integer");
+    return false;
+  }
+  count = (int)parsed;
+  return true;
+}
+#endif  // HPCG_WITH_MORPHEUS_DYNAMIC
+
 #if defined(HPCG_WITH_MULTI_FORMATS)
-void ParseInputFileFormats_Impl(int argc, char* argv[], std::string prefix,
-                                std::vector<format_id>& input_file) {
-  std::string filename, tag("--hpcg-" + prefix + "-formats=");
+// Returns the contents of the formats file, read once on rank 0
+std::string ParseInputFileFormats_Impl(int argc, char* argv[],
+                                       std::string prefix,
+                                       format_map<int>& input_file) {
+  std::string filename, contents, tag("--hpcg-" + prefix + "-formats=");
 
   int rank = 0;
 #ifndef HPCG_NO_MPI
@@ -73,13 +127,29 @@ void ParseInputFileFormats_Impl(int argc, char* argv[], std::string prefix,
                   << " formats from: " << filename << std::endl;
       }
 
-      ReadMorpheusDat(filename, input_file);
+      // Collective, every rank is given the same arguments
+      if (ReadMorpheusDatFile(filename, contents) == 0) {
+        ReadMorpheusDat(contents, rank, input_file);
+      }
     }
   }
+
+  return contents;
 }
 
 void ParseInputFileFormats(int argc, char* argv[]) {
-  ParseInputFileFormats_Impl(argc, argv, "local", local_input_file);
+  std::string local_contents =
+      ParseInputFileFormats_Impl(argc, argv, "local", local_input_file);
+#if defined(HPCG_WITH_BLOCK_FORMATS)
+  int rank = 0;
+#ifndef HPCG_NO_MPI
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+#endif
+  // The same file may list a format per row block of the local matrix
+  if (!local_contents.empty()) {
+    ReadMorpheusBlockDat(local_contents, rank, local_block_input_file);
+  }
+#endif  // HPCG_WITH_BLOCK_FORMATS
 
 #if defined(HPCG_WITH_SPLIT_DISTRIBUTED)
   ParseInputFileFormats_Impl(argc, argv, "ghost", ghost_input_file);
@@ -101,12 +171,160 @@ void ParseFormat_Impl(int argc, char* argv[], std::string prefix,
   }
 }
 
+void ParseLeanMode(int argc, char* argv[]) {
+  lean_mode = 0;  // Default keeps the reference arrays
+  for (int i = 1; i <= argc && argv[i]; ++i) {
+    if (startswith(argv[i], "--lean")) lean_mode = 1;
+  }
+}
+
+#ifdef HPCG_WITH_MORPHEUS_DYNAMIC
+void ParseAutotune(int argc, char* argv[]) {
+  std::string entry, tag("--autotune-formats");
+  autotune_trials = 0;  // Default is the selected formats
+  for (int i = 1; i <= argc && argv[i]; ++i) {
+    if (startswith(argv[i], tag.c_str())) {
+      entry = std::string(argv[i]);
+      entry.erase(entry.find(tag), tag.length());
+
+      // --autotune-formats[=trials]
+      autotune_trials = 10;
+      if (!entry.empty() &&
+          !ParseCount(argv[i], entry.substr(1), autotune_trials))
+        autotune_trials = 0;
+    }
+  }
+#if defined(HPCG_WITH_HYBRID_LOCAL) || defined(HPCG_WITH_BLOCK_FORMATS)
+  // The hybrid and block layouts keep the local matrix in their own types
+  if (autotune_trials > 0)
+    ReportIgnoredOption(tag, "not available with hybrid or block layouts");
+  autotune_trials = 0;
+#endif  // HPCG_WITH_HYBRID_LOCAL || HPCG_WITH_BLOCK_FORMATS
+}
+
+void ParsePredictor(int argc, char* argv[]) {
+  std::string entry, tag("--predict-formats");
+  predict_formats = 0;
+  for (int i = 1; i <= argc && argv[i]; ++i) {
+    if (startswith(argv[i], tag.c_str())) {
+      entry = std::string(argv[i]);
+      entry.erase(entry.find(tag), tag.length());
+
+      // --predict-formats[=model-file]
+      predict_formats = 1;
+      if (!entry.empty()) entry.erase(0, 1);
+    }
+  }
+
+  // Collective, so every rank sets up the model even when disabled
+  MorpheusSetupFormatPredictor(predict_formats ? entry : std::string());
+}
+
+// --format-sweep=entry[:entry...] where each entry lists the local format of
+// every MG level, e.g. "1:2:1,2,2,2"
+void ParseFormatSweep(int argc, char* argv[]) {
+  std::string entry, tag("--format-sweep=");
+  sweep_formats.clear();
+  for (int i = 1; i <= argc && argv[i]; ++i) {
+    if (startswith(argv[i], tag.c_str())) {
+      entry = std::string(argv[i]);
+      entry.erase(entry.find(tag), tag.length());
+
+      std::stringstream entries(entry);
+      std::string levels, format;
+      while (std::getline(entries, levels, ':')) {
+        std::stringstream formats(levels);
+        std::vector<int> sweep;
+        bool valid = true;
+        while (valid && std::getline(formats, format, ',')) {
+          int fmt = 0;
+          valid   = ParseCount(tag + levels, format, fmt);
+          sweep.push_back(fmt);
+        }
+        // Entries with a bad format are reported and left out
+        if (valid && sweep.size() > 0) sweep_formats.push_back(sweep);
+      }
+    }
+  }
+}
+
+// --memory-budget=bytes[K|M|G]
+void ParseMemoryBudget(int argc, char* argv[]) {
+  std::string entry, tag("--memory-budget=");
+  memory_budget = 0;  // Default is unlimited
+  for (int i = 1; i <= argc && argv[i]; ++i) {
+    if (startswith(argv[i], tag.c_str())) {
+      entry = std::string(argv[i]);
+      entry.erase(entry.find(tag), tag.length());
+
+      char* end        = 0;
+      memory_budget    = std::strtod(entry.c_str(), &end);
+      const size_t pos = end - entry.c_str();
+      // Optional binary suffix, e.g. 512M
+      const size_t unit = std::string("KMG").find(entry.c_str()[pos]);
+      if (pos < entry.size() && unit != std::string::npos) {
+        memory_budget *= std::pow(1024.0, unit + 1);
+      }
+
+      const size_t length = pos + (unit != std::string::npos ? 1 : 0);
+      if (pos == 0 || length != entry.size() || !(memory_budget > 0)) {
+        ReportIgnoredOption(argv[i], "expected a positive size");
+        memory_budget = 0;
+      }
+    }
+  }
+}
+
+// --matrix-cache=directory
+void ParseMatrixCache(int argc, char* argv[]) {
+  std::string tag("--matrix-cache=");
+  matrix_cache_dir.clear();  // Default converts at every run
+  for (int i = 1; i <= argc && argv[i]; ++i) {
+    if (startswith(argv[i], tag.c_str())) {
+      matrix_cache_dir = std::string(argv[i]);
+      matrix_cache_dir.erase(matrix_cache_dir.find(tag), tag.length());
+    }
+  }
+}
+
+#ifdef HPCG_WITH_MULTI_FORMATS
+void ParseAdaptive(int argc, char* argv[]) {
+  std::string entry, tag("--adaptive-formats");
+  adaptive_sets = 0;  // Default keeps the initial formats
+  for (int i = 1; i <= argc && argv[i]; ++i) {
+    if (startswith(argv[i], tag.c_str())) {
+      entry = std::string(argv[i]);
+      entry.erase(entry.find(tag), tag.length());
+
+      // --adaptive-formats[=sets]
+      adaptive_sets = 2;
+      if (!entry.empty() &&
+          !ParseCount(argv[i], entry.substr(1), adaptive_sets))
+        adaptive_sets = 0;
+    }
+  }
+}
+#endif  // HPCG_WITH_MULTI_FORMATS
+#endif  // HPCG_WITH_MORPHEUS_DYNAMIC
+
 void ParseFormats(int argc, char* argv[]) {
   ParseFormat_Impl(argc, argv, "local", &local_matrix_fmt);
 
 #if defined(HPCG_WITH_SPLIT_DISTRIBUTED)
   ParseFormat_Impl(argc, argv, "ghost", &ghost_matrix_fmt);
 #endif  // HPCG_WITH_SPLIT_DISTRIBUTED
+  ParseLeanMode(argc, argv);
+
+#ifdef HPCG_WITH_MORPHEUS_DYNAMIC
+  ParseAutotune(argc, argv);
+  ParsePredictor(argc, argv);
+  ParseFormatSweep(argc, argv);
+  ParseMemoryBudget(argc, argv);
+  ParseMatrixCache(argc, argv);
+#ifdef HPCG_WITH_MULTI_FORMATS
+  ParseAdaptive(argc, argv);
+#endif  // HPCG_WITH_MULTI_FORMATS
+#endif  // HPCG_WITH_MORPHEUS_DYNAMIC
 }
 
 #endif  // HPCG_WITH_MORPHEUS
\ No newline at end of file
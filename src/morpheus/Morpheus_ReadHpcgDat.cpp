@@ -27,54 +27,171 @@
 #if defined(HPCG_WITH_MULTI_FORMATS)
 
 #include "morpheus/Morpheus.hpp"
+#include "hpcg.hpp"
 
-static int SkipUntilEol(FILE *stream) {
-  int chOrEof;
-  bool finished;
+#ifndef HPCG_NO_MPI
+#include <mpi.h>
+#endif
 
-  do {
-    chOrEof  = fgetc(stream);
-    finished = (chOrEof == EOF) || (chOrEof == '\n') || (chOrEof == '\r');
-  } while (!finished);
+#include <climits>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
 
-  if ('\r' == chOrEof) {  // on Windows, \r might be followed by \n
-    int chOrEofExtra = fgetc(stream);
+namespace {
+// Parses a whole field as an integer of at least min
+bool ParseField(const std::string &field, int min, int &value) {
+  char *end         = 0;
+  const long parsed = std::strtol(field.c_str(), &end, 10);
+  if (field.empty() || *end != '\0' || parsed < min || parsed > INT_MAX) {
+    return false;
+  }
+  value = (int)parsed;
+  return true;
+}
 
-    if ('\n' == chOrEofExtra || EOF == chOrEofExtra)
-      chOrEof = chOrEofExtra;
-    else
-      ungetc(chOrEofExtra, stream);
+// Sets priority to that of a rule with the given rank and level fields for
+// this rank, or to -1 if it does not apply. Ranks are "N", "first-last" or
+// "*", levels are "N" or "*", which sets level to -1. Returns false, for
+// every rank alike, when a field is malformed.
+bool MatchRule(const std::string &ranks, const std::string &levels, int rank,
+               int &priority, int &level) {
+  int rank_priority = 0, first = 0, last = INT_MAX;
+  size_t dash       = ranks.find('-');
+
+  if (ranks == "*") {
+    rank_priority = 0;
+  } else if (dash != std::string::npos && dash > 0) {
+    if (!ParseField(ranks.substr(0, dash), 0, first) ||
+        !ParseField(ranks.substr(dash + 1), 0, last)) {
+      return false;
+    }
+    rank_priority = 1;
+  } else {
+    if (!ParseField(ranks, 0, first)) return false;
+    last          = first;
+    rank_priority = 2;
   }
 
-  return chOrEof;
+  level = -1;
+  if (levels != "*" && !ParseField(levels, 0, level)) return false;
+
+  priority = -1;
+  if (rank >= first && rank <= last)
+    priority = 2 * rank_priority + (level >= 0 ? 1 : 0);
+  return true;
 }
 
-int ReadMorpheusDat(std::string filename, std::vector<format_id> &input_file) {
-  FILE *morpheusStream = fopen(filename.c_str(), "r");
-
-  if (!morpheusStream) return -1;
-
-  format_id entry;
-  do {
-    // TODO: No fancy checks here yet.
-#ifdef HPCG_NO_LONG_LONG
-    int error = fscanf(morpheusStream, "%d", &entry.rank);
-#else
-    int error = fscanf(morpheusStream, "%lld", &entry.rank);
-#endif  // HPCG_NO_LONG_LONG
-    if (error != 1) {
-      break;
-    }
-    fscanf(morpheusStream, "%d", &entry.mg_level);
-    fscanf(morpheusStream, "%d", &entry.format);
+template <typename T>
+void InsertRule(format_map<T> &input_file, int priority, int level,
+                const T &value) {
+  std::pair<int, T> &entry =
+      (level < 0) ? input_file.all_levels
+                  : input_file.levels.emplace(level, std::make_pair(-1, T()))
+                        .first->second;
 
-    input_file.push_back(entry);
-  } while (SkipUntilEol(morpheusStream) != EOF);
+  // Later lines override earlier ones of the same priority
+  if (priority >= entry.first) entry = std::make_pair(priority, value);
+}
 
-  fclose(morpheusStream);
+// Calls insert(priority, level, formats) for every line that applies to rank.
+// Malformed lines are skipped, and reported when report is set.
+template <typename Insert>
+int ParseMorpheusDat(const std::string &contents, int rank, bool report,
+                     Insert insert) {
+  std::istringstream morpheusStream(contents);
+  std::string line;
+  int number = 0;
+
+  while (std::getline(morpheusStream, line)) {
+    std::istringstream tokens(line);
+    std::string ranks, levels, field;
+    number++;
+
+    if (!(tokens >> ranks) || ranks[0] == '#') continue;
+
+    // A format of -1 selects the format of a row block automatically, and a
+    // comment may follow the formats
+    std::vector<int> formats;
+    int format = 0;
+    bool valid = static_cast<bool>(tokens >> levels);
+    while (valid && tokens >> field && field[0] != '#') {
+      valid = ParseField(field, -1, format);
+      formats.push_back(format);
+    }
+
+    int level = -1, priority = -1;
+    valid = valid && formats.size() > 0 &&
+            MatchRule(ranks, levels, rank, priority, level);
+    if (!valid) {
+      if (report) {
+        std::cerr << "Skipping line " << number << " of the formats file: "
+                  << line << std::endl;
+        HPCG_fout << "Skipping line " << number << " of the formats file: "
+                  << line << std::endl;
+      }
+      continue;
+    }
+    if (priority >= 0) insert(priority, level, formats);
+  }
 
   return 0;
 }
+}  // namespace
+
+int ReadMorpheusDatFile(std::string filename, std::string &contents) {
+  int rank = 0, length = -1;
+#ifndef HPCG_NO_MPI
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+#endif
+
+  // Only rank 0 touches the filesystem
+  if (rank == 0) {
+    std::ifstream in(filename);
+    if (in) {
+      std::stringstream buffer;
+      buffer << in.rdbuf();
+      contents = buffer.str();
+      length   = contents.size();
+    }
+  }
+
+#ifndef HPCG_NO_MPI
+  MPI_Bcast(&length, 1, MPI_INT, 0, MPI_COMM_WORLD);
+  if (length < 0) return -1;
+
+  contents.resize(length);
+  MPI_Bcast(&contents[0], length, MPI_CHAR, 0, MPI_COMM_WORLD);
+#endif
+
+  return length < 0 ? -1 : 0;
+}
+
+// Each line is "ranks levels format", see MatchRule
+int ReadMorpheusDat(const std::string &contents, int rank,
+                    format_map<int> &input_file) {
+  return ParseMorpheusDat(
+      contents, rank, rank == 0,
+      [&](int priority, int level, const std::vector<int> &formats) {
+        InsertRule(input_file, priority, level, formats[0]);
+      });
+}
+
+#if defined(HPCG_WITH_BLOCK_FORMATS)
+// Each line is "ranks levels format [format ...]". With more than one format
+// the local matrix is split in as many contiguous row blocks, and a format of
+// -1 selects the format of that block automatically. Malformed lines have
+// already been reported by ReadMorpheusDat.
+int ReadMorpheusBlockDat(const std::string &contents, int rank,
+                         format_map<std::vector<int>> &input_file) {
+  return ParseMorpheusDat(
+      contents, rank, false,
+      [&](int priority, int level, const std::vector<int> &formats) {
+        InsertRule(input_file, priority, level, formats);
+      });
+}
+#endif  // HPCG_WITH_BLOCK_FORMATS
 
 #endif  // HPCG_WITH_MULTI_FORMATS
-#endif  // HPCG_WITH_MULTI_FORMATS
\ No newline at end of file
+#endif  // HPCG_WITH_MORPHEUS
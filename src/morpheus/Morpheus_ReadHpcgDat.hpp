@@ -29,7 +29,19 @@
 #include "morpheus/Morpheus.hpp"
 #include <string>
 
-int ReadMorpheusDat(std::string filename, std::vector<format_id> &input_file);
+#if defined(HPCG_WITH_MULTI_FORMATS)
+// Reads the file on rank 0 and broadcasts its contents to all processes
+int ReadMorpheusDatFile(std::string filename, std::string &contents);
+
+// Compiles the rules of a formats file that apply to the given rank
+int ReadMorpheusDat(const std::string &contents, int rank,
+                    format_map<int> &input_file);
+
+#if defined(HPCG_WITH_BLOCK_FORMATS)
+int ReadMorpheusBlockDat(const std::string &contents, int rank,
+                         format_map<std::vector<int>> &input_file);
+#endif  // HPCG_WITH_BLOCK_FORMATS
+#endif  // HPCG_WITH_MULTI_FORMATS
 
 #endif  // HPCG_WITH_MORPHEUS
 #endif  // HPCG_MORPHEUS_READHPCGDAT_HPP
\ No newline at end of file
@@ -25,10 +25,23 @@
 
 #if defined(HPCG_WITH_MORPHEUS)
 #include "morpheus/Morpheus.hpp"
+#include "morpheus/Morpheus_LeanMode.hpp"
 
 #if defined(HPCG_WITH_MULTI_FORMATS)
 #include "morpheus/Morpheus_Timer.hpp"
 #endif
+#if defined(HPCG_WITH_NUMA_FIRST_TOUCH)
+#include "morpheus/Morpheus_NUMA.hpp"
+#endif
+#if defined(HPCG_WITH_MORPHEUS_DYNAMIC)
+#include "morpheus/Morpheus_Autotune.hpp"
+#include "morpheus/Morpheus_FormatPredictor.hpp"
+#include "morpheus/Morpheus_MatrixCache.hpp"
+#include "morpheus/Morpheus_MemoryBudget.hpp"
+#endif
+#if defined(HPCG_WITH_MULTI_FORMATS) && defined(HPCG_WITH_MORPHEUS_DYNAMIC)
+#include "morpheus/Morpheus_AdaptiveFormats.hpp"
+#endif
 
 #include <sstream>
 #include <fstream>
@@ -92,8 +105,8 @@ void MPI_FORMAT_REPORT_type_construct() {
 }
 #if defined(HPCG_WITH_MULTI_FORMATS)
 void MPI_MORPHEUS_TIMERS_type_construct() {
-  int lengths[7] = {1, 1, 1, 1, 1, 1, 1};
-  MPI_Aint displacements[7];
+  int lengths[8] = {1, 1, 1, 1, 1, 1, 1, 1};
+  MPI_Aint displacements[8];
   MPI_Aint base_address;
   morpheus_timers dummy_timer;
 
@@ -105,6 +118,7 @@ void MPI_MORPHEUS_TIMERS_type_construct() {
   MPI_Get_address(&dummy_timer.CG, &displacements[4]);
   MPI_Get_address(&dummy_timer.SPMV_LOCAL, &displacements[5]);
   MPI_Get_address(&dummy_timer.SPMV_GHOST, &displacements[6]);
+  MPI_Get_address(&dummy_timer.SPMV_CALLS, &displacements[7]);
   displacements[0] = MPI_Aint_diff(displacements[0], base_address);
   displacements[1] = MPI_Aint_diff(displacements[1], base_address);
   displacements[2] = MPI_Aint_diff(displacements[2], base_address);
@@ -112,10 +126,11 @@ void MPI_MORPHEUS_TIMERS_type_construct() {
   displacements[4] = MPI_Aint_diff(displacements[4], base_address);
   displacements[5] = MPI_Aint_diff(displacements[5], base_address);
   displacements[6] = MPI_Aint_diff(displacements[6], base_address);
+  displacements[7] = MPI_Aint_diff(displacements[7], base_address);
 
-  MPI_Datatype types[7] = {MPI_DOUBLE, MPI_DOUBLE, MPI_DOUBLE, MPI_DOUBLE,
-                           MPI_DOUBLE, MPI_DOUBLE, MPI_DOUBLE};
-  MPI_Type_create_struct(7, lengths, displacements, types,
+  MPI_Datatype types[8] = {MPI_DOUBLE, MPI_DOUBLE, MPI_DOUBLE, MPI_DOUBLE,
+                           MPI_DOUBLE, MPI_DOUBLE, MPI_DOUBLE, MPI_DOUBLE};
+  MPI_Type_create_struct(8, lengths, displacements, types,
                          &MPI_MORPHEUS_TIMERS);
   MPI_Type_commit(&MPI_MORPHEUS_TIMERS);
 }
@@ -222,10 +237,136 @@ void ReportResults_Impl(std::string prefix, std::vector<format_report>& report,
   }
 }
 
+#if defined(HPCG_WITH_HYBRID_LOCAL)
+// Expects the interior and boundary reports to be gathered on rank 0
+void ReportHybridFractions() {
+  std::string eol = "\n", del = ",";
+  std::string result = "";
+  int rank           = 0;
+
+#ifndef HPCG_NO_MPI
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+#endif
+
+  if (rank == 0) {
+    std::stringstream header;
+    header << "Process" << del << "MG_Level" << del << "Interior_Rows" << del
+           << "Boundary_Rows" << del << "Interior_Fraction" << del
+           << "Interior_Memory(Bytes)" << del << "Boundary_Memory(Bytes)";
+
+    result += header.str() + eol;
+    for (size_t i = 0; i < interior_morpheus_report.size(); i++) {
+      const format_report& interior = interior_morpheus_report[i];
+      const format_report& boundary = boundary_morpheus_report[i];
+
+      double nrows    = (double)interior.nrows + (double)boundary.nrows;
+      double fraction = nrows > 0 ? interior.nrows / nrows : 0.0;
+
+      std::stringstream val;
+      val << interior.id.rank << del << interior.id.mg_level << del
+          << interior.nrows << del << boundary.nrows << del << fraction << del
+          << std::setprecision(14) << interior.memory << del
+          << std::setprecision(14) << boundary.memory;
+
+      result += val.str() + eol;
+    }
+
+    std::ofstream out("morpheus-hybrid-output.txt");
+    out << result;
+  }
+}
+#endif  // HPCG_WITH_HYBRID_LOCAL
+
+#if defined(HPCG_WITH_BLOCK_FORMATS)
+void ReportBlockResults() {
+  std::string eol = "\n", del = ",";
+  std::string result = "";
+  int rank           = 0;
+
+#ifndef HPCG_NO_MPI
+  int size = 1;
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  MPI_Comm_size(MPI_COMM_WORLD, &size);
+  MPI_FORMAT_REPORT_type_construct();
+
+  // The number of blocks differs across processes
+  int count = block_sub_report.size();
+  std::vector<int> counts(size, 0), displs(size, 0);
+  MPI_Gather(&count, 1, MPI_INT, counts.data(), 1, MPI_INT, 0,
+             MPI_COMM_WORLD);
+
+  if (rank == 0) {
+    for (int p = 1; p < size; p++) displs[p] = displs[p - 1] + counts[p - 1];
+    block_morpheus_report.resize(displs[size - 1] + counts[size - 1]);
+  }
+
+  MPI_Gatherv(block_sub_report.data(), count, MPI_FORMAT_REPORT,
+              block_morpheus_report.data(), counts.data(), displs.data(),
+              MPI_FORMAT_REPORT, 0, MPI_COMM_WORLD);
+#else
+  block_morpheus_report.assign(block_sub_report.begin(),
+                               block_sub_report.end());
+#endif
+
+  if (rank == 0) {
+    std::stringstream header;
+    header << "Process" << del << "MG_Level" << del << "Block" << del
+           << "Format" << del << "NRows" << del << "Ncols" << del << "Nnnz"
+           << del << "Memory(Bytes)";
+
+    result += header.str() + eol;
+    int block = 0;
+    for (size_t i = 0; i < block_morpheus_report.size(); i++) {
+      const format_report& entry = block_morpheus_report[i];
+      // Blocks of the same process and level are stored consecutively
+      if (i > 0 && (entry.id.rank != block_morpheus_report[i - 1].id.rank ||
+                    entry.id.mg_level !=
+                        block_morpheus_report[i - 1].id.mg_level)) {
+        block = 0;
+      }
+
+      std::stringstream val;
+      val << entry.id.rank << del << entry.id.mg_level << del << block++
+          << del << entry.id.format << del << entry.nrows << del
+          << entry.ncols << del << entry.nnnz << del << std::setprecision(14)
+          << entry.memory;
+
+      result += val.str() + eol;
+    }
+
+    std::ofstream out("morpheus-blocks-output.txt");
+    out << result;
+  }
+}
+#endif  // HPCG_WITH_BLOCK_FORMATS
+
 void ReportResults() {
   ReportResults_Impl("local", local_morpheus_report, local_sub_report);
 #if defined(HPCG_WITH_SPLIT_DISTRIBUTED)
   ReportResults_Impl("ghost", ghost_morpheus_report, ghost_sub_report);
 #endif  // HPCG_WITH_SPLIT_DISTRIBUTED
+#if defined(HPCG_WITH_HYBRID_LOCAL)
+  ReportResults_Impl("interior", interior_morpheus_report,
+                     interior_sub_report);
+  ReportResults_Impl("boundary", boundary_morpheus_report,
+                     boundary_sub_report);
+  ReportHybridFractions();
+#endif  // HPCG_WITH_HYBRID_LOCAL
+#if defined(HPCG_WITH_BLOCK_FORMATS)
+  ReportBlockResults();
+#endif  // HPCG_WITH_BLOCK_FORMATS
+#if defined(HPCG_WITH_MORPHEUS_DYNAMIC)
+  ReportAutotuneResults();
+  ReportPredictorResults();
+  ReportMemoryBudget();
+  ReportMatrixCache();
+#endif  // HPCG_WITH_MORPHEUS_DYNAMIC
+#if defined(HPCG_WITH_MULTI_FORMATS) && defined(HPCG_WITH_MORPHEUS_DYNAMIC)
+  ReportAdaptiveResults();
+#endif  // HPCG_WITH_MULTI_FORMATS && HPCG_WITH_MORPHEUS_DYNAMIC
+#if defined(HPCG_WITH_NUMA_FIRST_TOUCH)
+  ReportNumaBandwidth();
+#endif  // HPCG_WITH_NUMA_FIRST_TOUCH
+  ReportLeanMode();
 }
 #endif  // HPCG_WITH_MORPHEUS
\ No newline at end of file
@@ -0,0 +1,134 @@
+/**
+ * Morpheus_SpMM.cpp
+ *
+ * EPCC, The University of Edinburgh
+ *
+ * (c) 2022 The University of Edinburgh
+ *
+ * Contributing Authors:
+ * Christodoulos Stylianou (c.stylianou@ed.ac.uk)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "morpheus/Morpheus_SpMM.hpp"
+
+#ifdef HPCG_WITH_MORPHEUS
+
+namespace {
+using value_type = Morpheus::value_type;
+using index_type = Morpheus::index_type;
+using policy =
+    Kokkos::RangePolicy<Morpheus::ExecSpace, Kokkos::IndexType<index_type>>;
+
+template <typename Matrix>
+void MultiplyMulti_Csr(const Matrix& A, const value_type* X, const int k,
+                       value_type* Y, const bool init) {
+  const index_type* row_offsets    = A.crow_offsets().data();
+  const index_type* column_indices = A.ccolumn_indices().data();
+  const value_type* values         = A.cvalues().data();
+
+  Kokkos::parallel_for(
+      "hpcg::csr_spmm", policy(0, A.nrows()),
+      KOKKOS_LAMBDA(const index_type i) {
+        value_type* yi = Y + i * k;
+        if (init) {
+          for (int v = 0; v < k; v++) yi[v] = 0;
+        }
+        for (index_type jj = row_offsets[i]; jj < row_offsets[i + 1]; jj++) {
+          const value_type a   = values[jj];
+          const value_type* xj = X + column_indices[jj] * k;
+          for (int v = 0; v < k; v++) yi[v] += a * xj[v];
+        }
+      });
+}
+
+template <typename Matrix>
+void MultiplyMulti_Dia(const Matrix& A, const value_type* X, const int k,
+                       value_type* Y, const bool init) {
+  using values_view = Kokkos::View<const value_type**,
+                                   typename Matrix::array_layout,
+                                   Morpheus::Space, Kokkos::MemoryUnmanaged>;
+
+  const index_type* offsets = A.cdiagonal_offsets().data();
+  values_view values(A.cvalues().data(), A.cvalues().nrows(),
+                     A.cvalues().ncols());
+  const index_type ndiags = A.ndiags();
+  const index_type ncols  = A.ncols();
+
+  Kokkos::parallel_for(
+      "hpcg::dia_spmm", policy(0, A.nrows()),
+      KOKKOS_LAMBDA(const index_type i) {
+        value_type* yi = Y + i * k;
+        if (init) {
+          for (int v = 0; v < k; v++) yi[v] = 0;
+        }
+        for (index_type d = 0; d < ndiags; d++) {
+          const index_type j = i + offsets[d];
+          if ((j >= 0) && (j < ncols)) {
+            const value_type a   = values(i, d);
+            const value_type* xj = X + j * k;
+            for (int v = 0; v < k; v++) yi[v] += a * xj[v];
+          }
+        }
+      });
+}
+
+template <typename Matrix>
+void MultiplyMulti_Coo(const Matrix& A, const value_type* X, const int k,
+                       value_type* Y, const bool init) {
+  const index_type* row_indices    = A.crow_indices().data();
+  const index_type* column_indices = A.ccolumn_indices().data();
+  const value_type* values         = A.cvalues().data();
+
+  if (init) {
+    Kokkos::parallel_for(
+        "hpcg::coo_spmm_init", policy(0, A.nrows() * k),
+        KOKKOS_LAMBDA(const index_type i) { Y[i] = 0; });
+  }
+
+  // Entries of the same row may be processed concurrently
+  Kokkos::parallel_for(
+      "hpcg::coo_spmm", policy(0, A.nnnz()),
+      KOKKOS_LAMBDA(const index_type n) {
+        const value_type a   = values[n];
+        value_type* yi       = Y + row_indices[n] * k;
+        const value_type* xj = X + column_indices[n] * k;
+        for (int v = 0; v < k; v++) Kokkos::atomic_add(&yi[v], a * xj[v]);
+      });
+}
+}  // namespace
+
+void MorpheusMultiplyMulti(const Morpheus::SparseMatrix& A,
+                           const value_type* X, const int k, value_type* Y,
+                           const bool init) {
+#ifdef HPCG_WITH_MORPHEUS_DYNAMIC
+  if (A.active_enum() == Morpheus::COO_FORMAT) {
+    const typename Morpheus::Coo Acoo = A;
+    MultiplyMulti_Coo(Acoo, X, k, Y, init);
+  } else if (A.active_enum() == Morpheus::CSR_FORMAT) {
+    const typename Morpheus::Csr Acsr = A;
+    MultiplyMulti_Csr(Acsr, X, k, Y, init);
+  } else if (A.active_enum() == Morpheus::DIA_FORMAT) {
+    const typename Morpheus::Dia Adia = A;
+    MultiplyMulti_Dia(Adia, X, k, Y, init);
+  } else {
+    throw Morpheus::RuntimeException("Selected invalid format.");
+  }
+#else
+  MultiplyMulti_Csr(A, X, k, Y, init);
+#endif  // HPCG_WITH_MORPHEUS_DYNAMIC
+  Kokkos::fence();
+}
+
+#endif  // HPCG_WITH_MORPHEUS
@@ -0,0 +1,40 @@
+/**
+ * Morpheus_SpMM.hpp
+ *
+ * EPCC, The University of Edinburgh
+ *
+ * (c) 2022 The University of Edinburgh
+ *
+ * Contributing Authors:
+ * Christodoulos Stylianou (c.stylianou@ed.ac.uk)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef HPCG_MORPHEUS_SPMM_HPP
+#define HPCG_MORPHEUS_SPMM_HPP
+
+#ifdef HPCG_WITH_MORPHEUS
+#include "morpheus/Morpheus_SparseMatrix.hpp"
+
+/*!
+  Computes Y = A*X (or Y += A*X if init is false) for k interleaved vectors,
+  i.e. entry i of vector v is stored at X[i * k + v]. Each entry of A is read
+  once and applied to all k vectors.
+*/
+void MorpheusMultiplyMulti(const Morpheus::SparseMatrix& A,
+                           const Morpheus::value_type* X, const int k,
+                           Morpheus::value_type* Y, const bool init = true);
+
+#endif  // HPCG_WITH_MORPHEUS
+#endif  // HPCG_MORPHEUS_SPMM_HPP
@@ -0,0 +1,127 @@
+/**
+ * Morpheus_SpMVDot.cpp
+ *
+ * EPCC, The University of Edinburgh
+ *
+ * (c) 2022 The University of Edinburgh
+ *
+ * Contributing Authors:
+ * Christodoulos Stylianou (c.stylianou@ed.ac.uk)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "morpheus/Morpheus_SpMVDot.hpp"
+
+#ifdef HPCG_WITH_MORPHEUS
+
+namespace {
+using value_type = Morpheus::value_type;
+using index_type = Morpheus::index_type;
+using policy =
+    Kokkos::RangePolicy<Morpheus::ExecSpace, Kokkos::IndexType<index_type>>;
+
+template <typename Matrix>
+value_type MultiplyDot_Csr(const Matrix& A, const value_type* x,
+                           const value_type* w, value_type* y,
+                           const bool init) {
+  const index_type* row_offsets    = A.crow_offsets().data();
+  const index_type* column_indices = A.ccolumn_indices().data();
+  const value_type* values         = A.cvalues().data();
+
+  value_type result = 0.0;
+  Kokkos::parallel_reduce(
+      "hpcg::csr_spmv_dot", policy(0, A.nrows()),
+      KOKKOS_LAMBDA(const index_type i, value_type& sum) {
+        value_type yi = init ? value_type(0) : y[i];
+        for (index_type jj = row_offsets[i]; jj < row_offsets[i + 1]; jj++) {
+          yi += values[jj] * x[column_indices[jj]];
+        }
+        y[i] = yi;
+        sum += w[i] * yi;
+      },
+      result);
+
+  return result;
+}
+
+template <typename Matrix>
+value_type MultiplyDot_Dia(const Matrix& A, const value_type* x,
+                           const value_type* w, value_type* y,
+                           const bool init) {
+  // Values are stored as an (nrows x ndiags) dense matrix, wrap it with the
+  // same layout so that we can index it from within the kernel
+  using values_view = Kokkos::View<const value_type**,
+                                   typename Matrix::array_layout,
+                                   Morpheus::Space, Kokkos::MemoryUnmanaged>;
+
+  const index_type* offsets = A.cdiagonal_offsets().data();
+  values_view values(A.cvalues().data(), A.cvalues().nrows(),
+                     A.cvalues().ncols());
+  const index_type ndiags = A.ndiags();
+  const index_type ncols  = A.ncols();
+
+  value_type result = 0.0;
+  Kokkos::parallel_reduce(
+      "hpcg::dia_spmv_dot", policy(0, A.nrows()),
+      KOKKOS_LAMBDA(const index_type i, value_type& sum) {
+        value_type yi = init ? value_type(0) : y[i];
+        for (index_type d = 0; d < ndiags; d++) {
+          const index_type j = i + offsets[d];
+          if ((j >= 0) && (j < ncols)) {
+            yi += values(i, d) * x[j];
+          }
+        }
+        y[i] = yi;
+        sum += w[i] * yi;
+      },
+      result);
+
+  return result;
+}
+
+template <typename Matrix>
+value_type MultiplyDot_Generic(const Matrix& A, const value_type* x,
+                               const value_type* w, value_type* y,
+                               const bool init) {
+  using uvec = typename Morpheus::UnmanagedVector<value_type>;
+
+  auto xwrap = uvec(A.ncols(), const_cast<value_type*>(x));
+  auto wwrap = uvec(A.nrows(), const_cast<value_type*>(w));
+  auto ywrap = uvec(A.nrows(), y);
+
+  Morpheus::multiply<Morpheus::ExecSpace>(A, xwrap, ywrap, init);
+  Kokkos::fence();
+  return Morpheus::dot<Morpheus::ExecSpace>(A.nrows(), wwrap, ywrap);
+}
+}  // namespace
+
+value_type MorpheusMultiplyDot(const Morpheus::SparseMatrix& A,
+                               const value_type* x, const value_type* w,
+                               value_type* y, const bool init) {
+#ifdef HPCG_WITH_MORPHEUS_DYNAMIC
+  if (A.active_enum() == Morpheus::CSR_FORMAT) {
+    const typename Morpheus::Csr Acsr = A;
+    return MultiplyDot_Csr(Acsr, x, w, y, init);
+  } else if (A.active_enum() == Morpheus::DIA_FORMAT) {
+    const typename Morpheus::Dia Adia = A;
+    return MultiplyDot_Dia(Adia, x, w, y, init);
+  }
+
+  return MultiplyDot_Generic(A, x, w, y, init);
+#else
+  return MultiplyDot_Csr(A, x, w, y, init);
+#endif  // HPCG_WITH_MORPHEUS_DYNAMIC
+}
+
+#endif  // HPCG_WITH_MORPHEUS
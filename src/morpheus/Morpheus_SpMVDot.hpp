@@ -0,0 +1,45 @@
+/**
+ * Morpheus_SpMVDot.hpp
+ *
+ * EPCC, The University of Edinburgh
+ *
+ * (c) 2022 The University of Edinburgh
+ *
+ * Contributing Authors:
+ * Christodoulos Stylianou (c.stylianou@ed.ac.uk)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef HPCG_MORPHEUS_SPMVDOT_HPP
+#define HPCG_MORPHEUS_SPMVDOT_HPP
+
+#ifdef HPCG_WITH_MORPHEUS
+#include "morpheus/Morpheus_SparseMatrix.hpp"
+
+/*!
+  Computes y = A*x (or y += A*x if init is false) and returns the local
+  reduction sum_i w[i]*y[i] over the rows of A in the same pass, so that y is
+  not streamed a second time by a separate dot product.
+
+  CSR and DIA use a fused kernel. Any other active format falls back to a
+  Morpheus multiply followed by a Morpheus dot.
+*/
+Morpheus::value_type MorpheusMultiplyDot(const Morpheus::SparseMatrix& A,
+                                         const Morpheus::value_type* x,
+                                         const Morpheus::value_type* w,
+                                         Morpheus::value_type* y,
+                                         const bool init = true);
+
+#endif  // HPCG_WITH_MORPHEUS
+#endif  // HPCG_MORPHEUS_SPMVDOT_HPP
@@ -30,6 +30,7 @@
 #include "morpheus/Morpheus_Vector.hpp"
 
 namespace Morpheus {
+using Coo = Morpheus::CooMatrix<value_type, local_int_t, Space>;
 using Csr = Morpheus::CsrMatrix<value_type, local_int_t, Space>;
 using Dia = Morpheus::DiaMatrix<value_type, local_int_t, Space>;
 
@@ -47,13 +48,80 @@ struct Morpheus_Mat_STRUCT {
 
 typedef Morpheus_Mat_STRUCT Morpheus_Mat;
 
+#if defined(HPCG_WITH_HYBRID_LOCAL)
+// Local matrix partitioned by rows. Interior rows all share the full stencil
+// so they are stored by diagonals without any padding, while the boundary
+// rows are kept in CSR.
+struct Morpheus_HybridMat_STRUCT {
+  local_int_t nrows;
+  local_int_t ncols;
+
+  // Interior rows: the coefficient of column interiorRows[n] + offsets[d] is
+  // stored at interiorValues[d * ninterior + n]
+  local_int_t ndiags;
+  local_int_t center;  // position of the main diagonal in offsets
+  Morpheus_Vec<local_int_t> interiorRows;
+  Morpheus_Vec<local_int_t> offsets;
+  Morpheus_Vec<Morpheus::value_type> interiorValues;
+
+  // Boundary rows: row n of boundary is the local row boundaryRows[n]
+  struct {
+    Morpheus::Csr dev;
+    typename Morpheus::Csr::HostMirror host;
+  } boundary;
+  Morpheus_Vec<local_int_t> boundaryRows;
+
+  // Host-only data for the Gauss-Seidel sweeps. rowMap[i] is the interior
+  // index of row i, or -(n + 1) for boundary row n. boundaryDiag[n] is the
+  // position of the diagonal entry of boundary row n.
+  typename Morpheus_Vec<local_int_t>::type::HostMirror rowMap;
+  typename Morpheus_Vec<local_int_t>::type::HostMirror boundaryDiag;
+  typename Morpheus_Vec<Morpheus::value_type>::type::HostMirror rhs;
+};
+
+typedef Morpheus_HybridMat_STRUCT Morpheus_HybridMat;
+#endif  // HPCG_WITH_HYBRID_LOCAL
+
+#if defined(HPCG_WITH_BLOCK_FORMATS)
+// Local matrix split in contiguous row blocks, each stored in its own format.
+// Block b holds the local rows [blockStart[b], blockStart[b + 1]) and all the
+// columns of the local matrix.
+struct Morpheus_BlockMat_STRUCT {
+  local_int_t nrows;
+  local_int_t ncols;
+  std::vector<local_int_t> blockStart;
+  std::vector<Morpheus_Mat> blocks;
+};
+
+typedef Morpheus_BlockMat_STRUCT Morpheus_BlockMat;
+#endif  // HPCG_WITH_BLOCK_FORMATS
+
 // Optimization data to be used by SparseMatrix
 struct HPCG_Morpheus_Mat_STRUCT {
+#if defined(HPCG_WITH_HYBRID_LOCAL)
+  Morpheus_HybridMat local;
+#elif defined(HPCG_WITH_BLOCK_FORMATS)
+  Morpheus_BlockMat local;
+#else
   Morpheus_Mat local;
+#endif
 #if defined(HPCG_WITH_SPLIT_DISTRIBUTED)
+  // Ghost block stores only the rows with off-process couplings
   Morpheus_Mat ghost;
+  // Local row id of each ghost row
+  Morpheus_Vec<local_int_t> ghostRows;
+  // Compact product of the ghost block, scatter-added to the output
+  Morpheus_Vec<Morpheus::value_type> ghostProduct;
+  // Compact products for multi-vectors, grown on demand to nghost * k
+  Morpheus_Vec<Morpheus::value_type> ghostMultiProduct;
 #endif
 
+#if defined(HPCG_WITH_MORPHEUS_DIRECT_GENERATION)
+  // Rows written by MorpheusGenerateProblem, shared with the reference row
+  // pointers of the matrix
+  typename Morpheus::Csr::HostMirror generated;
+#endif  // HPCG_WITH_MORPHEUS_DIRECT_GENERATION
+
   int coarseLevel;
   local_int_t rank;
 #ifndef HPCG_NO_MPI
@@ -62,6 +130,8 @@ struct HPCG_Morpheus_Mat_STRUCT {
 
   Morpheus_Vec<local_int_t> elementsToSend;
   Morpheus_Vec<Morpheus::value_type> sendBuffer;
+  // Send buffer for multi-vectors, grown on demand to totalToBeSent * k
+  Morpheus_Vec<Morpheus::value_type> multiSendBuffer;
 #endif  // HPCG_NO_MPI
 };
 
@@ -24,6 +24,13 @@
 #include "morpheus/Morpheus_SparseMatrixRoutines.hpp"
 #include "morpheus/Morpheus_SparseMatrix.hpp"
 #include "morpheus/Morpheus_FormatSelector.hpp"
+#include "morpheus/Morpheus_HybridMatrix.hpp"
+#include "morpheus/Morpheus_BlockMatrix.hpp"
+#include "morpheus/Morpheus_NUMA.hpp"
+#include "morpheus/Morpheus_Autotune.hpp"
+#include "morpheus/Morpheus_MemoryBudget.hpp"
+#include "morpheus/Morpheus_MatrixCache.hpp"
+#include "morpheus/Morpheus_FormatPredictor.hpp"
 
 #ifdef HPCG_WITH_MORPHEUS
 
@@ -31,101 +38,207 @@
 #include <mpi.h>
 #endif
 
+#include <vector>
+
 void MorpheusInitializeSparseMatrix(SparseMatrix& A) {
+  // The direct generation path creates it together with the matrix
+  if (A.optimizationData != 0) return;
   A.optimizationData = new HPCG_Morpheus_Mat();
 }
 
-#if defined(HPCG_WITH_SPLIT_DISTRIBUTED)
-void HpcgToMorpheusMatrix(SparseMatrix& A) {
-  // Count nlocal & nexternal
-  global_int_t nlocal = 0, nexternal = 0;
-  for (local_int_t i = 0; i < A.localNumberOfRows; i++) {
-    for (local_int_t j = 0; j < A.nonzerosInRow[i]; j++) {
-      global_int_t curIndex = A.mtxIndG[i][j];
-      if (A.geom->rank == ComputeRankOfMatrixRow(*(A.geom), curIndex)) {
-        nlocal++;
-      } else {
-        nexternal++;
-      }
+// Stores the local rows in Acsr in the selected layout and sends them to the
+// device
+void BuildLocalMatrix(SparseMatrix& A,
+                      const typename Morpheus::Csr::HostMirror& Acsr) {
+  HPCG_Morpheus_Mat* Aopt = (HPCG_Morpheus_Mat*)A.optimizationData;
+
+#if defined(HPCG_WITH_HYBRID_LOCAL)
+  MorpheusHybridBuild(Acsr, Aopt->local);
+#elif defined(HPCG_WITH_BLOCK_FORMATS)
+  MorpheusBlockBuild(Acsr, GetLocalBlockFormats(A), Aopt->local);
+#else
+#ifdef HPCG_WITH_MORPHEUS_DYNAMIC
+  int fmt                  = GetLocalFormat(A);
+  format_features features = {};
+  if (predict_formats) {
+    features = MorpheusExtractFeatures(A, Acsr);
+    fmt      = MorpheusPredictFormat(features);
+  }
+
+  if (autotune_trials > 0) {
+    // The measured choice overrides the prediction, which is still recorded
+    MorpheusAutotuneLocalMatrix(A, Acsr);
+  } else {
+    // Fall back to a more compact format when the selected one exceeds the
+    // memory budget
+    const int selected = MorpheusFitMemoryBudget(Acsr, fmt);
+    if (!MorpheusLoadCachedMatrix(A, "local", selected, Acsr, Aopt->local)) {
+      Aopt->local.host = Acsr;
+      // In-place conversion w/ temporary allocation
+      Morpheus::convert<Morpheus::HostExecSpace>(Aopt->local.host, selected);
+      MorpheusStoreCachedMatrix(A, "local", Aopt->local);
     }
+    // Now send to device
+    MorpheusSendToDevice(Aopt->local);
   }
 
-  typename Morpheus::Csr::HostMirror Acsr(A.localNumberOfRows,
-                                          A.localNumberOfRows, nlocal);
-  typename Morpheus::Csr::HostMirror Acsr_ghost(
-      A.localNumberOfRows, A.localNumberOfColumns - A.localNumberOfRows,
-      nexternal);
+  if (predict_formats) MorpheusRecordPrediction(A, features, fmt);
+#else
+  Aopt->local.host = Acsr;
+  // Now send to device
+  MorpheusSendToDevice(Aopt->local);
+#endif  // HPCG_WITH_MORPHEUS_DYNAMIC
+#endif
+}
+
+namespace {
+using host_policy = Kokkos::RangePolicy<Morpheus::HostExecSpace,
+                                        Kokkos::IndexType<local_int_t>>;
+}  // namespace
+
+void MorpheusScanOffsets(local_int_t* offsets, local_int_t n) {
+  offsets[0] = 0;
+  Kokkos::parallel_scan(
+      "hpcg::scan_offsets", host_policy(0, n),
+      [=](const local_int_t i, local_int_t& update, const bool final) {
+        update += offsets[i + 1];
+        if (final) offsets[i + 1] = update;
+      });
+}
 
-  nlocal    = 0;
-  nexternal = 0;
+#if defined(HPCG_WITH_SPLIT_DISTRIBUTED)
+void HpcgToMorpheusMatrix(SparseMatrix& A) {
+  using index_mirror = typename Morpheus_Vec<local_int_t>::type::HostMirror;
+  using value_mirror =
+      typename Morpheus_Vec<Morpheus::value_type>::type::HostMirror;
+
+  const local_int_t nrows = A.localNumberOfRows;
+  // Per row: start of its local and external entries, and its ghost row id
+  std::vector<local_int_t> localStart(nrows + 1), ghostStart(nrows + 1),
+      ghostId(nrows + 1);
+
+  // First pass counts the local & external entries of every row. SetupHalo
+  // numbers the external columns after the local ones, so the column id
+  // tells them apart without looking up the owning rank.
+  Kokkos::parallel_for(
+      "hpcg::count_split_rows", host_policy(0, nrows),
+      [&](const local_int_t i) {
+        local_int_t rowLocal = 0;
+        for (local_int_t j = 0; j < A.nonzerosInRow[i]; j++) {
+          if (A.mtxIndL[i][j] < nrows) rowLocal++;
+        }
+        localStart[i + 1] = rowLocal;
+        ghostStart[i + 1] = A.nonzerosInRow[i] - rowLocal;
+        ghostId[i + 1]    = A.nonzerosInRow[i] > rowLocal ? 1 : 0;
+      });
+  Kokkos::fence();
+
+  MorpheusScanOffsets(localStart.data(), nrows);
+  MorpheusScanOffsets(ghostStart.data(), nrows);
+  MorpheusScanOffsets(ghostId.data(), nrows);
+
+  const local_int_t nghostRows = ghostId[nrows];
+  typename Morpheus::Csr::HostMirror Acsr(nrows, nrows, localStart[nrows]);
+  // Ghost block only keeps the boundary rows, so its size scales with the
+  // surface of the subdomain rather than its volume
+  typename Morpheus::Csr::HostMirror Acsr_ghost(
+      nghostRows, A.localNumberOfColumns - nrows, ghostStart[nrows]);
+  index_mirror ghostRows(nghostRows, 0);
 
   Acsr.row_offsets(0)       = 0;
   Acsr_ghost.row_offsets(0) = 0;
-  for (local_int_t i = 0; i < A.localNumberOfRows; i++) {
-    for (local_int_t j = 0; j < A.nonzerosInRow[i]; j++) {
-      global_int_t curIndex = A.mtxIndG[i][j];
-      if (A.geom->rank == ComputeRankOfMatrixRow(*(A.geom), curIndex)) {
-        Acsr.column_indices(nlocal) = A.mtxIndL[i][j];
-        Acsr.values(nlocal++)       = A.matrixValues[i][j];
-      } else {
-        Acsr_ghost.column_indices(nexternal) =
-            A.mtxIndL[i][j] - A.localNumberOfRows;
-        Acsr_ghost.values(nexternal++) = A.matrixValues[i][j];
-      }
-    }
-    Acsr.row_offsets(i + 1)       = nlocal;
-    Acsr_ghost.row_offsets(i + 1) = nexternal;
-  }
+  // Second pass fills the disjoint ranges found above, one row at a time
+  Kokkos::parallel_for(
+      "hpcg::fill_split_rows", host_policy(0, nrows),
+      [&](const local_int_t i) {
+        local_int_t nlocal = localStart[i], nexternal = ghostStart[i];
+        for (local_int_t j = 0; j < A.nonzerosInRow[i]; j++) {
+          const local_int_t col = A.mtxIndL[i][j];
+          if (col < nrows) {
+            Acsr.column_indices(nlocal) = col;
+            Acsr.values(nlocal++)       = A.matrixValues[i][j];
+          } else {
+            Acsr_ghost.column_indices(nexternal) = col - nrows;
+            Acsr_ghost.values(nexternal++)       = A.matrixValues[i][j];
+          }
+        }
+        Acsr.row_offsets(i + 1) = nlocal;
+        if (ghostId[i + 1] > ghostId[i]) {
+          ghostRows(ghostId[i])                  = i;
+          Acsr_ghost.row_offsets(ghostId[i + 1]) = nexternal;
+        }
+      });
+  Kokkos::fence();
 
   HPCG_Morpheus_Mat* Aopt = (HPCG_Morpheus_Mat*)A.optimizationData;
-  Aopt->local.host        = Acsr;
   Aopt->ghost.host        = Acsr_ghost;
+  Aopt->ghostRows.host    = ghostRows;
+  Aopt->ghostProduct.host = value_mirror(nghostRows, 0);
+
+  BuildLocalMatrix(A, Acsr);
 
 #ifdef HPCG_WITH_MORPHEUS_DYNAMIC
-  // In-place conversion w/ temporary allocation
-  Morpheus::convert<Kokkos::Serial>(Aopt->local.host, GetLocalFormat(A));
-  Morpheus::convert<Kokkos::Serial>(Aopt->ghost.host, GetGhostFormat(A));
+  const int ghost_fmt = MorpheusFitMemoryBudget(Acsr_ghost, GetGhostFormat(A));
+  if (!MorpheusLoadCachedMatrix(A, "ghost", ghost_fmt, Acsr_ghost,
+                                Aopt->ghost)) {
+    // In-place conversion w/ temporary allocation
+    Morpheus::convert<Morpheus::HostExecSpace>(Aopt->ghost.host, ghost_fmt);
+    MorpheusStoreCachedMatrix(A, "ghost", Aopt->ghost);
+  }
 #endif
   // Now send to device
-  Aopt->local.dev =
-      Morpheus::create_mirror_container<Morpheus::Space>(Aopt->local.host);
-  Morpheus::copy(Aopt->local.host, Aopt->local.dev);
-  Aopt->ghost.dev =
-      Morpheus::create_mirror_container<Morpheus::Space>(Aopt->ghost.host);
-  Morpheus::copy(Aopt->ghost.host, Aopt->ghost.dev);
+  MorpheusSendToDevice(Aopt->ghost);
+  MorpheusSendToDevice(Aopt->ghostRows);
+  Aopt->ghostProduct.dev = Morpheus::create_mirror_container<Morpheus::Space>(
+      Aopt->ghostProduct.host);
 }
-#else
+#elif defined(HPCG_WITH_MORPHEUS_DIRECT_GENERATION)
 void HpcgToMorpheusMatrix(SparseMatrix& A) {
-  typename Morpheus::Csr::HostMirror Acsr(
-      A.localNumberOfRows, A.localNumberOfColumns, A.localNumberOfNonzeros);
-
-  Acsr.row_offsets(0) = 0;
-  global_int_t k      = 0;
-
-  for (local_int_t i = 0; i < A.localNumberOfRows; i++) {
-    for (local_int_t j = 0; j < A.nonzerosInRow[i]; j++) {
-      Acsr.column_indices(k) = A.mtxIndL[i][j];
-      Acsr.values(k++)       = A.matrixValues[i][j];
-    }
-    Acsr.row_offsets(i + 1) = Acsr.row_offsets(i) + A.nonzerosInRow[i];
-  }
-
   HPCG_Morpheus_Mat* Aopt = (HPCG_Morpheus_Mat*)A.optimizationData;
-  Aopt->local.host        = Acsr;
+  auto& rows              = Aopt->generated;
 
-#ifdef HPCG_WITH_MORPHEUS_DYNAMIC
-  // In-place conversion w/ temporary allocation
-  Morpheus::convert<Kokkos::Serial>(Aopt->local.host, GetLocalFormat(A));
-#endif
-  // Now send to device
-  Aopt->local.dev =
-      Morpheus::create_mirror_container<Morpheus::Space>(Aopt->local.host);
-  Morpheus::copy(Aopt->local.host, Aopt->local.dev);
+  // SetupHalo already wrote the local column ids into the generated rows,
+  // only the number of columns has grown with the external ones
+  typename Morpheus::Csr::HostMirror Acsr(
+      A.localNumberOfRows, A.localNumberOfColumns, A.localNumberOfNonzeros,
+      rows.row_offsets(), rows.column_indices(), rows.values());
+
+  BuildLocalMatrix(A, Acsr);
+}
+#else
+void HpcgToMorpheusMatrix(SparseMatrix& A) {
+  const local_int_t nrows = A.localNumberOfRows;
+  typename Morpheus::Csr::HostMirror Acsr(nrows, A.localNumberOfColumns,
+                                          A.localNumberOfNonzeros);
+  local_int_t* offsets = Acsr.row_offsets().data();
+
+  // Row offsets from a scan of the row lengths, so that every row can then
+  // be filled independently
+  Kokkos::parallel_for(
+      "hpcg::count_rows", host_policy(0, nrows),
+      [&](const local_int_t i) { offsets[i + 1] = A.nonzerosInRow[i]; });
+  Kokkos::fence();
+  MorpheusScanOffsets(offsets, nrows);
+
+  Kokkos::parallel_for(
+      "hpcg::fill_rows", host_policy(0, nrows), [&](const local_int_t i) {
+        local_int_t k = offsets[i];
+        for (local_int_t j = 0; j < A.nonzerosInRow[i]; j++) {
+          Acsr.column_indices(k) = A.mtxIndL[i][j];
+          Acsr.values(k++)       = A.matrixValues[i][j];
+        }
+      });
+  Kokkos::fence();
+
+  BuildLocalMatrix(A, Acsr);
 }
 #endif
 
 void MorpheusOptimizeSparseMatrix(SparseMatrix& A) {
   HpcgToMorpheusMatrix(A);
+#ifdef HPCG_WITH_MORPHEUS_DYNAMIC
+  MorpheusChargeMemoryBudget(A);
+#endif  // HPCG_WITH_MORPHEUS_DYNAMIC
 #ifndef HPCG_NO_MPI
   using index_mirror = typename HPCG_Morpheus_Mat::IndexVector::HostMirror;
   using value_mirror = typename HPCG_Morpheus_Mat::ValueVector::HostMirror;
@@ -148,16 +261,34 @@ void MorpheusOptimizeSparseMatrix(SparseMatrix& A) {
 #endif  // HPCG_NO_MPI
 }
 
+void MorpheusCopyMatrixDiagonal(SparseMatrix& A, Vector& diagonal) {
+#if defined(HPCG_WITH_HYBRID_LOCAL)
+  // The reference rows may have been released by the lean mode
+  HPCG_Morpheus_Mat* Aopt = (HPCG_Morpheus_Mat*)A.optimizationData;
+  MorpheusHybridCopyDiagonal(Aopt->local, diagonal.values);
+#else
+  // The other layouts keep the reference rows for ComputeSYMGS_ref
+  CopyMatrixDiagonal(A, diagonal);
+#endif
+}
+
 void MorpheusReplaceMatrixDiagonal(SparseMatrix& A, Vector& diagonal) {
+  HPCG_Morpheus_Mat* Aopt = (HPCG_Morpheus_Mat*)A.optimizationData;
+
+#if defined(HPCG_WITH_HYBRID_LOCAL)
+  MorpheusHybridUpdateDiagonal(Aopt->local, diagonal.values);
+#elif defined(HPCG_WITH_BLOCK_FORMATS)
+  MorpheusBlockUpdateDiagonal(Aopt->local, diagonal.values);
+#else
   using mirror =
       typename Morpheus::UnmanagedVector<Morpheus::value_type>::HostMirror;
-  HPCG_Morpheus_Mat* Aopt = (HPCG_Morpheus_Mat*)A.optimizationData;
 
   mirror diag(diagonal.localLength, diagonal.values);
   auto diag_dev = Morpheus::create_mirror_container<Morpheus::Space>(diag);
 
   Morpheus::copy(diag, diag_dev);
   Morpheus::update_diagonal<Morpheus::ExecSpace>(Aopt->local.dev, diag_dev);
+#endif
 }
 
 void MorpheusSparseMatrixSetCoarseLevel(SparseMatrix& A, int level) {
@@ -180,6 +311,7 @@ int MorpheusSparseMatrixGetRank(const SparseMatrix& A) {
   return Aopt->rank;
 }
 
+// Bytes held by the containers of A, including any padding of the format
 template <typename MorpheusMatrix>
 double count_memory(const MorpheusMatrix& A) {
   double memory     = 0;
@@ -188,30 +320,152 @@ double count_memory(const MorpheusMatrix& A) {
 
 #ifdef HPCG_WITH_MORPHEUS_DYNAMIC
   if (A.active_enum() == Morpheus::COO_FORMAT) {
-    memory += 2 * A.nnnz() * index_size;  // row_indices & column_indices
-    memory += A.nnnz() * value_size;      // values
+    typename Morpheus::Coo Acoo = A;
+    memory += Acoo.row_indices().size() * index_size;
+    memory += Acoo.column_indices().size() * index_size;
+    memory += Acoo.values().size() * value_size;
   } else if (A.active_enum() == Morpheus::CSR_FORMAT) {
-    memory += (A.nrows() + 1) * index_size;  // row_offsets
-    memory += A.nnnz() * index_size;         // column_indices
-    memory += A.nnnz() * value_size;         // values
-    // values
+    typename Morpheus::Csr Acsr = A;
+    memory += Acsr.row_offsets().size() * index_size;
+    memory += Acsr.column_indices().size() * index_size;
+    memory += Acsr.values().size() * value_size;
   } else if (A.active_enum() == Morpheus::DIA_FORMAT) {
     typename Morpheus::Dia Adia = A;
-    memory += Adia.ndiags() * index_size;  // diagonal_offsets
-    memory +=
-        ((double)Adia.nrows() * (double)Adia.ncols()) * value_size;  // values
+    memory += Adia.diagonal_offsets().size() * index_size;
+    // One padded row per diagonal, not one value per column
+    memory += (double)Adia.values().nrows() * (double)Adia.values().ncols() *
+              value_size;
   } else {
     throw Morpheus::RuntimeException("Selected invalid format.");
   }
 #else
-  memory += (A.nrows() + 1) * index_size;  // row_offsets
-  memory += A.nnnz() * index_size;         // column_indices
-  memory += A.nnnz() * value_size;         // values
+  MorpheusMatrix Acsr = A;
+  memory += Acsr.row_offsets().size() * index_size;
+  memory += Acsr.column_indices().size() * index_size;
+  memory += Acsr.values().size() * value_size;
 #endif  // HPCG_WITH_MORPHEUS_DYNAMIC
 
   return memory;
 }
 
+#if defined(HPCG_WITH_HYBRID_LOCAL)
+format_report MorpheusSparseMatrixGetLocalProperties(const SparseMatrix& A) {
+  HPCG_Morpheus_Mat* Aopt = (HPCG_Morpheus_Mat*)A.optimizationData;
+
+  format_report interior = MorpheusSparseMatrixGetInteriorProperties(A);
+  format_report boundary = MorpheusSparseMatrixGetBoundaryProperties(A);
+  format_report entry;
+
+  entry.id.rank     = MorpheusSparseMatrixGetRank(A);
+  entry.id.mg_level = MorpheusSparseMatrixGetCoarseLevel(A);
+  entry.id.format   = HPCG_HYBRID_FORMAT;
+
+  entry.nrows = Aopt->local.nrows;
+  entry.ncols = Aopt->local.ncols;
+  entry.nnnz  = interior.nnnz + boundary.nnnz;
+
+  // Both parts plus the row map used by the sweeps
+  entry.memory = interior.memory + boundary.memory +
+                 (double)Aopt->local.nrows * sizeof(Morpheus::index_type);
+
+  return entry;
+}
+
+format_report MorpheusSparseMatrixGetInteriorProperties(
+    const SparseMatrix& A) {
+  HPCG_Morpheus_Mat* Aopt = (HPCG_Morpheus_Mat*)A.optimizationData;
+
+  format_report entry;
+
+  entry.id.rank     = MorpheusSparseMatrixGetRank(A);
+  entry.id.mg_level = MorpheusSparseMatrixGetCoarseLevel(A);
+  entry.id.format   = Morpheus::DIA_FORMAT;
+
+  entry.nrows = Aopt->local.interiorRows.dev.size();
+  entry.ncols = Aopt->local.ncols;
+  entry.nnnz  = (global_int_t)entry.nrows * Aopt->local.ndiags;
+
+  entry.memory = MorpheusHybridInteriorMemory(Aopt->local);
+
+  return entry;
+}
+
+format_report MorpheusSparseMatrixGetBoundaryProperties(
+    const SparseMatrix& A) {
+  HPCG_Morpheus_Mat* Aopt = (HPCG_Morpheus_Mat*)A.optimizationData;
+
+  format_report entry;
+
+  entry.id.rank     = MorpheusSparseMatrixGetRank(A);
+  entry.id.mg_level = MorpheusSparseMatrixGetCoarseLevel(A);
+  entry.id.format   = Morpheus::CSR_FORMAT;
+
+  entry.nrows = Aopt->local.boundaryRows.dev.size();
+  entry.ncols = Aopt->local.ncols;
+  entry.nnnz  = Aopt->local.boundary.dev.nnnz();
+
+  entry.memory = MorpheusHybridBoundaryMemory(Aopt->local);
+
+  return entry;
+}
+#elif defined(HPCG_WITH_BLOCK_FORMATS)
+int MorpheusSparseMatrixGetNumberOfBlocks(const SparseMatrix& A) {
+  HPCG_Morpheus_Mat* Aopt = (HPCG_Morpheus_Mat*)A.optimizationData;
+  return Aopt->local.blocks.size();
+}
+
+format_report MorpheusSparseMatrixGetBlockProperties(const SparseMatrix& A,
+                                                     int block) {
+  HPCG_Morpheus_Mat* Aopt = (HPCG_Morpheus_Mat*)A.optimizationData;
+  auto Ablock             = Aopt->local.blocks[block].dev;
+
+  format_report entry;
+
+  entry.id.rank     = MorpheusSparseMatrixGetRank(A);
+  entry.id.mg_level = MorpheusSparseMatrixGetCoarseLevel(A);
+  entry.id.format   = Ablock.active_index();
+
+  entry.nrows = Ablock.nrows();
+  entry.ncols = Ablock.ncols();
+  entry.nnnz  = Ablock.nnnz();
+
+  entry.memory = count_memory(Ablock);
+
+  return entry;
+}
+
+format_report MorpheusSparseMatrixGetLocalProperties(const SparseMatrix& A) {
+  HPCG_Morpheus_Mat* Aopt = (HPCG_Morpheus_Mat*)A.optimizationData;
+  const int nblocks       = MorpheusSparseMatrixGetNumberOfBlocks(A);
+
+  format_report entry;
+
+  entry.id.rank     = MorpheusSparseMatrixGetRank(A);
+  entry.id.mg_level = MorpheusSparseMatrixGetCoarseLevel(A);
+  entry.id.format   = HPCG_BLOCK_FORMAT;
+
+  entry.nrows  = Aopt->local.nrows;
+  entry.ncols  = Aopt->local.ncols;
+  entry.nnnz   = 0;
+  entry.memory = 0;
+
+  for (int b = 0; b < nblocks; b++) {
+    format_report block = MorpheusSparseMatrixGetBlockProperties(A, b);
+    // Report the format of the blocks when they all agree
+    if (b == 0) {
+      entry.id.format = block.id.format;
+    } else if (entry.id.format != block.id.format) {
+      entry.id.format = HPCG_BLOCK_FORMAT;
+    }
+    entry.nnnz += block.nnnz;
+    entry.memory += block.memory;
+  }
+  // First row of each block
+  entry.memory += (double)(nblocks + 1) * sizeof(Morpheus::index_type);
+
+  return entry;
+}
+#else
 format_report MorpheusSparseMatrixGetLocalProperties(const SparseMatrix& A) {
   HPCG_Morpheus_Mat* Aopt = (HPCG_Morpheus_Mat*)A.optimizationData;
 
@@ -229,6 +483,7 @@ format_report MorpheusSparseMatrixGetLocalProperties(const SparseMatrix& A) {
 
   return entry;
 }
+#endif
 #if defined(HPCG_WITH_SPLIT_DISTRIBUTED)
 format_report MorpheusSparseMatrixGetGhostProperties(const SparseMatrix& A) {
   HPCG_Morpheus_Mat* Aopt = (HPCG_Morpheus_Mat*)A.optimizationData;
@@ -244,6 +499,9 @@ format_report MorpheusSparseMatrixGetGhostProperties(const SparseMatrix& A) {
   entry.nnnz  = Aopt->ghost.dev.nnnz();
 
   entry.memory = count_memory(Aopt->ghost.dev);
+  // Row ids and compact product used to scatter the ghost rows
+  entry.memory += (double)Aopt->ghostRows.dev.size() *
+                  (sizeof(local_int_t) + sizeof(Morpheus::value_type));
 
   return entry;
 }
@@ -31,7 +31,10 @@
 
 void MorpheusInitializeSparseMatrix(SparseMatrix& A);
 void MorpheusOptimizeSparseMatrix(SparseMatrix& A);
+void MorpheusCopyMatrixDiagonal(SparseMatrix& A, Vector& diagonal);
 void MorpheusReplaceMatrixDiagonal(SparseMatrix& A, Vector& diagonal);
+// Turns the counts in offsets[1..n] into offsets, with offsets[0] = 0
+void MorpheusScanOffsets(local_int_t* offsets, local_int_t n);
 
 void MorpheusSparseMatrixSetCoarseLevel(SparseMatrix& A, int level);
 void MorpheusSparseMatrixSetRank(SparseMatrix& A);
@@ -39,6 +42,14 @@ int MorpheusSparseMatrixGetCoarseLevel(const SparseMatrix& A);
 int MorpheusSparseMatrixGetRank(const SparseMatrix& A);
 
 format_report MorpheusSparseMatrixGetLocalProperties(const SparseMatrix& A);
+#if defined(HPCG_WITH_HYBRID_LOCAL)
+format_report MorpheusSparseMatrixGetInteriorProperties(const SparseMatrix& A);
+format_report MorpheusSparseMatrixGetBoundaryProperties(const SparseMatrix& A);
+#elif defined(HPCG_WITH_BLOCK_FORMATS)
+int MorpheusSparseMatrixGetNumberOfBlocks(const SparseMatrix& A);
+format_report MorpheusSparseMatrixGetBlockProperties(const SparseMatrix& A,
+                                                     int block);
+#endif
 #if defined(HPCG_WITH_SPLIT_DISTRIBUTED)
 format_report MorpheusSparseMatrixGetGhostProperties(const SparseMatrix& A);
 #endif  // HPCG_WITH_SPLIT_DISTRIBUTED
@@ -37,6 +37,7 @@ typedef struct morpheus_timers {
   double HALO_SWAP;
   double CG;
   double SPMV_LOCAL, SPMV_GHOST;
+  double SPMV_CALLS;  // number of calls timed in SPMV_LOCAL
 
   morpheus_timers()
       : SPMV(0),
@@ -45,7 +46,8 @@ typedef struct morpheus_timers {
         HALO_SWAP(0),
         CG(0),
         SPMV_LOCAL(0),
-        SPMV_GHOST(0) {}
+        SPMV_GHOST(0),
+        SPMV_CALLS(0) {}
 
 } morpheus_timers;
 
@@ -23,6 +23,7 @@
 
 #include "morpheus/Morpheus_VectorRoutines.hpp"
 #include "morpheus/Morpheus_Vector.hpp"
+#include "morpheus/Morpheus_NUMA.hpp"
 
 #ifdef HPCG_WITH_MORPHEUS
 
@@ -36,6 +37,9 @@ void MorpheusOptimizeVector(Vector& v) {
   using Vector_t = HPCG_Morpheus_Vec<Morpheus::value_type>;
   Vector_t* vopt = (Vector_t*)v.optimizationData;
 
+#if defined(HPCG_WITH_NUMA_FIRST_TOUCH)
+  MorpheusFirstTouch(v.values, v.localLength);
+#endif
   // Wrap host data around original hpcg vector data
   vopt->values.host = mirror(v.localLength, v.values);
   // Now send to device
@@ -50,4 +54,31 @@ void MorpheusZeroVector(Vector& v) {
   vopt->values.dev.assign(vopt->values.dev.size(), 0);  // Zero out x on device
 }
 
+void MorpheusInitializeMultiVector(MultiVector& V) {
+  V.optimizationData = new HPCG_Morpheus_Vec<Morpheus::value_type>();
+}
+
+void MorpheusOptimizeMultiVector(MultiVector& V) {
+  using mirror =
+      typename Morpheus::UnmanagedVector<Morpheus::value_type>::HostMirror;
+  using Vector_t = HPCG_Morpheus_Vec<Morpheus::value_type>;
+  Vector_t* Vopt = (Vector_t*)V.optimizationData;
+
+#if defined(HPCG_WITH_NUMA_FIRST_TOUCH)
+  MorpheusFirstTouch(V.values, V.localLength * V.numberOfVectors);
+#endif
+  // Wrap host data around original interleaved multi-vector data
+  Vopt->values.host = mirror(V.localLength * V.numberOfVectors, V.values);
+  // Now send to device
+  Vopt->values.dev =
+      Morpheus::create_mirror_container<Morpheus::Space>(Vopt->values.host);
+  Morpheus::copy(Vopt->values.host, Vopt->values.dev);
+}
+
+void MorpheusZeroMultiVector(MultiVector& V) {
+  using Vector_t = HPCG_Morpheus_Vec<Morpheus::value_type>;
+  Vector_t* Vopt = (Vector_t*)V.optimizationData;
+  Vopt->values.dev.assign(Vopt->values.dev.size(), 0);  // Zero out on device
+}
+
 #endif  // HPCG_WITH_MORPHEUS
\ No newline at end of file
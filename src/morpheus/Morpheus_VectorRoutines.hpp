@@ -26,10 +26,15 @@
 
 #ifdef HPCG_WITH_MORPHEUS
 #include "Vector.hpp"
+#include "MultiVector.hpp"
 
 void MorpheusInitializeVector(Vector& v);
 void MorpheusOptimizeVector(Vector& v);
 void MorpheusZeroVector(Vector& v);
 
+void MorpheusInitializeMultiVector(MultiVector& V);
+void MorpheusOptimizeMultiVector(MultiVector& V);
+void MorpheusZeroMultiVector(MultiVector& V);
+
 #endif  // HPCG_WITH_MORPHEUS
 #endif  // HPCG_MORPHEUS_VECTOR_ROUTINES_HPP